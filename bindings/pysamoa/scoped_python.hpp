@@ -64,6 +64,27 @@ public:
     }
 };
 
+// drops a held python object under the GIL (see hold_python_object())
+inline void release_python_object(boost::python::object * obj)
+{
+    python_scoped_lock block;
+    delete obj;
+}
+
+typedef boost::shared_ptr<boost::python::object> python_object_ptr_t;
+
+/*!
+ * Holds a python object for binding into native handlers. Handlers
+ *  may be released by threads not holding the GIL; the object's
+ *  reference is dropped under the GIL when the last holder is.
+ */
+inline python_object_ptr_t hold_python_object(
+    const boost::python::object & obj)
+{
+    return python_object_ptr_t(
+        new boost::python::object(obj), &release_python_object);
+}
+
 } // end pysamoa
 
 #endif
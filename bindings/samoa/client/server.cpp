@@ -129,6 +129,26 @@ bpl::list py_get_response_data_blocks(const server::response_interface & iface)
     return out;
 }
 
+bpl::object py_get_latency_quantile(server & s, double q)
+{
+    unsigned latency_us;
+
+    if(!s.get_latency_quantile(q, latency_us))
+        return bpl::object();
+
+    return bpl::object(latency_us);
+}
+
+bpl::object py_get_latency_ewma(server & s)
+{
+    unsigned latency_us;
+
+    if(!s.get_latency_ewma(latency_us))
+        return bpl::object();
+
+    return bpl::object(latency_us);
+}
+
 ////////////
 
 void make_server_bindings()
@@ -153,6 +173,10 @@ void make_server_bindings()
         .def("connect_to", &py_connect_to)
         .staticmethod("connect_to")
         .def("schedule_request", &py_schedule_request)
+        .def("get_peer_protocol_version", &server::get_peer_protocol_version)
+        .def("get_latency_quantile", &py_get_latency_quantile)
+        .def("get_latency_ewma", &py_get_latency_ewma)
+        .def("get_queue_size", &server::get_queue_size)
         ;
 }
 
@@ -3,6 +3,7 @@
 #include "samoa/client/server_pool.hpp"
 #include "pysamoa/future.hpp"
 #include "pysamoa/scoped_python.hpp"
+#include <boost/python/stl_iterator.hpp>
 #include <boost/smart_ptr/make_shared.hpp>
 
 namespace samoa {
@@ -23,8 +24,27 @@ future::ptr_t py_schedule_request(server_pool & s, const core::uuid & uuid)
     return f;
 }
 
+core::uuid py_select_server(server_pool & s, const bpl::object & candidates)
+{
+    std::vector<core::uuid> uuids;
+
+    bpl::stl_input_iterator<core::uuid> it(candidates), end;
+    for(; it != end; ++it)
+    {
+        uuids.push_back(*it);
+    }
+    return s.select_server(uuids);
+}
+
 void make_server_pool_bindings()
 {
+    bpl::class_<server_pool::server_stats>("ServerStats", bpl::no_init)
+        .def_readonly("connected", &server_pool::server_stats::connected)
+        .def_readonly("queue_size", &server_pool::server_stats::queue_size)
+        .def_readonly("latency_us", &server_pool::server_stats::latency_us)
+        .def_readonly("has_latency", &server_pool::server_stats::has_latency)
+        ;
+
     bpl::class_<server_pool, server_pool::ptr_t, boost::noncopyable>(
         "ServerPool", bpl::init<>())
         .def("set_server_address", &server_pool::set_server_address)
@@ -32,6 +52,9 @@ void make_server_pool_bindings()
         .def("schedule_request", &py_schedule_request)
         .def("has_server", &server_pool::has_server)
         .def("get_server", &server_pool::get_server)
+        .def("get_server_stats", &server_pool::get_server_stats)
+        .def("get_server_load", &server_pool::get_server_load)
+        .def("select_server", &py_select_server)
         .def("get_server_hostname", &server_pool::get_server_hostname)
         .def("get_server_port", &server_pool::get_server_port)
         .def("close", &server_pool::close);
@@ -11,6 +11,12 @@ namespace core {
     void make_server_time_bindings();
     void make_tasklet_bindings();
     void make_tasklet_group_bindings();
+    void make_buffer_pool_bindings();
+    void make_work_stealing_executor_bindings();
+    void make_timer_wheel_bindings();
+    void make_mpsc_queue_bindings();
+    void make_adaptive_lock_bindings();
+    void make_arena_bindings();
 };
 };
 
@@ -22,5 +28,11 @@ BOOST_PYTHON_MODULE(_core)
     samoa::core::make_server_time_bindings();
     samoa::core::make_tasklet_bindings();
     samoa::core::make_tasklet_group_bindings();
+    samoa::core::make_buffer_pool_bindings();
+    samoa::core::make_work_stealing_executor_bindings();
+    samoa::core::make_timer_wheel_bindings();
+    samoa::core::make_mpsc_queue_bindings();
+    samoa::core::make_adaptive_lock_bindings();
+    samoa::core::make_arena_bindings();
 }
 
@@ -0,0 +1,90 @@
+#include <boost/python.hpp>
+#include "samoa/adaptive_lock.hpp"
+#include "pysamoa/scoped_python.hpp"
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+namespace samoa {
+namespace core {
+
+namespace bpl = boost::python;
+
+//////////////////////////////////////////////////////////
+// adaptive_lock_stress() support
+
+struct contended_counter
+{
+    contended_counter()
+     : count(0), holders(0), overlaps(0)
+    { }
+
+    adaptive_lock lock;
+
+    // guarded by lock
+    unsigned count;
+
+    // updated atomically, to observe overlapping holders
+    unsigned holders;
+    unsigned overlaps;
+};
+
+void on_adaptive_lock_contend(contended_counter & counter,
+    unsigned acquire_count, unsigned yield_interval)
+{
+    for(unsigned i = 0; i != acquire_count; ++i)
+    {
+        adaptive_lock::guard guard(counter.lock);
+
+        if(__sync_add_and_fetch(&counter.holders, 1) != 1)
+            __sync_fetch_and_add(&counter.overlaps, 1);
+
+        // a non-atomic read-modify-write, which loses
+        //  updates if holders aren't excluded
+        unsigned count = counter.count;
+
+        if(yield_interval && i % yield_interval == 0)
+        {
+            // hold the lock beyond the spin, so that waiters park
+            boost::this_thread::yield();
+        }
+        counter.count = count + 1;
+
+        __sync_fetch_and_sub(&counter.holders, 1);
+    }
+}
+
+/*!
+ * Increments a counter under an adaptive_lock from each of
+ *  thread_count native threads. Every yield_interval'th holder
+ *  yields its time-slice while holding the lock.
+ *
+ * Returns (final count, count of holders which overlapped).
+ */
+bpl::tuple py_adaptive_lock_stress(unsigned thread_count,
+    unsigned acquire_count, unsigned yield_interval)
+{
+    contended_counter counter;
+    {
+        // release GIL while native threads run
+        pysamoa::python_scoped_unlock unlock;
+
+        boost::thread_group threads;
+
+        for(unsigned i = 0; i != thread_count; ++i)
+        {
+            threads.create_thread(boost::bind(&on_adaptive_lock_contend,
+                boost::ref(counter), acquire_count, yield_interval));
+        }
+        threads.join_all();
+    }
+    return bpl::make_tuple(counter.count, counter.overlaps);
+}
+
+void make_adaptive_lock_bindings()
+{
+    bpl::def("adaptive_lock_stress", &py_adaptive_lock_stress);
+}
+
+}
+}
+
@@ -0,0 +1,42 @@
+#include <boost/python.hpp>
+#include "samoa/core/arena.hpp"
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+
+namespace samoa {
+namespace core {
+
+namespace bpl = boost::python;
+
+//////////////////////////////////////////////////////////
+// arena.allocate() / deallocate() support
+//
+// allocations are passed as addresses, for identity & alignment
+//  comparisons; python never accesses arena memory
+
+uintptr_t py_allocate(arena & a, size_t size)
+{
+    return reinterpret_cast<uintptr_t>(a.allocate(size));
+}
+
+void py_deallocate(arena & a, uintptr_t address, size_t size)
+{
+    a.deallocate(reinterpret_cast<void*>(address), size);
+}
+
+void make_arena_bindings()
+{
+    bpl::class_<arena, boost::shared_ptr<arena>, boost::noncopyable>(
+            "Arena", bpl::init<>())
+        .def("allocate", &py_allocate)
+        .def("deallocate", &py_deallocate)
+        .def("release", &arena::release)
+        .def("get_block_count", &arena::get_block_count)
+        .setattr("inline_size", unsigned(arena::inline_size))
+        .setattr("alignment", unsigned(arena::alignment))
+        ;
+}
+
+}
+}
+
@@ -0,0 +1,78 @@
+#include <boost/python.hpp>
+#include "samoa/core/buffer_pool.hpp"
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+
+namespace samoa {
+namespace core {
+
+namespace bpl = boost::python;
+
+/*!
+ * Python handle of a block allocated from buffer_pool,
+ *  released explicitly or on destruction
+ */
+class pooled_block :
+    private boost::noncopyable
+{
+public:
+
+    pooled_block(unsigned size_class, size_t allocation_size)
+     : _size_class(size_class),
+       _block(buffer_pool::allocate(size_class, allocation_size))
+    { }
+
+    ~pooled_block()
+    { release(); }
+
+    unsigned get_size_class() const
+    { return _size_class; }
+
+    //! Address of the block, for identity comparisons
+    uintptr_t get_address() const
+    { return reinterpret_cast<uintptr_t>(_block); }
+
+    void release()
+    {
+        if(_block)
+            buffer_pool::release(_block, _size_class);
+
+        _block = 0;
+    }
+
+private:
+
+    const unsigned _size_class;
+    void * _block;
+};
+
+void make_buffer_pool_bindings()
+{
+    bpl::class_<buffer_pool>("BufferPool", bpl::no_init)
+        .def("size_class_of", &buffer_pool::size_class_of)
+        .staticmethod("size_class_of")
+        .def("class_size", &buffer_pool::class_size)
+        .staticmethod("class_size")
+        .def("allocation_count", &buffer_pool::allocation_count)
+        .staticmethod("allocation_count")
+        .def("heap_allocation_count", &buffer_pool::heap_allocation_count)
+        .staticmethod("heap_allocation_count")
+        .def("reclaimed_size", &buffer_pool::reclaimed_size)
+        .staticmethod("reclaimed_size")
+        .setattr("class_count", unsigned(buffer_pool::class_count))
+        .setattr("no_class", unsigned(buffer_pool::no_class))
+        ;
+
+    bpl::class_<pooled_block, boost::shared_ptr<pooled_block>,
+            boost::noncopyable>("PooledBlock",
+            bpl::init<unsigned, size_t>())
+        .def("get_size_class", &pooled_block::get_size_class)
+        .def("get_address", &pooled_block::get_address)
+        .def("release", &pooled_block::release)
+        ;
+}
+
+}
+}
+
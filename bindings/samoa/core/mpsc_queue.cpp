@@ -0,0 +1,95 @@
+#include <boost/python.hpp>
+#include "samoa/core/mpsc_queue.hpp"
+#include "pysamoa/scoped_python.hpp"
+#include <boost/detail/atomic_count.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+
+namespace samoa {
+namespace core {
+
+namespace bpl = boost::python;
+
+// producer index, and sequence number within the producer
+typedef std::pair<unsigned, unsigned> sequenced_t;
+
+//////////////////////////////////////////////////////////
+// mpsc_queue_stress() support
+
+void on_mpsc_produce(mpsc_queue<sequenced_t> & queue,
+    boost::detail::atomic_count & finished_count,
+    unsigned producer, unsigned push_count)
+{
+    for(unsigned i = 0; i != push_count; ++i)
+    {
+        queue.push(sequenced_t(producer, i));
+    }
+    // increment is a full barrier, publishing all pushes
+    ++finished_count;
+}
+
+/*!
+ * Pushes push_count sequenced values from each of producer_count
+ *  native threads, while the calling thread consumes. Returns
+ *  (producer, sequence) tuples in the order they were popped.
+ */
+bpl::list py_mpsc_queue_stress(unsigned producer_count,
+    unsigned push_count)
+{
+    mpsc_queue<sequenced_t> queue;
+    std::vector<sequenced_t> popped;
+    {
+        // release GIL while native threads run
+        pysamoa::python_scoped_unlock unlock;
+
+        boost::detail::atomic_count finished_count(0);
+        boost::thread_group producers;
+
+        for(unsigned i = 0; i != producer_count; ++i)
+        {
+            producers.create_thread(boost::bind(&on_mpsc_produce,
+                boost::ref(queue), boost::ref(finished_count),
+                i, push_count));
+        }
+
+        popped.reserve(producer_count * push_count);
+        sequenced_t value;
+
+        while(true)
+        {
+            if(queue.try_pop(value))
+            {
+                popped.push_back(value);
+            }
+            else if(size_t(finished_count) == producer_count)
+            {
+                // try_pop() fails spuriously only during a
+                //  concurrent push; a failure now means empty
+                if(!queue.try_pop(value))
+                    break;
+
+                popped.push_back(value);
+            }
+            else
+                boost::this_thread::yield();
+        }
+        producers.join_all();
+    }
+
+    bpl::list result;
+    for(auto it = popped.begin(); it != popped.end(); ++it)
+    {
+        result.append(bpl::make_tuple(it->first, it->second));
+    }
+    return result;
+}
+
+void make_mpsc_queue_bindings()
+{
+    bpl::def("mpsc_queue_stress", &py_mpsc_queue_stress);
+}
+
+}
+}
+
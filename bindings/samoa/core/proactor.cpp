@@ -1,6 +1,7 @@
 #include <boost/python.hpp>
 #include "samoa/core/fwd.hpp"
 #include "samoa/core/proactor.hpp"
+#include "samoa/core/work_stealing_executor.hpp"
 #include "pysamoa/scoped_python.hpp"
 #include "pysamoa/coroutine.hpp"
 #include "pysamoa/future.hpp"
@@ -160,6 +161,88 @@ void py_run_test(proactor & p, bpl::object test_steps, unsigned idle_timeout_ms)
 }
 
 
+//////////////////////////////////////////////////////////
+// proactor.get_serial_io_services() support
+
+bpl::list py_get_serial_io_services(proactor & p)
+{
+    std::vector<io_service_ptr_t> io_services = p.get_serial_io_services();
+
+    bpl::list result;
+    for(auto it = io_services.begin(); it != io_services.end(); ++it)
+    {
+        result.append(*it);
+    }
+    return result;
+}
+
+//////////////////////////////////////////////////////////
+// proactor.run_concurrent_executor() support
+
+void py_run_concurrent_executor(proactor & p)
+{
+    // release GIL; the worker runs until shutdown()
+    pysamoa::python_scoped_unlock unlock;
+
+    p.run_concurrent_executor();
+}
+
+//////////////////////////////////////////////////////////
+// proactor.start_concurrent_executor() support
+
+void on_py_concurrent_executor_worker(
+    const work_stealing_executor::ptr_t & executor)
+{
+    // create & aquire a python thread-state for this native thread
+    PyGILState_STATE gil_state = PyGILState_Ensure();
+    {
+        // release GIL; handlers re-aquire it via python_scoped_lock
+        pysamoa::python_scoped_unlock unlock;
+
+        while(true)
+        {
+            try
+            {
+                executor->run();
+                break;
+            }
+            catch(bpl::error_already_set &)
+            {
+                // a python handler raised; report it, and keep
+                //  this worker running rather than terminating
+                pysamoa::python_scoped_lock block;
+                PyErr_Print();
+            }
+        }
+    }
+    PyGILState_Release(gil_state);
+}
+
+void py_start_concurrent_executor(proactor & p, unsigned worker_count)
+{
+    work_stealing_executor::ptr_t executor = p.concurrent_executor();
+
+    if(executor->get_worker_count() >= worker_count)
+        return;
+
+    // workers call into python from native threads
+    PyEval_InitThreads();
+
+    for(size_t i = executor->get_worker_count(); i != worker_count; ++i)
+    {
+        // workers hold only the executor, and exit on its stop()
+        boost::thread(boost::bind(
+            &on_py_concurrent_executor_worker, executor)).detach();
+    }
+
+    // release GIL while workers register, so callers may
+    //  rely on worker_count workers having started
+    pysamoa::python_scoped_unlock unlock;
+
+    while(executor->get_worker_count() < worker_count)
+        boost::this_thread::yield();
+}
+
 void make_proactor_bindings()
 {
     bpl::class_<proactor, proactor_ptr_t, boost::noncopyable>(
@@ -178,7 +261,18 @@ void make_proactor_bindings()
         .def("serial_io_service", &proactor::serial_io_service)
         .def("concurrent_io_service", &proactor::concurrent_io_service)
         .def("declare_serial_io_service", &proactor::declare_serial_io_service)
-        .def("declare_concurrent_io_service", &proactor::declare_concurrent_io_service);
+        .def("declare_concurrent_io_service", &proactor::declare_concurrent_io_service)
+        .def("declare_pinned_serial_io_service",
+            &proactor::declare_pinned_serial_io_service)
+        .def("get_declared_serial_io_service",
+            &proactor::get_declared_serial_io_service)
+        .def("get_serial_io_services", &py_get_serial_io_services)
+        .def("run_concurrent_executor", &py_run_concurrent_executor)
+        .def("start_concurrent_executor", &py_start_concurrent_executor,
+            (bpl::arg("worker_count") = 4))
+        .def("get_concurrent_executor", &proactor::concurrent_executor,
+            bpl::return_value_policy<bpl::copy_const_reference>())
+        .def("get_timer_wheel", &proactor::get_timer_wheel);
 
     bpl::class_<boost::asio::io_service, io_service_ptr_t, boost::noncopyable>(
         "_ioservice", bpl::no_init);
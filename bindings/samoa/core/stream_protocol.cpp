@@ -201,14 +201,22 @@ void make_stream_protocol_bindings()
         .def("read_data", &py_read_data)
         .def("read_line", &py_read_line, (
             bpl::arg("delim_char") = '\n',
-            bpl::arg("max_read_length") = 1024));
+            bpl::arg("max_read_length") = 1024))
+        .def("get_read_count",
+            &stream_protocol::read_interface_t::get_read_count)
+        .def("get_socket_read_count",
+            &stream_protocol::read_interface_t::get_socket_read_count)
+        .def("get_read_ahead",
+            &stream_protocol::read_interface_t::get_read_ahead);
 
     bpl::class_<stream_protocol::write_interface_t, boost::noncopyable>(
         "_StreamProtocol_WriteInterface", bpl::no_init)
         .def("has_queued_writes",
             &stream_protocol::write_interface_t::has_queued_writes)
         .def("queue_write", &py_queue_write)
-        .def("write_queued", &py_write_queued);
+        .def("write_queued", &py_write_queued)
+        .def("get_write_count",
+            &stream_protocol::write_interface_t::get_write_count);
 
     bpl::class_<stream_protocol, boost::noncopyable>(
 		"StreamProtocol", bpl::no_init)
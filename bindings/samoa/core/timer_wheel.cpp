@@ -0,0 +1,50 @@
+#include <boost/python.hpp>
+#include "samoa/core/timer_wheel.hpp"
+#include "pysamoa/scoped_python.hpp"
+#include <boost/bind.hpp>
+
+namespace samoa {
+namespace core {
+
+namespace bpl = boost::python;
+
+//////////////////////////////////////////////////////////
+// wheel_timer.schedule() support
+
+void on_py_timer(const pysamoa::python_object_ptr_t & callable)
+{
+    pysamoa::python_scoped_lock block;
+
+    (*callable)();
+}
+
+void py_schedule(wheel_timer & timer, const bpl::object & callable,
+    unsigned delay_ms)
+{
+    // expired & cancelled callbacks may be released without the GIL
+    timer.schedule(boost::bind(&on_py_timer,
+        pysamoa::hold_python_object(callable)), delay_ms);
+}
+
+void make_timer_wheel_bindings()
+{
+    bpl::class_<timer_wheel, timer_wheel::ptr_t, boost::noncopyable>(
+            "TimerWheel", bpl::init<const io_service_ptr_t &>())
+        .def("get_io_service", &timer_wheel::get_io_service,
+            bpl::return_value_policy<bpl::copy_const_reference>())
+        .def("get_pending_count", &timer_wheel::get_pending_count)
+        .def("get_driver_count", &timer_wheel::get_driver_count)
+        ;
+
+    bpl::class_<wheel_timer, wheel_timer::ptr_t, boost::noncopyable>(
+            "WheelTimer", bpl::init<const io_service_ptr_t &>())
+        .def(bpl::init<const timer_wheel_ptr_t &>())
+        .def("schedule", &py_schedule)
+        .def("cancel", &wheel_timer::cancel)
+        .def("is_scheduled", &wheel_timer::is_scheduled)
+        ;
+}
+
+}
+}
+
@@ -0,0 +1,63 @@
+#include <boost/python.hpp>
+#include "samoa/core/work_stealing_executor.hpp"
+#include "pysamoa/scoped_python.hpp"
+#include <boost/bind.hpp>
+
+namespace samoa {
+namespace core {
+
+namespace bpl = boost::python;
+
+// handlers may be released by any executor thread
+void on_py_post(const pysamoa::python_object_ptr_t & callable)
+{
+    pysamoa::python_scoped_lock block;
+
+    (*callable)();
+}
+
+//////////////////////////////////////////////////////////
+// work_stealing_executor.post() support
+
+void py_executor_post(work_stealing_executor & executor,
+    const bpl::object & callable)
+{
+    executor.post(boost::bind(&on_py_post,
+        pysamoa::hold_python_object(callable)));
+}
+
+//////////////////////////////////////////////////////////
+// work_stealing_executor::strand.post() support
+
+void py_strand_post(work_stealing_executor::strand & strand,
+    const bpl::object & callable)
+{
+    strand.post(boost::bind(&on_py_post,
+        pysamoa::hold_python_object(callable)));
+}
+
+void make_work_stealing_executor_bindings()
+{
+    bpl::class_<work_stealing_executor, work_stealing_executor::ptr_t,
+            boost::noncopyable>("WorkStealingExecutor", bpl::no_init)
+        .def("post", &py_executor_post)
+        .def("running_in_this_thread",
+            &work_stealing_executor::running_in_this_thread)
+        .def("get_worker_count", &work_stealing_executor::get_worker_count)
+        ;
+
+    bpl::class_<work_stealing_executor::strand,
+            boost::shared_ptr<work_stealing_executor::strand>,
+            boost::noncopyable>("Strand",
+            bpl::init<const work_stealing_executor::ptr_t &>())
+        .def("post", &py_strand_post)
+        .def("running_in_this_thread",
+            &work_stealing_executor::strand::running_in_this_thread)
+        .def("get_executor", &work_stealing_executor::strand::get_executor,
+            bpl::return_value_policy<bpl::copy_const_reference>())
+        ;
+}
+
+}
+}
+
@@ -8,6 +8,8 @@ namespace persistence {
     void make_heap_rolling_hash_bindings();
     void make_mapped_rolling_hash_bindings();
     void make_persister_bindings();
+    void make_replication_log_bindings();
+    void make_record_cache_bindings();
 }
 }
 
@@ -18,5 +20,7 @@ BOOST_PYTHON_MODULE(_persistence)
     samoa::persistence::make_heap_rolling_hash_bindings();
     samoa::persistence::make_mapped_rolling_hash_bindings();
     samoa::persistence::make_persister_bindings();
+    samoa::persistence::make_replication_log_bindings();
+    samoa::persistence::make_record_cache_bindings();
 }
 
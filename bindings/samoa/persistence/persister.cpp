@@ -3,6 +3,7 @@
 #include "samoa/persistence/persister.hpp"
 #include "samoa/persistence/rolling_hash.hpp"
 #include "samoa/persistence/record.hpp"
+#include "samoa/persistence/record_cache.hpp"
 #include "samoa/datamodel/merge_func.hpp"
 #include "pysamoa/scoped_python.hpp"
 #include "pysamoa/future.hpp"
@@ -191,6 +192,9 @@ void make_persister_bindings()
         .def("iterate", &py_iterate)
         .def("add_heap_hash", &persister::add_heap_hash)
         .def("add_mapped_hash", &persister::add_mapped_hash)
+        .def("set_record_cache", &persister::set_record_cache)
+        .def("get_record_cache", &persister::get_record_cache,
+            bpl::return_value_policy<bpl::copy_const_reference>())
         .def("get_layer_count", &persister::get_layer_count)
         .def("get_layer", &persister::get_layer,
             bpl::return_value_policy<bpl::reference_existing_object>());
@@ -0,0 +1,62 @@
+#include <boost/python.hpp>
+#include "samoa/persistence/record_cache.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+#include <boost/make_shared.hpp>
+
+namespace samoa {
+namespace persistence {
+
+namespace bpl = boost::python;
+
+typedef boost::shared_ptr<spb::PersistedRecord> prec_ptr_t;
+
+bpl::object py_get(record_cache & cache, const bpl::str & py_key)
+{
+    const char * buf = PyString_AS_STRING(py_key.ptr());
+    std::string key(buf, buf + PyString_GET_SIZE(py_key.ptr()));
+
+    prec_ptr_t record = boost::make_shared<spb::PersistedRecord>();
+
+    if(cache.get(key, *record))
+    {
+        return bpl::object(record);
+    }
+    return bpl::object();
+}
+
+void py_insert(record_cache & cache, const bpl::str & py_key,
+    const spb::PersistedRecord & record)
+{
+    const char * buf = PyString_AS_STRING(py_key.ptr());
+    std::string key(buf, buf + PyString_GET_SIZE(py_key.ptr()));
+
+    cache.insert(key, record);
+}
+
+void py_invalidate(record_cache & cache, const bpl::str & py_key)
+{
+    const char * buf = PyString_AS_STRING(py_key.ptr());
+    std::string key(buf, buf + PyString_GET_SIZE(py_key.ptr()));
+
+    cache.invalidate(key);
+}
+
+void make_record_cache_bindings()
+{
+    bpl::class_<record_cache, record_cache::ptr_t, boost::noncopyable>(
+            "RecordCache", bpl::init<size_t>())
+        .def("get", &py_get)
+        .def("insert", &py_insert)
+        .def("invalidate", &py_invalidate)
+        .def("total_size", &record_cache::total_size)
+        .def("used_size", &record_cache::used_size)
+        .def("entry_count", &record_cache::entry_count)
+        .def("hit_count", &record_cache::hit_count)
+        .def("miss_count", &record_cache::miss_count)
+        .def("eviction_count", &record_cache::eviction_count)
+        ;
+}
+
+}
+}
+
@@ -0,0 +1,52 @@
+#include <boost/python.hpp>
+#include "samoa/persistence/replication_log.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+
+namespace samoa {
+namespace persistence {
+
+namespace bpl = boost::python;
+
+uint64_t py_append(replication_log & log,
+    const bpl::str & py_key, const spb::ClusterClock & clock)
+{
+    const char * buf = PyString_AS_STRING(py_key.ptr());
+    std::string key(buf, buf + PyString_GET_SIZE(py_key.ptr()));
+
+    return log.append(key, clock);
+}
+
+bpl::tuple py_read(const replication_log & log,
+    uint64_t sequence, size_t max_entries)
+{
+    std::vector<std::string> entries;
+    uint64_t next_sequence;
+
+    bool available = log.read(sequence, max_entries,
+        entries, next_sequence);
+
+    bpl::list py_entries;
+    for(auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        py_entries.append(bpl::str(it->data(), it->size()));
+    }
+    return bpl::make_tuple(available, py_entries, next_sequence);
+}
+
+void make_replication_log_bindings()
+{
+    bpl::class_<replication_log, replication_log::ptr_t, boost::noncopyable>(
+            "ReplicationLog", bpl::init<size_t>())
+        .def(bpl::init<const std::string &, size_t>())
+        .def("append", &py_append)
+        .def("read", &py_read)
+        .def("begin_sequence", &replication_log::begin_sequence)
+        .def("end_sequence", &replication_log::end_sequence)
+        .def("total_region_size", &replication_log::total_region_size)
+        .def("used_region_size", &replication_log::used_region_size)
+        ;
+}
+
+}
+}
+
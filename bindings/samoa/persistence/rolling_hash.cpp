@@ -37,6 +37,10 @@ bool py_mark_for_deletion(rolling_hash * hash, const bpl::str & key)
     return hash->mark_for_deletion(key_begin, key_end);
 }
 
+rolling_hash::offset_t py_spill_head(rolling_hash * hash,
+    rolling_hash & next, rolling_hash::offset_t max_length)
+{ return hash->spill_head(next, max_length); }
+
 void make_rolling_hash_bindings()
 {
     // use of auto_ptr is non-optimal: unique_ptr is preferred
@@ -51,6 +55,7 @@ void make_rolling_hash_bindings()
         .def("mark_for_deletion", &py_mark_for_deletion)
         .def("reclaim_head", &rolling_hash::reclaim_head)
         .def("rotate_head", &rolling_hash::rotate_head)
+        .def("spill_head", &py_spill_head)
         .def("head", &rolling_hash::head,
             bpl::return_value_policy<bpl::reference_existing_object>())
         .def("step", &rolling_hash::step,
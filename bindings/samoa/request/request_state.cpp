@@ -180,6 +180,21 @@ bool py_peer_replication_failure(state & s)
 bool py_peer_replication_success(state & s)
 { return s.peer_replication_success(); }
 
+bool py_has_deadline(state & s)
+{ return s.has_deadline(); }
+
+unsigned py_get_remaining_ms(state & s)
+{ return s.get_remaining_ms(); }
+
+bool py_is_expired(state & s)
+{ return s.is_expired(); }
+
+bool py_check_deadline(state & s)
+{ return s.check_deadline(); }
+
+unsigned py_get_expired_count()
+{ return state::get_expired_count(); }
+
 
 
 void make_state_bindings()
@@ -246,8 +261,24 @@ void make_state_bindings()
         .def("peer_replication_failure", &py_peer_replication_failure)
         .def("peer_replication_success", &py_peer_replication_success)
 
+        // deadline_state
+        .def("load_deadline_state", &state::load_deadline_state)
+
+        .def("has_deadline", &py_has_deadline)
+        .def("get_remaining_ms", &py_get_remaining_ms)
+        .def("is_expired", &py_is_expired)
+        .def("check_deadline", &py_check_deadline)
+        .def("drop_if_expired", &state::drop_if_expired)
+        .def("get_expired_count", &py_get_expired_count)
+        .staticmethod("get_expired_count")
+
         .def("parse_samoa_request", &state::parse_samoa_request)
         .def("reset_state", &state::reset_state)
+
+        .def("acquire", &state::acquire)
+        .staticmethod("acquire")
+        .def("get_pooled_count", &state::get_pooled_count)
+        .staticmethod("get_pooled_count")
         ;
 }
 
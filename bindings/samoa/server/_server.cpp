@@ -7,6 +7,8 @@ namespace server {
     void make_context_bindings();
     void make_listener_bindings();
     void make_protocol_bindings();
+    void make_request_scheduler_bindings();
+    void make_replication_bindings();
     void make_command_handler_bindings();
     void make_cluster_state_bindings();
     void make_peer_set_bindings();
@@ -14,6 +16,7 @@ namespace server {
     void make_table_bindings();
     void make_partition_bindings();
     void make_local_partition_bindings();
+    void make_digest_bindings();
     void make_remote_partition_bindings();
 }
 }
@@ -24,6 +27,8 @@ BOOST_PYTHON_MODULE(_server)
     samoa::server::make_context_bindings();
     samoa::server::make_listener_bindings();
     samoa::server::make_protocol_bindings();
+    samoa::server::make_request_scheduler_bindings();
+    samoa::server::make_replication_bindings();
     samoa::server::make_command_handler_bindings();
     samoa::server::make_cluster_state_bindings();
     samoa::server::make_peer_set_bindings();
@@ -31,6 +36,7 @@ BOOST_PYTHON_MODULE(_server)
     samoa::server::make_table_bindings();
     samoa::server::make_partition_bindings();
     samoa::server::make_local_partition_bindings();
+    samoa::server::make_digest_bindings();
     samoa::server::make_remote_partition_bindings();
 }
 
@@ -56,8 +56,19 @@ void make_client_bindings()
             bpl::return_value_policy<bpl::copy_const_reference>())
         .def("get_protocol", &client::get_protocol,
             bpl::return_value_policy<bpl::copy_const_reference>())
-        .def_readonly("max_request_concurrency",
-            &client::max_request_concurrency)
+        .def("get_max_request_bytes", &client::get_max_request_bytes)
+        .staticmethod("get_max_request_bytes")
+        .def("set_max_request_bytes", &client::set_max_request_bytes)
+        .staticmethod("set_max_request_bytes")
+        .def("get_max_total_request_bytes",
+            &client::get_max_total_request_bytes)
+        .staticmethod("get_max_total_request_bytes")
+        .def("set_max_total_request_bytes",
+            &client::set_max_total_request_bytes)
+        .staticmethod("set_max_total_request_bytes")
+        .def("get_total_request_bytes", &client::get_total_request_bytes)
+        .staticmethod("get_total_request_bytes")
+        .def("get_request_bytes", &client::get_request_bytes)
         .def("schedule_response", &py_schedule_response)
         .def("__repr__", &py_repr);
 }
@@ -7,7 +7,11 @@ namespace command {
     void make_get_blob_handler_bindings();
     void make_set_blob_handler_bindings();
     void make_replicate_handler_bindings();
+    void make_replication_log_handler_bindings();
+    void make_digest_handler_bindings();
     void make_cluster_state_handler_bindings();
+    void make_multi_get_handler_bindings();
+    void make_multi_set_handler_bindings();
 }
 }
 }
@@ -17,6 +21,10 @@ BOOST_PYTHON_MODULE(_command)
     samoa::server::command::make_get_blob_handler_bindings();
     samoa::server::command::make_set_blob_handler_bindings();
     samoa::server::command::make_replicate_handler_bindings();
+    samoa::server::command::make_replication_log_handler_bindings();
+    samoa::server::command::make_digest_handler_bindings();
     samoa::server::command::make_cluster_state_handler_bindings();
+    samoa::server::command::make_multi_get_handler_bindings();
+    samoa::server::command::make_multi_set_handler_bindings();
 }
 
@@ -0,0 +1,21 @@
+#include <boost/python.hpp>
+#include "samoa/server/command/digest.hpp"
+
+namespace samoa {
+namespace server {
+namespace command {
+
+namespace bpl = boost::python;
+
+void make_digest_handler_bindings()
+{
+    bpl::class_<digest_handler, digest_handler::ptr_t,
+            boost::noncopyable, bpl::bases<command_handler>
+        >("DigestHandler", bpl::init<>())
+        ;
+}
+
+}
+}
+}
+
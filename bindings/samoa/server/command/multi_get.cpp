@@ -0,0 +1,21 @@
+
+#include <boost/python.hpp>
+#include "samoa/server/command/multi_get.hpp"
+
+namespace samoa {
+namespace server {
+namespace command {
+
+namespace bpl = boost::python;
+
+void make_multi_get_handler_bindings()
+{
+    bpl::class_<multi_get_handler, multi_get_handler::ptr_t, boost::noncopyable,
+            bpl::bases<command_handler> >("MultiGetHandler", bpl::init<>())
+        ;
+}
+
+}
+}
+}
+
@@ -0,0 +1,21 @@
+
+#include <boost/python.hpp>
+#include "samoa/server/command/multi_set.hpp"
+
+namespace samoa {
+namespace server {
+namespace command {
+
+namespace bpl = boost::python;
+
+void make_multi_set_handler_bindings()
+{
+    bpl::class_<multi_set_handler, multi_set_handler::ptr_t, boost::noncopyable,
+            bpl::bases<command_handler> >("MultiSetHandler", bpl::init<>())
+        ;
+}
+
+}
+}
+}
+
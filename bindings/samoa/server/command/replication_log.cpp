@@ -0,0 +1,21 @@
+#include <boost/python.hpp>
+#include "samoa/server/command/replication_log.hpp"
+
+namespace samoa {
+namespace server {
+namespace command {
+
+namespace bpl = boost::python;
+
+void make_replication_log_handler_bindings()
+{
+    bpl::class_<replication_log_handler, replication_log_handler::ptr_t,
+            boost::noncopyable, bpl::bases<command_handler>
+        >("ReplicationLogHandler", bpl::init<>())
+        ;
+}
+
+}
+}
+}
+
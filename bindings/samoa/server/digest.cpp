@@ -0,0 +1,34 @@
+#include <boost/python.hpp>
+#include "samoa/server/digest.hpp"
+#include <vector>
+
+namespace samoa {
+namespace server {
+
+namespace bpl = boost::python;
+
+bpl::list py_get_range_digests(const digest & d,
+    unsigned range_begin, unsigned range_count)
+{
+    std::vector<uint64_t> range_digests;
+    d.get_range_digests(range_begin, range_count, range_digests);
+
+    bpl::list out;
+    for(auto it = range_digests.begin(); it != range_digests.end(); ++it)
+    {
+        out.append(*it);
+    }
+    return out;
+}
+
+void make_digest_bindings()
+{
+    bpl::class_<digest, digest::ptr_t, boost::noncopyable>(
+            "Digest", bpl::init<>())
+        .def("get_range_digests", &py_get_range_digests)
+        ;
+}
+
+}
+}
+
@@ -4,6 +4,7 @@
 #include "samoa/server/context.hpp"
 #include "samoa/server/protocol.hpp"
 #include "samoa/core/tasklet.hpp"
+#include "samoa/core/fwd.hpp"
 #include <string>
 
 namespace samoa {
@@ -18,6 +19,9 @@ void make_listener_bindings()
         bpl::bases<core::tasklet_base> >("Listener",
             bpl::init<const context::ptr_t &, const protocol::ptr_t &>(
                 bpl::args("context", "protocol")))
+        .def(bpl::init<const context::ptr_t &, const protocol::ptr_t &,
+            const core::io_service_ptr_t &>(
+                bpl::args("context", "protocol", "io_service")))
         .def("get_address", &listener::get_address)
         .def("get_port", &listener::get_port)
         .def("get_context", &listener::get_context,
@@ -2,7 +2,9 @@
 #include <boost/python.hpp>
 #include "samoa/server/local_partition.hpp"
 #include "samoa/server/partition.hpp"
+#include "samoa/server/digest.hpp"
 #include "samoa/persistence/persister.hpp"
+#include "samoa/persistence/replication_log.hpp"
 
 namespace samoa {
 namespace server {
@@ -19,6 +21,10 @@ void make_local_partition_bindings()
                 const local_partition::ptr_t &>())
         .def("get_persister", &local_partition::get_persister,
             bpl::return_value_policy<bpl::copy_const_reference>())
+        .def("get_replication_log", &local_partition::get_replication_log,
+            bpl::return_value_policy<bpl::copy_const_reference>())
+        .def("get_digest", &local_partition::get_digest,
+            bpl::return_value_policy<bpl::copy_const_reference>())
         ;
 
     bpl::implicitly_convertible<local_partition::ptr_t, partition::ptr_t>();
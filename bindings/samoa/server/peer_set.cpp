@@ -17,6 +17,7 @@ void make_peer_set_bindings()
                 const peer_set::ptr_t &>())
         .def("merge_peer_set", &peer_set::merge_peer_set)
         .def("forward_request", &peer_set::forward_request)
+        .def("set_peer_statistics", &peer_set::set_peer_statistics)
         ;
 }
 
@@ -14,6 +14,8 @@ void make_protocol_bindings()
         "Protocol", init<>())
         .def("set_command_handler", &protocol::set_command_handler)
         .def("get_command_handler", &protocol::get_command_handler,
+            return_value_policy<copy_const_reference>())
+        .def("get_request_scheduler", &protocol::get_request_scheduler,
             return_value_policy<copy_const_reference>());
 }
 
@@ -0,0 +1,32 @@
+#include <boost/python.hpp>
+#include "samoa/server/replication.hpp"
+
+namespace samoa {
+namespace server {
+
+namespace bpl = boost::python;
+
+void make_replication_bindings()
+{
+    bpl::class_<replication, replication::ptr_t,
+            boost::noncopyable>("Replication", bpl::no_init)
+        .def("get_hedged_reads", &replication::get_hedged_reads)
+        .staticmethod("get_hedged_reads")
+        .def("set_hedged_reads", &replication::set_hedged_reads)
+        .staticmethod("set_hedged_reads")
+        .def("get_hedge_quantile", &replication::get_hedge_quantile)
+        .staticmethod("get_hedge_quantile")
+        .def("set_hedge_quantile", &replication::set_hedge_quantile)
+        .staticmethod("set_hedge_quantile")
+        .def("get_max_hedge_delay_ms", &replication::get_max_hedge_delay_ms)
+        .staticmethod("get_max_hedge_delay_ms")
+        .def("set_max_hedge_delay_ms", &replication::set_max_hedge_delay_ms)
+        .staticmethod("set_max_hedge_delay_ms")
+        .def("get_hedge_count", &replication::get_hedge_count)
+        .staticmethod("get_hedge_count")
+        ;
+}
+
+}
+}
+
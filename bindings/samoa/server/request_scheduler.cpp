@@ -0,0 +1,45 @@
+#include <boost/python.hpp>
+#include "samoa/server/request_scheduler.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+
+namespace samoa {
+namespace server {
+
+namespace bpl = boost::python;
+
+void make_request_scheduler_bindings()
+{
+    bpl::class_<request_scheduler, request_scheduler::ptr_t,
+            boost::noncopyable>("RequestScheduler", bpl::init<>())
+        .def("classify", &request_scheduler::classify)
+        .staticmethod("classify")
+        .def("classify_request", &request_scheduler::classify_request)
+        .staticmethod("classify_request")
+        .def("get_max_concurrency", &request_scheduler::get_max_concurrency)
+        .def("set_max_concurrency", &request_scheduler::set_max_concurrency)
+        .def("get_reserved_concurrency",
+            &request_scheduler::get_reserved_concurrency)
+        .def("set_reserved_concurrency",
+            &request_scheduler::set_reserved_concurrency)
+        .def("get_weight", &request_scheduler::get_weight)
+        .def("set_weight", &request_scheduler::set_weight)
+        .def("get_max_queue_depth", &request_scheduler::get_max_queue_depth)
+        .def("set_max_queue_depth", &request_scheduler::set_max_queue_depth)
+        .def("get_running_count", &request_scheduler::get_running_count)
+        .def("get_queued_count", &request_scheduler::get_queued_count)
+        .def("get_shed_count", &request_scheduler::get_shed_count)
+        ;
+
+    bpl::enum_<request_scheduler::priority_class>("PriorityClass")
+        .value("CLIENT_READ", request_scheduler::CLIENT_READ)
+        .value("CLIENT_WRITE", request_scheduler::CLIENT_WRITE)
+        .value("FORWARDED", request_scheduler::FORWARDED)
+        .value("REPLICATION", request_scheduler::REPLICATION)
+        .value("BACKGROUND", request_scheduler::BACKGROUND)
+        .value("UNSCHEDULED", request_scheduler::UNSCHEDULED)
+        ;
+}
+
+}
+}
+
@@ -0,0 +1,99 @@
+#ifndef SAMOA_ADAPTIVE_LOCK_HPP
+#define SAMOA_ADAPTIVE_LOCK_HPP
+
+#include <boost/noncopyable.hpp>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace samoa {
+
+/*
+ * Spin-then-park lock.
+ *
+ * Acquisition spins briefly, as the holder is likely running & about
+ *  to release. If the lock remains held (eg, the holder was preempted),
+ *  the waiter parks on a futex rather than burning its time-slice.
+ *
+ * State is 0 when unlocked, 1 when locked, & 2 when locked with
+ *  (possible) parked waiters; release only enters the kernel in
+ *  the last case.
+ */
+class adaptive_lock :
+    private boost::noncopyable
+{
+public:
+
+    enum {
+        spin_count = 128
+    };
+
+    adaptive_lock()
+     : _state(0)
+    { }
+
+    void acquire()
+    {
+        for(unsigned i = 0; i != spin_count; ++i)
+        {
+            if(!_state && __sync_bool_compare_and_swap(&_state, 0, 1))
+                return;
+
+            cpu_relax();
+        }
+
+        // mark as contended, & park until released
+        while(__sync_lock_test_and_set(&_state, 2))
+        {
+            syscall(SYS_futex, &_state, FUTEX_WAIT_PRIVATE, 2, 0, 0, 0);
+        }
+    }
+
+    void release()
+    {
+        if(__sync_fetch_and_sub(&_state, 1) != 1)
+        {
+            // there may be parked waiters; wake one
+            __sync_lock_release(&_state);
+            syscall(SYS_futex, &_state, FUTEX_WAKE_PRIVATE, 1, 0, 0, 0);
+        }
+    }
+
+    class guard
+    {
+    public:
+
+        guard(adaptive_lock & l)
+         : _l(l)
+        {
+            _l.acquire();
+        }
+
+        ~guard()
+        {
+            _l.release();
+        }
+
+    private:
+
+        adaptive_lock & _l;
+    };
+
+private:
+
+    static void cpu_relax()
+    {
+#if defined(__i386__) || defined(__x86_64__)
+        __asm__ __volatile__("pause" ::: "memory");
+#else
+        __sync_synchronize();
+#endif
+    }
+
+    volatile int _state;
+};
+
+}
+
+#endif
+
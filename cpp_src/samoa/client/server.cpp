@@ -7,8 +7,16 @@
 #include <boost/smart_ptr/make_shared.hpp>
 #include <boost/bind/protect.hpp>
 #include <boost/bind.hpp>
+#include <algorithm>
 
-#define MAX_DATA_BLOCK_LENGTH 4194304
+// server-side, data blocks of up to this length may be streamed
+#define MAX_DATA_BLOCK_LENGTH 67108864
+
+// latency quantiles are estimated over this many recent responses
+#define LATENCY_SAMPLE_COUNT 64
+
+// weight of each latency sample in the moving average is 1 / N
+#define LATENCY_EWMA_DIVISOR 8
 
 namespace samoa {
 namespace client {
@@ -65,7 +73,11 @@ server::server(const core::io_service_ptr_t & io_srv,
     std::unique_ptr<boost::asio::ip::tcp::socket> & sock)
  :  core::stream_protocol(io_srv, sock),
     _next_request_id(1),
-    _ready_for_write(true)
+    _peer_protocol_version(1),
+    _request_count(0),
+    _writing_request(false),
+    _next_latency_sample(0),
+    _latency_ewma(0)
 {
     LOG_DBG("created " << this);    
 }
@@ -118,16 +130,42 @@ void server_request_interface::flush_request(
     unsigned request_id = _srv->_next_request_id++;
     _srv->_samoa_request.set_request_id(request_id);
 
+    // advertise our protocol version
+    _srv->_samoa_request.set_protocol_version(SAMOA_PROTOCOL_VERSION);
+
     // serialize & reset SamoaRequest
     core::zero_copy_output_adapter zco_adapter;
-    _srv->_samoa_request.SerializeToZeroCopyStream(&zco_adapter);
+    zco_adapter.serialize(_srv->_samoa_request);
     _srv->_samoa_request.Clear();
 
-    SAMOA_ASSERT(zco_adapter.ByteCount() < (1<<16));
+    if(!core::frame_length_supported(zco_adapter.ByteCount(),
+        _srv->_peer_protocol_version))
+    {
+        LOG_WARN("request of " << zco_adapter.ByteCount() << " bytes "
+            "exceeds frame limits of protocol version "
+            << _srv->_peer_protocol_version);
+
+        _srv->_request_data.clear();
+        {
+            adaptive_lock::guard guard(_srv->_lock);
+            _srv->_pending_responses[request_id].callback = callback;
+        }
+
+        // fail the request without writing it, & release the request
+        _srv->on_request_finish(boost::system::errc::make_error_code(
+            boost::system::errc::message_size), request_id);
+
+        // ownership of server::request_interface is released
+        _srv.reset();
+        return;
+    }
+
+    // write network order length preamble
+    char preamble[MAX_FRAME_PREAMBLE_SIZE];
+    char * preamble_end = preamble + core::write_frame_preamble(
+        zco_adapter.ByteCount(), _srv->_peer_protocol_version, preamble);
 
-    // write network order unsigned short length
-    uint16_t len = htons((uint16_t)zco_adapter.ByteCount());
-    _srv->queue_write((char*)&len, ((char*)&len) + 2);
+    _srv->queue_write((char*) preamble, preamble_end);
 
     // queue write of serialized output regions
     _srv->queue_write(zco_adapter.output_regions());
@@ -138,9 +176,16 @@ void server_request_interface::flush_request(
 
     // index callback under this request_id
     {
-        spinlock::guard guard(_srv->_lock);
+        adaptive_lock::guard guard(_srv->_lock);
 
-        _srv->_pending_responses[request_id] = callback;
+        server::pending_response & pending = \
+            _srv->_pending_responses[request_id];
+
+        pending.callback = callback;
+        pending.flush_time = deadline_timer::traits_type::now();
+
+        // counted by _request_count until on_request_finish
+        _srv->_writing_request = true;
     }
 
     // begin write operation, tracked with request id
@@ -209,7 +254,13 @@ server::~server()
 
 void server::schedule_request(const server::request_callback_t & callback)
 {
-    on_next_request(false, &callback);
+    _queued_request_callbacks.push(callback);
+
+    if(++_request_count == 1)
+    {
+        // no request was held or scheduled; begin this one
+        begin_next_request();
+    }
 }
 
 void server::on_next_response()
@@ -230,15 +281,46 @@ void server::on_response_length(const boost::system::error_code & ec,
 
     // parse upcoming protobuf message length
     uint16_t len;
-    std::copy(
-        boost::asio::buffers_begin(read_body),
-        boost::asio::buffers_end(read_body),
-        (char*) &len);
+    core::copy_regions(read_body, (char*) &len);
+
+    // a version 1 server may write a frame of EXTENDED_FRAME_MARKER
+    //  bytes; extended frames follow a response advertising version 2
+    if(core::is_extended_frame(ntohs(len), _peer_protocol_version))
+    {
+        read_data(boost::bind(&server::on_response_extended_length,
+            shared_from_this(), _1, _3), 4);
+        return;
+    }
 
     read_data(boost::bind(&server::on_response_body,
         shared_from_this(), _1, _3), ntohs(len));
 }
 
+void server::on_response_extended_length(const boost::system::error_code & ec,
+    const core::buffer_regions_t & read_body)
+{
+    if(ec)
+    {
+        on_response_error(ec);
+        return;
+    }
+
+    uint32_t len;
+    core::copy_regions(read_body, (char*) &len);
+
+    if(ntohl(len) > MAX_EXTENDED_FRAME_LENGTH)
+    {
+        LOG_ERR("response frame larger than " << MAX_EXTENDED_FRAME_LENGTH);
+
+        on_response_error(boost::system::errc::make_error_code(
+            boost::system::errc::bad_message));
+        return;
+    }
+
+    read_data(boost::bind(&server::on_response_body,
+        shared_from_this(), _1, _3), ntohl(len));
+}
+
 void server::on_response_body(const boost::system::error_code & ec,
     const core::buffer_regions_t & read_body)
 {
@@ -248,8 +330,7 @@ void server::on_response_body(const boost::system::error_code & ec,
         return;
     }
 
-    core::zero_copy_input_adapter zci_adapter(read_body);
-    if(!_samoa_response.ParseFromZeroCopyStream(&zci_adapter))
+    if(!core::parse_from_regions(_samoa_response, read_body))
     {
         // our transport is corrupted
         on_response_error(boost::system::errc::make_error_code(
@@ -257,6 +338,11 @@ void server::on_response_body(const boost::system::error_code & ec,
         return;
     }
 
+    if(_samoa_response.has_protocol_version())
+    {
+        _peer_protocol_version = _samoa_response.protocol_version();
+    }
+
     _response_data_blocks.clear();
     on_response_data_block(boost::system::error_code(),
         0, core::buffer_regions_t());
@@ -305,19 +391,86 @@ void server::on_response_data_block(const boost::system::error_code & ec,
 
     // we're done reading data blocks, and have assembled a complete resonse
     {
-        spinlock::guard guard(_lock);
+        adaptive_lock::guard guard(_lock);
 
         pending_responses_t::iterator it = _pending_responses.find(request_id);
         SAMOA_ASSERT(it != _pending_responses.end());
 
+        sample_latency(it->second.flush_time);
+
         // post response interface to associated callback
-        get_io_service()->post(boost::bind(it->second,
+        get_io_service()->post(boost::bind(it->second.callback,
             ec, response_interface(shared_from_this())));
 
         _pending_responses.erase(it);
     }
 }
 
+bool server::get_latency_quantile(double q, unsigned & latency_us) const
+{
+    std::vector<unsigned> samples;
+    {
+        adaptive_lock::guard guard(_lock);
+        samples = _latency_samples;
+    }
+
+    if(samples.empty())
+        return false;
+
+    size_t ind = std::min(samples.size() - 1,
+        size_t(q * samples.size()));
+
+    std::nth_element(samples.begin(), samples.begin() + ind, samples.end());
+    latency_us = samples[ind];
+    return true;
+}
+
+bool server::get_latency_ewma(unsigned & latency_us) const
+{
+    adaptive_lock::guard guard(_lock);
+
+    if(_latency_samples.empty())
+        return false;
+
+    latency_us = _latency_ewma;
+    return true;
+}
+
+unsigned server::get_queue_size() const
+{
+    adaptive_lock::guard guard(_lock);
+
+    // _request_count includes a request holding the request interface,
+    //  which is also pending a response while it's being written
+    return _request_count + _pending_responses.size() - \
+        (_writing_request ? 1 : 0);
+}
+
+void server::sample_latency(const boost::posix_time::ptime & flush_time)
+{
+    unsigned latency_us = (deadline_timer::traits_type::now() - flush_time
+        ).total_microseconds();
+
+    if(_latency_samples.empty())
+    {
+        _latency_ewma = latency_us;
+    }
+    else
+    {
+        _latency_ewma = int(_latency_ewma) + \
+            (int(latency_us) - int(_latency_ewma)) / LATENCY_EWMA_DIVISOR;
+    }
+
+    if(_latency_samples.size() != LATENCY_SAMPLE_COUNT)
+    {
+        _latency_samples.push_back(latency_us);
+        return;
+    }
+
+    _latency_samples[_next_latency_sample] = latency_us;
+    _next_latency_sample = (_next_latency_sample + 1) % LATENCY_SAMPLE_COUNT;
+}
+
 void server::on_response_error(const boost::system::error_code & ec)
 {
     // the server has closed or reset it's end of the connection;
@@ -329,13 +482,13 @@ void server::on_response_error(const boost::system::error_code & ec)
 
     // notify pending response callbacks of the error
     {
-        spinlock::guard guard(_lock);
+        adaptive_lock::guard guard(_lock);
 
         for(auto it = _pending_responses.begin();
             it != _pending_responses.end(); ++it)
         {
             // post error to callback
-            get_io_service()->post(boost::bind(it->second,
+            get_io_service()->post(boost::bind(it->second.callback,
                 ec, response_interface((ptr_t()))));
         }
 
@@ -343,75 +496,42 @@ void server::on_response_error(const boost::system::error_code & ec)
     }
 }
 
-void server::on_next_request(bool is_write_complete,
-    const request_callback_t * new_callback)
+void server::begin_next_request()
 {
-    spinlock::guard guard(_lock);
-
-    SAMOA_ASSERT(is_write_complete ^ (new_callback != 0));
-
-    if(is_write_complete)
-    {
-        _ready_for_write = true;
-    }
-
-    if(!_ready_for_write)
-    {
-        if(new_callback)
-        {
-            _queued_request_callbacks.push_back(*new_callback);
-        }
-        return;
-    }
-
-    // we're ready to start a new request
+    request_callback_t callback;
 
-    if(!_queued_request_callbacks.empty())
-    {
-        // it should never be possible for us to be ready-to-write,
-        //  and have both a new_callback & queued callbacks.
-        //
-        // only on_request_finish can clear the ready_for_write bit,
-        //  and that call never issues a new_callback
-        SAMOA_ASSERT(!new_callback);
-
-        _ready_for_write = false;
-
-        // post call to next queued request callback
-        get_io_service()->post(
-            boost::bind(_queued_request_callbacks.front(),
-                boost::system::error_code(),
-                request_interface(shared_from_this())));
-
-        _queued_request_callbacks.pop_front();
-    }
-    else if(new_callback)
-    {
-        _ready_for_write = false;
+    // the callback was pushed prior to the count increment
+    //  which passed us the request token
+    _queued_request_callbacks.pop(callback);
 
-        // post call directly to new_callback
-        get_io_service()->post(boost::bind(*new_callback,
-            boost::system::error_code(),
-            request_interface(shared_from_this())));
-    }
-    // else, no request to begin at this point
+    get_io_service()->post(boost::bind(callback,
+        boost::system::error_code(),
+        request_interface(shared_from_this())));
 }
 
 void server::on_request_finish(const boost::system::error_code & ec,
     unsigned request_id)
 {
-    if(ec)
+    long request_count;
     {
-        spinlock::guard guard(_lock);
+        adaptive_lock::guard guard(_lock);
 
-        pending_responses_t::iterator it = _pending_responses.find(request_id);
+        // the request is counted only as pending its response; updated
+        //  together, so that get_queue_size() doesn't count it twice
+        _writing_request = false;
+        request_count = --_request_count;
+
+        pending_responses_t::iterator it = _pending_responses.end();
 
         // race condition check: on_response_error may have already
         //   posted an error & cleared the callback
+        if(ec)
+            it = _pending_responses.find(request_id);
+
         if(it != _pending_responses.end())
         {
             // post error to response callback
-            get_io_service()->post(boost::bind(it->second,
+            get_io_service()->post(boost::bind(it->second.callback,
                 ec, response_interface((ptr_t()))));
 
             _pending_responses.erase(it);
@@ -419,7 +539,10 @@ void server::on_request_finish(const boost::system::error_code & ec,
     }
 
     // start a new request, if there is one
-    on_next_request(true, 0);
+    if(request_count != 0)
+    {
+        begin_next_request();
+    }
 }
 
 }
@@ -7,9 +7,13 @@
 #include "samoa/core/connection_factory.hpp"
 #include "samoa/core/protobuf/samoa.pb.h"
 #include "samoa/core/proactor.hpp"
+#include "samoa/core/mpsc_queue.hpp"
+#include "samoa/adaptive_lock.hpp"
+#include <boost/detail/atomic_count.hpp>
 #include <boost/unordered_map.hpp>
 #include <boost/asio.hpp>
 #include <list>
+#include <vector>
 #include <memory>
 
 namespace samoa {
@@ -156,14 +160,55 @@ public:
      */
     void schedule_request(const request_callback_t &);
 
+    /*!
+     * Highest wire protocol version advertised by the server. Until
+     *  the first response is read, version 1 is assumed, and requests
+     *  requiring an extended frame fail with errc::message_size.
+     */
+    unsigned get_peer_protocol_version() const
+    { return _peer_protocol_version; }
+
+    /*!
+     * Estimates the q-quantile (eg, 0.95) of request latency, in
+     *  microseconds, over the most recent responses read from the
+     *  server. Latency is measured from request flush until its
+     *  complete response is read.
+     *
+     * Returns false if no latency samples have been taken.
+     */
+    bool get_latency_quantile(double q, unsigned & latency_us) const;
+
+    /*!
+     * Exponentially-weighted moving average of request latency,
+     *  in microseconds. Each sample has a weight of 1/8.
+     *
+     * Returns false if no latency samples have been taken.
+     */
+    bool get_latency_ewma(unsigned & latency_us) const;
+
+    /*!
+     * Count of requests which are scheduled, being written,
+     *  or awaiting their response from the server
+     */
+    unsigned get_queue_size() const;
+
 private:
 
     friend class server_request_interface;
     friend class server_response_interface;
 
-    typedef boost::unordered_map<unsigned, response_callback_t
+    struct pending_response
+    {
+        response_callback_t callback;
+        boost::posix_time::ptime flush_time;
+    };
+
+    typedef boost::unordered_map<unsigned, pending_response
         > pending_responses_t;
 
+    // Preconditions: _lock is held
+    void sample_latency(const boost::posix_time::ptime & flush_time);
+
     static void on_connect(const boost::system::error_code &,
         const core::io_service_ptr_t &,
         std::unique_ptr<boost::asio::ip::tcp::socket> &,
@@ -177,10 +222,14 @@ private:
      */ 
     void on_next_response();
 
-    // Begins read of SamoaResponse
+    // Begins read of SamoaResponse, or of an extended length
     void on_response_length(const boost::system::error_code &,
         const core::buffer_regions_t &);
 
+    // Begins read of an extended-frame SamoaResponse
+    void on_response_extended_length(const boost::system::error_code &,
+        const core::buffer_regions_t &);
+
     // Parses SamoaResponse, and begins read of response data-blocks
     void on_response_body(const boost::system::error_code &,
         const core::buffer_regions_t &);
@@ -200,21 +249,13 @@ private:
     void on_response_error(const boost::system::error_code &);
 
     /*
-     * Request scheduling workhorse.
-     *
-     * If we're ready to write a new request (_ready_for_write),
-     *  and have a queued callback, that callback is posted.
-     *
-     * If a new callback is given, that callback is either
-     *  posted (if we're ready to write, and there's no queued
-     *  callback) or itself queued.
+     * Pops & posts the next scheduled request callback.
      *
-     * @param is_write_complete Whether this call marks that a
-     *  current request operation has completed.
-     * @param new_callback A new request callback to invoke or queue
+     * Preconditions: the caller holds the (implied) request token; ie,
+     *  it incremented _request_count from zero, or decremented it
+     *  to a non-zero value.
      */
-    void on_next_request(bool is_write_complete,
-        const request_callback_t * new_callback);
+    void begin_next_request();
 
     /*
      * Callback when a request has been written (or aborted)
@@ -231,17 +272,29 @@ private:
     core::protobuf::SamoaRequest _samoa_request;
     core::const_buffer_regions_t _request_data;
     unsigned _next_request_id;
+    unsigned _peer_protocol_version;
 
     // exposed as immutable through response_interface
     core::protobuf::SamoaResponse _samoa_response;
     std::vector<core::buffer_regions_t> _response_data_blocks;
 
-    bool _ready_for_write; // xthread
+    // scheduled request callbacks, and their count plus one for
+    //  the request currently holding the request interface (if any)
+    core::mpsc_queue<request_callback_t> _queued_request_callbacks;
+    boost::detail::atomic_count _request_count; // xthread
 
-    std::list<request_callback_t> _queued_request_callbacks; // xthread
     pending_responses_t _pending_responses; // xthread
 
-    spinlock _lock;
+    // whether the request holding the interface has been flushed, and
+    //  is being written (and is thus also in _pending_responses)
+    bool _writing_request; // xthread
+
+    // ring of recent latency samples (in microseconds)
+    std::vector<unsigned> _latency_samples; // xthread
+    size_t _next_latency_sample; // xthread
+    unsigned _latency_ewma; // xthread
+
+    mutable adaptive_lock _lock;
 
     friend class server_private_ctor;
 };
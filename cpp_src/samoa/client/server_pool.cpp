@@ -2,8 +2,10 @@
 #include "samoa/client/server_pool.hpp"
 #include "samoa/error.hpp"
 #include "samoa/log.hpp"
+#include <boost/random/uniform_int_distribution.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/bind.hpp>
+#include <limits>
 
 namespace samoa {
 namespace client {
@@ -18,7 +20,7 @@ server_pool::~server_pool()
 void server_pool::set_server_address(const core::uuid & uuid,
     const std::string & host, unsigned short port)
 {
-    spinlock::guard guard(_lock);
+    adaptive_lock::guard guard(_lock);
 
     _addresses[uuid] = address_t(host, port);
     _servers[uuid] = server::ptr_t();
@@ -27,7 +29,7 @@ void server_pool::set_server_address(const core::uuid & uuid,
 void server_pool::set_connected_server(const core::uuid & uuid,
     const server::ptr_t & server)
 {
-    spinlock::guard guard(_lock);
+    adaptive_lock::guard guard(_lock);
 
     SAMOA_ASSERT(_addresses.find(uuid) != _addresses.end());
 
@@ -38,7 +40,7 @@ void server_pool::schedule_request(
     const server::request_callback_t & callback,
     const core::uuid & uuid)
 {
-    spinlock::guard guard(_lock);
+    adaptive_lock::guard guard(_lock);
 
     // already have a connected server?
     {
@@ -74,14 +76,14 @@ void server_pool::schedule_request(
 
 bool server_pool::has_server(const core::uuid & uuid)
 {
-    spinlock::guard guard(_lock);
+    adaptive_lock::guard guard(_lock);
 
     return _addresses.find(uuid) != _addresses.end();
 }
 
 server::ptr_t server_pool::get_server(const core::uuid & uuid)
 {
-    spinlock::guard guard(_lock);
+    adaptive_lock::guard guard(_lock);
 
     server_map_t::const_iterator it = _servers.find(uuid);
     SAMOA_ASSERT(it != _servers.end());
@@ -92,9 +94,71 @@ server::ptr_t server_pool::get_server(const core::uuid & uuid)
         return server::ptr_t();
 }
 
+server_pool::server_stats server_pool::get_server_stats(
+    const core::uuid & uuid)
+{
+    server_stats stats;
+    stats.connected = false;
+    stats.queue_size = 0;
+    stats.latency_us = 0;
+    stats.has_latency = false;
+
+    server::ptr_t server = get_server(uuid);
+    if(server)
+    {
+        stats.connected = true;
+        stats.queue_size = server->get_queue_size();
+        stats.has_latency = server->get_latency_ewma(stats.latency_us);
+    }
+    return stats;
+}
+
+unsigned server_pool::get_server_load(const core::uuid & uuid)
+{
+    server_stats stats = get_server_stats(uuid);
+
+    if(!stats.connected)
+        return std::numeric_limits<unsigned>::max();
+
+    uint64_t load = uint64_t(stats.latency_us) * (stats.queue_size + 1);
+
+    return std::min<uint64_t>(load,
+        std::numeric_limits<unsigned>::max() - 1);
+}
+
+core::uuid server_pool::select_server(
+    const std::vector<core::uuid> & candidates)
+{
+    SAMOA_ASSERT(!candidates.empty());
+
+    if(candidates.size() == 1)
+        return candidates[0];
+
+    size_t first, second;
+    {
+        adaptive_lock::guard guard(_lock);
+
+        boost::random::uniform_int_distribution<size_t> dist(
+            0, candidates.size() - 1);
+
+        first = dist(_rng);
+
+        // choose a distinct second candidate
+        second = (first + 1 + boost::random::uniform_int_distribution<
+            size_t>(0, candidates.size() - 2)(_rng)) % candidates.size();
+    }
+
+    if(get_server_load(candidates[second]) < \
+       get_server_load(candidates[first]))
+    {
+        return candidates[second];
+    }
+    return candidates[first];
+}
+
 std::string server_pool::get_server_hostname(const core::uuid & uuid)
 {
-    spinlock::guard guard(_lock);
+    adaptive_lock::guard guard(_lock);
 
     address_map_t::const_iterator it = _addresses.find(uuid);
     SAMOA_ASSERT(it != _addresses.end());
@@ -104,7 +168,7 @@ std::string server_pool::get_server_hostname(const core::uuid & uuid)
 
 unsigned short server_pool::get_server_port(const core::uuid & uuid)
 {
-    spinlock::guard guard(_lock);
+    adaptive_lock::guard guard(_lock);
 
     address_map_t::const_iterator it = _addresses.find(uuid);
     SAMOA_ASSERT(it != _addresses.end());
@@ -114,7 +178,7 @@ unsigned short server_pool::get_server_port(const core::uuid & uuid)
 
 void server_pool::close()
 {
-    spinlock::guard guard(_lock);
+    adaptive_lock::guard guard(_lock);
 
     for(server_map_t::const_iterator it = _servers.begin();
         it != _servers.end(); ++it)
@@ -129,7 +193,7 @@ void server_pool::on_connect(const boost::system::error_code & ec,
     callback_list_t callbacks;
     address_t addr;
     {
-        spinlock::guard guard(_lock);
+        adaptive_lock::guard guard(_lock);
 
         // move list of callbacks into local variable,
         //   clearing the original
@@ -5,10 +5,12 @@
 #include "samoa/client/fwd.hpp"
 #include "samoa/core/fwd.hpp"
 #include "samoa/core/uuid.hpp"
-#include "samoa/spinlock.hpp"
+#include "samoa/adaptive_lock.hpp"
+#include <boost/random/mersenne_twister.hpp>
 #include <boost/unordered_map.hpp>
 #include <memory>
 #include <list>
+#include <vector>
 
 namespace samoa {
 namespace client {
@@ -37,6 +39,36 @@ public:
     /// Otherwise, returns a connected instance
     server::ptr_t get_server(const core::uuid &);
 
+    /// Local statistics of requests made to a server
+    struct server_stats
+    {
+        bool connected;
+
+        /// Requests scheduled or awaiting response
+        unsigned queue_size;
+
+        /// Moving average of request latency (zero if unsampled)
+        unsigned latency_us;
+        bool has_latency;
+    };
+
+    /// Precondition: has_server(uuid) is True
+    server_stats get_server_stats(const core::uuid &);
+
+    /// Precondition: has_server(uuid) is True
+    /// Estimates the wait (in microseconds) of a new request to
+    ///  the server, as its average latency scaled by queue depth.
+    ///  Servers without latency samples have no expected wait,
+    ///  while those not connected have the maximum.
+    unsigned get_server_load(const core::uuid &);
+
+    /// Precondition: candidates is non-empty, and has_server(uuid)
+    ///  is True of each candidate
+    /// Selects the less loaded of two candidates chosen at random
+    ///  ("power of two choices"), which avoids herding requests onto
+    ///  the single least-loaded server as its stats lag behind.
+    core::uuid select_server(const std::vector<core::uuid> & candidates);
+
     /// Precondition: has_server(uuid) is True
     std::string get_server_hostname(const core::uuid &);
 
@@ -63,7 +95,10 @@ private:
     void on_connect(const boost::system::error_code &,
         server::ptr_t, const core::uuid &);
 
-    spinlock _lock;
+    adaptive_lock _lock;
+
+    // guarded by _lock
+    boost::random::mt19937 _rng;
     
     typedef std::pair<std::string, unsigned short> address_t;
     typedef boost::unordered_map<core::uuid, address_t> address_map_t;
@@ -0,0 +1,72 @@
+#include "samoa/core/arena.hpp"
+#include "samoa/core/buffer_pool.hpp"
+#include <algorithm>
+
+namespace samoa {
+namespace core {
+
+// blocks drawn from buffer_pool are chained through a leading header
+struct arena::block_header
+{
+    block_header * next;
+    unsigned size_class;
+};
+
+arena::arena()
+ : _pos(reinterpret_cast<char*>(&_inline)),
+   _end(_pos + inline_size),
+   _blocks(0),
+   _block_count(0)
+{ }
+
+arena::~arena()
+{
+    release();
+}
+
+void * arena::allocate_block(size_t size)
+{
+    size_t header_size = align_size(sizeof(block_header));
+
+    size_t alloc_size = std::max(header_size + size,
+        buffer_pool::class_size(0));
+
+    unsigned size_class = buffer_pool::size_class_of(alloc_size);
+
+    if(size_class != buffer_pool::no_class)
+        alloc_size = buffer_pool::class_size(size_class);
+
+    block_header * block = reinterpret_cast<block_header*>(
+        buffer_pool::allocate(size_class, alloc_size));
+
+    block->next = _blocks;
+    block->size_class = size_class;
+
+    _blocks = block;
+    _block_count += 1;
+
+    // the remainder of the prior block is abandoned
+    char * ptr = reinterpret_cast<char*>(block) + header_size;
+
+    _pos = ptr + size;
+    _end = reinterpret_cast<char*>(block) + alloc_size;
+    return ptr;
+}
+
+void arena::release()
+{
+    while(_blocks)
+    {
+        block_header * next = _blocks->next;
+        buffer_pool::release(_blocks, _blocks->size_class);
+        _blocks = next;
+    }
+    _block_count = 0;
+
+    _pos = reinterpret_cast<char*>(&_inline);
+    _end = _pos + inline_size;
+}
+
+}
+}
+
@@ -0,0 +1,183 @@
+#ifndef SAMOA_CORE_ARENA_HPP
+#define SAMOA_CORE_ARENA_HPP
+
+#include "samoa/core/fwd.hpp"
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/noncopyable.hpp>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace samoa {
+namespace core {
+
+/*!
+ * Bump allocator for objects sharing a common lifetime (eg, of a request).
+ *
+ * Allocations are carved from an inline block, and then from blocks
+ *  drawn from buffer_pool as the inline block is exhausted. Individual
+ *  deallocations are no-ops (excepting the most recent allocation, which
+ *  is rolled back to permit in-place regrowth). Memory is instead
+ *  reclaimed all at once, by release() or on destruction.
+ *
+ * Not thread-safe.
+ */
+class arena :
+    private boost::noncopyable
+{
+public:
+
+    enum {
+        //! bytes allocated from the arena itself, before buffer_pool is used
+        inline_size = 512,
+
+        //! alignment of all returned allocations
+        alignment = 16
+    };
+
+    arena();
+
+    ~arena();
+
+    //! Returns size bytes, aligned to alignment
+    void * allocate(size_t size)
+    {
+        size = align_size(size);
+
+        if(size_t(_end - _pos) < size)
+            return allocate_block(size);
+
+        void * ptr = _pos;
+        _pos += size;
+        return ptr;
+    }
+
+    //! Rolls back ptr if it's the most recent allocation; otherwise a no-op
+    void deallocate(void * ptr, size_t size)
+    {
+        if(reinterpret_cast<char*>(ptr) + align_size(size) == _pos)
+            _pos = reinterpret_cast<char*>(ptr);
+    }
+
+    /*!
+     * Releases all allocations, returning drawn blocks to buffer_pool.
+     *
+     * It's an error to access memory allocated prior to release().
+     */
+    void release();
+
+    //! Count of blocks currently drawn from buffer_pool
+    size_t get_block_count() const
+    { return _block_count; }
+
+private:
+
+    struct block_header;
+
+    static size_t align_size(size_t size)
+    { return (size + alignment - 1) & ~size_t(alignment - 1); }
+
+    void * allocate_block(size_t size);
+
+    char * _pos;
+    char * _end;
+
+    block_header * _blocks;
+    size_t _block_count;
+
+    boost::aligned_storage<inline_size, alignment>::type _inline;
+};
+
+/*!
+ * Standard allocator drawing from a core::arena.
+ *
+ * A default-constructed arena_allocator (having no arena) uses the heap,
+ *  so that containers parameterized on arena_allocator remain usable
+ *  outside of an arena's scope.
+ */
+template<typename T>
+class arena_allocator
+{
+public:
+
+    typedef T value_type;
+    typedef T * pointer;
+    typedef const T * const_pointer;
+    typedef T & reference;
+    typedef const T & const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind
+    { typedef arena_allocator<U> other; };
+
+    arena_allocator()
+     : _arena(0)
+    { }
+
+    explicit arena_allocator(arena & arena)
+     : _arena(&arena)
+    { }
+
+    template<typename U>
+    arena_allocator(const arena_allocator<U> & other)
+     : _arena(other.get_arena())
+    { }
+
+    pointer address(reference value) const
+    { return &value; }
+
+    const_pointer address(const_reference value) const
+    { return &value; }
+
+    pointer allocate(size_type count, const void * = 0)
+    {
+        if(!_arena)
+            return static_cast<pointer>(::operator new(count * sizeof(T)));
+
+        return static_cast<pointer>(_arena->allocate(count * sizeof(T)));
+    }
+
+    void deallocate(pointer ptr, size_type count)
+    {
+        if(!_arena)
+            ::operator delete(ptr);
+        else
+            _arena->deallocate(ptr, count * sizeof(T));
+    }
+
+    size_type max_size() const
+    { return size_type(-1) / sizeof(T); }
+
+    template<typename U, typename ... Args>
+    void construct(U * ptr, Args && ... args)
+    { ::new((void*) ptr) U(std::forward<Args>(args)...); }
+
+    template<typename U>
+    void destroy(U * ptr)
+    { ptr->~U(); }
+
+    arena * get_arena() const
+    { return _arena; }
+
+private:
+
+    arena * _arena;
+};
+
+template<typename T, typename U>
+bool operator == (const arena_allocator<T> & lhs,
+    const arena_allocator<U> & rhs)
+{ return lhs.get_arena() == rhs.get_arena(); }
+
+template<typename T, typename U>
+bool operator != (const arena_allocator<T> & lhs,
+    const arena_allocator<U> & rhs)
+{ return lhs.get_arena() != rhs.get_arena(); }
+
+}
+}
+
+#endif
+
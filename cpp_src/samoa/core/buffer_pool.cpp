@@ -0,0 +1,212 @@
+#include "samoa/core/buffer_pool.hpp"
+#include "samoa/spinlock.hpp"
+#include "samoa/error.hpp"
+#include <boost/detail/atomic_count.hpp>
+#include <boost/thread/tss.hpp>
+#include <algorithm>
+
+namespace samoa {
+namespace core {
+
+// released blocks are chained through their first word
+struct free_block
+{
+    free_block * next;
+};
+
+struct free_list
+{
+    free_list()
+     : head(0), count(0)
+    { }
+
+    void push(free_block * block)
+    {
+        block->next = head;
+        head = block;
+        count += 1;
+    }
+
+    free_block * pop()
+    {
+        free_block * block = head;
+        head = block->next;
+        count -= 1;
+        return block;
+    }
+
+    free_block * head;
+    size_t count;
+};
+
+// bytes of each size class which a thread may cache
+const size_t thread_cache_size = 1 << 20;
+
+// bytes of each size class which the central reclaim list may hold
+const size_t central_cache_size = 1 << 24;
+
+static size_t thread_cache_capacity(unsigned size_class)
+{
+    size_t capacity = thread_cache_size / buffer_pool::class_size(size_class);
+    return capacity < 2 ? 2 : capacity;
+}
+
+static size_t central_capacity(unsigned size_class)
+{
+    return central_cache_size / buffer_pool::class_size(size_class);
+}
+
+struct central_list
+{
+    spinlock lock;
+    free_list blocks;
+};
+
+static central_list _central[buffer_pool::class_count];
+
+static boost::detail::atomic_count _allocation_count(0);
+static boost::detail::atomic_count _heap_allocation_count(0);
+
+static void delete_block(free_block * block)
+{
+    delete [] reinterpret_cast<char*>(block);
+}
+
+// moves up to count blocks from one list to another
+static void transfer(free_list & from, free_list & to, size_t count)
+{
+    while(count-- && from.head)
+    {
+        to.push(from.pop());
+    }
+}
+
+struct thread_cache
+{
+    ~thread_cache()
+    {
+        // return cached blocks to central reclaim lists
+        for(unsigned i = 0; i != buffer_pool::class_count; ++i)
+        {
+            spinlock::guard guard(_central[i].lock);
+
+            transfer(lists[i], _central[i].blocks,
+                central_capacity(i) - std::min(central_capacity(i),
+                    _central[i].blocks.count));
+
+            while(lists[i].head)
+                delete_block(lists[i].pop());
+        }
+    }
+
+    free_list lists[buffer_pool::class_count];
+};
+
+static boost::thread_specific_ptr<thread_cache> _thread_cache;
+
+static thread_cache & get_thread_cache()
+{
+    thread_cache * cache = _thread_cache.get();
+    if(!cache)
+    {
+        cache = new thread_cache();
+        _thread_cache.reset(cache);
+    }
+    return *cache;
+}
+
+unsigned buffer_pool::size_class_of(size_t allocation_size)
+{
+    unsigned size_class = 0;
+    while(size_class != class_count && class_size(size_class) < allocation_size)
+    {
+        size_class += 1;
+    }
+    return size_class;
+}
+
+void * buffer_pool::allocate(unsigned size_class, size_t allocation_size)
+{
+    ++_allocation_count;
+
+    if(size_class == no_class)
+    {
+        ++_heap_allocation_count;
+        return new char[allocation_size];
+    }
+
+    SAMOA_ASSERT(size_class < class_count && \
+        allocation_size <= class_size(size_class));
+
+    free_list & local = get_thread_cache().lists[size_class];
+
+    if(!local.head)
+    {
+        // refill half of the thread cache from the central list
+        spinlock::guard guard(_central[size_class].lock);
+
+        transfer(_central[size_class].blocks, local,
+            thread_cache_capacity(size_class) / 2);
+    }
+
+    if(local.head)
+    {
+        return local.pop();
+    }
+
+    ++_heap_allocation_count;
+    return new char[class_size(size_class)];
+}
+
+void buffer_pool::release(void * block, unsigned size_class)
+{
+    if(size_class == no_class)
+    {
+        delete [] reinterpret_cast<char*>(block);
+        return;
+    }
+
+    free_list & local = get_thread_cache().lists[size_class];
+    local.push(reinterpret_cast<free_block*>(block));
+
+    if(local.count > thread_cache_capacity(size_class))
+    {
+        // spill half of the thread cache to the central list
+        free_list spilled;
+        transfer(local, spilled, local.count / 2);
+
+        {
+            spinlock::guard guard(_central[size_class].lock);
+
+            size_t room = central_capacity(size_class) - std::min(
+                central_capacity(size_class), _central[size_class].blocks.count);
+
+            transfer(spilled, _central[size_class].blocks, room);
+        }
+
+        // central list is full; return remaining blocks to the heap
+        while(spilled.head)
+            delete_block(spilled.pop());
+    }
+}
+
+uint64_t buffer_pool::allocation_count()
+{ return _allocation_count; }
+
+uint64_t buffer_pool::heap_allocation_count()
+{ return _heap_allocation_count; }
+
+size_t buffer_pool::reclaimed_size()
+{
+    size_t result = 0;
+    for(unsigned i = 0; i != class_count; ++i)
+    {
+        spinlock::guard guard(_central[i].lock);
+        result += _central[i].blocks.count * class_size(i);
+    }
+    return result;
+}
+
+}
+}
+
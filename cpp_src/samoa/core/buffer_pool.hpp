@@ -0,0 +1,68 @@
+#ifndef SAMOA_CORE_BUFFER_POOL_HPP
+#define SAMOA_CORE_BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace samoa {
+namespace core {
+
+/*!
+ * Size-classed allocator of the raw memory underlying ref_buffers.
+ *
+ * Allocations are rounded up to power-of-two size classes, from 4 KiB
+ *  through 1 MiB. Released blocks are first cached by the releasing
+ *  thread, and are moved in batches to & from a central reclaim list
+ *  (per size class) as thread caches overflow and run dry. Thus the
+ *  common case of acquiring & releasing buffers requires no locking,
+ *  and no calls to the heap.
+ *
+ * Allocations larger than the largest size class go directly to the heap.
+ */
+class buffer_pool
+{
+public:
+
+    enum {
+        min_class_bits = 12,
+        max_class_bits = 20,
+
+        class_count = max_class_bits - min_class_bits + 1,
+
+        //! size class of allocations which are not pooled
+        no_class = class_count
+    };
+
+    //! Size class which can hold allocation_size bytes, or no_class
+    static unsigned size_class_of(size_t allocation_size);
+
+    //! Allocation size of a size class
+    static size_t class_size(unsigned size_class)
+    { return size_t(1) << (min_class_bits + size_class); }
+
+    /*!
+     * Allocates a block of class_size(size_class) bytes, or of
+     *  allocation_size bytes if size_class is no_class
+     */
+    static void * allocate(unsigned size_class, size_t allocation_size);
+
+    //! Releases a block returned by allocate()
+    static void release(void * block, unsigned size_class);
+
+    // metrics
+
+    //! Total count of blocks allocated from the pool
+    static uint64_t allocation_count();
+
+    //! Count of allocations which required a call to the heap
+    static uint64_t heap_allocation_count();
+
+    //! Bytes of released blocks held by central reclaim lists
+    static size_t reclaimed_size();
+};
+
+}
+}
+
+#endif
+
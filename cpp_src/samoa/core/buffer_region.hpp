@@ -4,6 +4,7 @@
 
 #include "samoa/core/ref_buffer.hpp"
 #include <boost/asio.hpp>
+#include <algorithm>
 
 namespace samoa {
 namespace core {
@@ -114,6 +115,20 @@ typedef boost::asio::buffers_iterator<buffer_regions_t
 typedef boost::asio::buffers_iterator<const_buffer_regions_t
     > const_buffers_iterator_t;
 
+/*!
+ * Copies the content of regions to out, a region at a time
+ *  (rather than a byte at a time, as with buffers_iterator_t)
+ */
+template<typename BufferRegions>
+char * copy_regions(const BufferRegions & regions, char * out)
+{
+    for(auto it = regions.begin(); it != regions.end(); ++it)
+    {
+        out = std::copy(it->begin(), it->end(), out);
+    }
+    return out;
+}
+
 
 class buffer_ring
 {
@@ -191,8 +206,10 @@ public:
     {
         while(_w_avail < write_size)
         {
-            _buffers.push_back( ref_buffer::aquire_ref_buffer(2));
-            //_buffers.push_back( ref_buffer::aquire_ref_buffer(4064));
+            // buffers are drawn from buffer_pool, and are rounded
+            //  up to fill a complete size class
+            _buffers.push_back(
+                ref_buffer::aquire_ref_buffer(write_size - _w_avail));
             _w_avail += _buffers.back()->size();
         }
         return;
@@ -13,7 +13,18 @@ class proactor;
 typedef boost::shared_ptr<proactor> proactor_ptr_t;
 
 typedef boost::shared_ptr<boost::asio::io_service> io_service_ptr_t;
-typedef boost::shared_ptr<boost::asio::deadline_timer> timer_ptr_t;
+
+class timer_wheel;
+typedef boost::shared_ptr<timer_wheel> timer_wheel_ptr_t;
+
+class wheel_timer;
+typedef boost::shared_ptr<wheel_timer> timer_ptr_t;
+
+class work_stealing_executor;
+typedef boost::shared_ptr<work_stealing_executor> work_stealing_executor_ptr_t;
+
+class arena;
+template<typename T> class arena_allocator;
 
 class tasklet_base;
 typedef boost::shared_ptr<tasklet_base> tasklet_base_ptr_t;
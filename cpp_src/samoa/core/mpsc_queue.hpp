@@ -0,0 +1,108 @@
+#ifndef SAMOA_CORE_MPSC_QUEUE_HPP
+#define SAMOA_CORE_MPSC_QUEUE_HPP
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/thread.hpp>
+#include <utility>
+
+namespace samoa {
+namespace core {
+
+/*
+ * Unbounded, lock-free multiple-producer / single-consumer queue.
+ *
+ * push() may be called from any thread, & is wait-free. try_pop() &
+ *  pop() must be called by at most one thread at a time (though
+ *  which thread is the consumer may change, given external hand-off
+ *  of the consumer role; see server::client response scheduling).
+ *
+ * try_pop() may spuriously fail while a concurrent push() is between
+ *  claiming the queue head & linking its element. pop() spins
+ *  through such windows, & is for use when an element is known to
+ *  have been pushed (eg, tracked by an external atomic count).
+ */
+template<typename T>
+class mpsc_queue :
+    private boost::noncopyable
+{
+public:
+
+    mpsc_queue()
+     : _head(new node()),
+       _tail(_head)
+    { }
+
+    ~mpsc_queue()
+    {
+        while(_tail)
+        {
+            node * next = _tail->next;
+            delete _tail;
+            _tail = next;
+        }
+    }
+
+    void push(const T & value)
+    {
+        node * n = new node(value);
+
+        // publish n's contents before it's reachable by the consumer
+        __sync_synchronize();
+
+        node * prev = __sync_lock_test_and_set(&_head, n);
+        prev->next = n;
+    }
+
+    bool try_pop(T & value)
+    {
+        node * tail = _tail;
+        node * next = tail->next;
+
+        if(!next)
+            return false;
+
+        __sync_synchronize();
+
+        // next becomes the new sentinel
+        value = std::move(next->value);
+        next->value = T();
+
+        _tail = next;
+        delete tail;
+        return true;
+    }
+
+    void pop(T & value)
+    {
+        while(!try_pop(value))
+            boost::this_thread::yield();
+    }
+
+private:
+
+    struct node
+    {
+        node()
+         : next(0)
+        { }
+
+        explicit node(const T & v)
+         : next(0), value(v)
+        { }
+
+        node * volatile next;
+        T value;
+    };
+
+    // most-recently pushed node; written by producers
+    node * volatile _head;
+
+    // sentinel preceding the oldest node; owned by the consumer
+    node * _tail;
+};
+
+}
+}
+
+#endif
+
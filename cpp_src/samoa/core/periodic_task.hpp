@@ -3,6 +3,7 @@
 
 #include "samoa/core/fwd.hpp"
 #include "samoa/core/tasklet.hpp"
+#include "samoa/core/timer_wheel.hpp"
 #include <boost/asio.hpp>
 
 namespace samoa {
@@ -38,10 +39,10 @@ private:
     void run_tasklet();
     void halt_tasklet();
 
-    static void on_period(const boost::system::error_code &,
+    static void on_period(
         const typename core::tasklet<Derived>::weak_ptr_t &);
 
-    boost::asio::deadline_timer _timer;
+    core::wheel_timer _timer;
     bool _halted;
 };
 
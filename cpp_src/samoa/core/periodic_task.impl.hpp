@@ -9,7 +9,7 @@ namespace core {
 template<typename Derived>
 periodic_task<Derived>::periodic_task()
  : core::tasklet<Derived>(core::proactor::get_proactor()->serial_io_service()),
-   _timer(*core::tasklet<Derived>::get_io_service()),
+   _timer(core::tasklet<Derived>::get_io_service()),
    _halted(false)
 { }
 
@@ -20,19 +20,18 @@ void periodic_task<Derived>::next_cycle(
     if(!_halted)
     {
         // reset timer with new interval
-        _timer.expires_from_now(interval_delay);
-        _timer.async_wait(
-            boost::bind(&periodic_task<Derived>::on_period, _1,
+        _timer.schedule(
+            boost::bind(&periodic_task<Derived>::on_period,
                 typename periodic_task<Derived>::weak_ptr_t(
-                    core::tasklet<Derived>::shared_from_this())));
+                    core::tasklet<Derived>::shared_from_this())),
+            interval_delay.total_milliseconds());
     }
 }
 
 template<typename Derived>
 void periodic_task<Derived>::run_tasklet()
 {
-    on_period(boost::system::error_code(),
-        core::tasklet<Derived>::shared_from_this());
+    on_period(core::tasklet<Derived>::shared_from_this());
 }
 
 template<typename Derived>
@@ -44,15 +43,9 @@ void periodic_task<Derived>::halt_tasklet()
 }
 
 template<typename Derived>
-void periodic_task<Derived>::on_period(const boost::system::error_code & ec,
+void periodic_task<Derived>::on_period(
     const typename core::tasklet<Derived>::weak_ptr_t & weak_p)
 {
-    if(ec)
-    {
-        // timer cancelled
-        return;
-    }
-
     typename core::tasklet<Derived>::ptr_t task = weak_p.lock();
     if(!task || task->_halted)
     {
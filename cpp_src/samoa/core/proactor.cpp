@@ -1,8 +1,12 @@
 
 #include "samoa/core/proactor.hpp"
+#include "samoa/core/work_stealing_executor.hpp"
+#include "samoa/core/timer_wheel.hpp"
 #include "samoa/error.hpp"
 #include "samoa/log.hpp"
 #include <boost/bind.hpp>
+#include <pthread.h>
+#include <sched.h>
 
 namespace samoa {
 namespace core {
@@ -12,47 +16,59 @@ void null_cleanup(boost::asio::io_service *){}
 
 // static initialization
 boost::weak_ptr<proactor> proactor::_class_instance;
-spinlock proactor::_class_lock;
+adaptive_lock proactor::_class_lock;
 
 // boost::asio uses RTTI to establish a common registry of services,
 //  however RTTI doesn't work well across shared library boundaries.
 //  placing the ctor here guarantees that the member _io_services is
 //  constructed in the context of libsamoa
 proactor::proactor()
- : _next_serial_service(0),
+ : _serial_io_service_count(0),
+   _next_serial_service(0),
    _concurrent_thread_count(0),
    _io_srv(&null_cleanup)
 {
     LOG_DBG("called");
+
+    // the executor is owned by, and doesn't outlive, this proactor
+    _concurrent_executor.reset(new work_stealing_executor(
+        boost::bind(&proactor::post_to_serial_io_service, this, _1)));
 }
 
 proactor::~proactor()
 {
     LOG_DBG("called");
+
+    // workers hold only the executor; release them
+    _concurrent_executor->stop();
 }
 
 void proactor::declare_serial_io_service()
 {
-    spinlock::guard guard(_class_lock);
+    adaptive_lock::guard guard(_class_lock);
 
     SAMOA_ASSERT(!_io_srv.get() && "this thread has already declared");
 
     LOG_DBG("serial service declared");
 
+    size_t index = _serial_io_service_count;
+    SAMOA_ASSERT(index < max_serial_io_services);
+
     // create a new io-service to run
-    _serial_io_services.push_back(
-        io_service_ptr_t(new boost::asio::io_service()));
+    _serial_io_services[index].reset(new boost::asio::io_service());
+    _io_srv.reset(_serial_io_services[index].get());
 
-    _io_srv.reset(_serial_io_services.back().get());
+    // publish (increment is a full barrier)
+    ++_serial_io_service_count;
 }
 
 void proactor::declare_concurrent_io_service()
 {
-    spinlock::guard guard(_class_lock);
+    adaptive_lock::guard guard(_class_lock);
 
     SAMOA_ASSERT(!_io_srv.get() && "this thread has already declared");
 
-    SAMOA_ASSERT(!_serial_io_services.empty());
+    SAMOA_ASSERT(_serial_io_service_count);
 
     LOG_DBG("concurrent service declared");
 
@@ -64,19 +80,49 @@ void proactor::declare_concurrent_io_service()
     _io_srv.reset(_threaded_io_service.get());
 }
 
-io_service_ptr_t proactor::serial_io_service()
+void proactor::declare_pinned_serial_io_service(unsigned cpu)
+{
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+
+    SAMOA_ASSERT_ERRNO(pthread_setaffinity_np(
+        pthread_self(), sizeof(cpu_set), &cpu_set));
+
+    LOG_INFO("thread pinned to cpu " << cpu);
+
+    declare_serial_io_service();
+}
+
+io_service_ptr_t proactor::get_declared_serial_io_service()
 {
-    spinlock::guard guard(_class_lock);
+    size_t count = _serial_io_service_count;
 
-    SAMOA_ASSERT(!_serial_io_services.empty());
+    for(size_t i = 0; i != count; ++i)
+    {
+        if(_serial_io_services[i].get() == _io_srv.get())
+            return _serial_io_services[i];
+    }
+    return io_service_ptr_t();
+}
 
-    io_service_ptr_t io_srv = _serial_io_services.at(_next_serial_service); 
+std::vector<io_service_ptr_t> proactor::get_serial_io_services()
+{
+    size_t count = _serial_io_service_count;
+
+    return std::vector<io_service_ptr_t>(
+        _serial_io_services, _serial_io_services + count);
+}
+
+io_service_ptr_t proactor::serial_io_service()
+{
+    size_t count = _serial_io_service_count;
+    SAMOA_ASSERT(count);
 
-    // round-robin increment 
-    _next_serial_service = \
-        (_next_serial_service + 1) % _serial_io_services.size();
+    // round-robin, without taking _class_lock
+    size_t index = size_t(++_next_serial_service - 1) % count;
 
-    return io_srv;
+    return _serial_io_services[index];
 }
 
 io_service_ptr_t proactor::concurrent_io_service()
@@ -95,45 +141,71 @@ io_service_ptr_t proactor::concurrent_io_service()
     return result;
 }
 
+void proactor::run_concurrent_executor()
+{
+    LOG_DBG("concurrent executor worker starting");
+
+    _concurrent_executor->run();
+
+    LOG_DBG("concurrent executor worker stopped");
+}
+
+void proactor::post_to_serial_io_service(
+    const boost::function<void()> & handler)
+{
+    serial_io_service()->post(handler);
+}
+
+timer_wheel_ptr_t proactor::get_timer_wheel(
+    const io_service_ptr_t & io_srv)
+{
+    adaptive_lock::guard guard(_class_lock);
+
+    for(size_t i = 0; i != _timer_wheels.size(); ++i)
+    {
+        if(_timer_wheels[i]->get_io_service() == io_srv)
+            return _timer_wheels[i];
+    }
+
+    _timer_wheels.push_back(boost::make_shared<timer_wheel>(io_srv));
+    return _timer_wheels.back();
+}
+
 // helper for proactor::run_later callback dispatch
-void on_run_later(const boost::system::error_code & ec,
-    const proactor::run_later_callback_t & callback,
+void on_run_later(const proactor::run_later_callback_t & callback,
     const io_service_ptr_t & io_srv,
     const timer_ptr_t &)
 {
-    // if cancelled
-    if(ec)
-    { return; }
-
     callback(io_srv);
 }
 
-// deadline_timer doesn't work across shared-library boundaries,
-//  so it's use needs to be encapsulated into libsamoa.
 timer_ptr_t proactor::run_later(const run_later_callback_t & callback,
     unsigned delay_ms)
 {
     io_service_ptr_t io_srv = serial_io_service();
 
-    timer_ptr_t timer = boost::make_shared<boost::asio::deadline_timer>(*io_srv);
-    timer->expires_from_now(boost::posix_time::milliseconds(delay_ms));
+    timer_ptr_t timer = boost::make_shared<wheel_timer>(
+        get_timer_wheel(io_srv));
 
-    // timer reference count is passed to boost::bind callback argument
-    timer->async_wait(boost::bind(&on_run_later,
-        _1, callback, io_srv, timer));
+    // timer reference count is passed to boost::bind callback argument,
+    //  and is released when the callback is invoked or cancelled
+    timer->schedule(boost::bind(&on_run_later,
+        callback, io_srv, timer), delay_ms);
 
     return timer;
 }
 
 void proactor::shutdown()
 {
-    spinlock::guard guard(_class_lock);
+    adaptive_lock::guard guard(_class_lock);
 
-    for(size_t i = 0; i != _serial_io_services.size(); ++i)
+    for(size_t i = 0; i != size_t(_serial_io_service_count); ++i)
         _serial_io_services[i]->stop();
 
     if(_threaded_io_service)
         _threaded_io_service->stop();
+
+    _concurrent_executor->stop();
 }
 
 }
@@ -2,7 +2,8 @@
 #define SAMOA_CORE_PROACTOR_HPP
 
 #include "samoa/core/fwd.hpp"
-#include "samoa/spinlock.hpp"
+#include "samoa/adaptive_lock.hpp"
+#include <boost/detail/atomic_count.hpp>
 #include <boost/asio.hpp>
 #include <boost/function.hpp>
 #include <boost/thread/tss.hpp>
@@ -34,7 +35,7 @@ public:
     {
         ptr_t result;
         {
-            spinlock::guard guard(_class_lock);
+            adaptive_lock::guard guard(_class_lock);
 
             result = _class_instance.lock();
 
@@ -62,6 +63,23 @@ public:
     */
     void declare_concurrent_io_service();
 
+    /*!
+    *  Pins this thread to the given CPU, and declares that it will run
+    *    a serial io-service event loop.
+    *
+    *  Running one pinned serial io-service per core, and serving each
+    *    connection entirely on the io-service which accepted it (see
+    *    server::listener), gives a shared-nothing, thread-per-core
+    *    server where requests never hop threads.
+    */
+    void declare_pinned_serial_io_service(unsigned cpu);
+
+    /*!
+    *  Returns the serial io-service declared on this thread, or an
+    *    empty pointer if this thread hasn't declared one.
+    */
+    io_service_ptr_t get_declared_serial_io_service();
+
     /*!
     *  Returns the io-service declared on this thread
     */
@@ -80,6 +98,9 @@ public:
     */
     io_service_ptr_t serial_io_service();
 
+    //! Returns all serial io-services, in order of declaration
+    std::vector<io_service_ptr_t> get_serial_io_services();
+
     /*!
     *  Selects a multi-threaded io_service. If no multi-threaded io_service
     *    is available, a single-threaded service is returned.
@@ -89,16 +110,36 @@ public:
     */
     io_service_ptr_t concurrent_io_service();
 
+    /*!
+    *  Returns the work-stealing executor for blocking handlers.
+    *
+    *  Unlike the threaded io_service, executor workers don't contend
+    *    on a single shared queue (see work_stealing_executor). If no
+    *    thread has entered run_concurrent_executor(), handlers are
+    *    posted to a serial io-service.
+    */
+    const work_stealing_executor_ptr_t & concurrent_executor()
+    { return _concurrent_executor; }
+
+    /*!
+    *  Runs the calling thread as a concurrent executor worker,
+    *    returning only after shutdown() or destruction of the proactor
+    */
+    void run_concurrent_executor();
+
+    /*!
+    *  Returns the timer_wheel of the io_service, creating it if required
+    */
+    timer_wheel_ptr_t get_timer_wheel(const io_service_ptr_t &);
+
     /*!
     *  Schedules a callable to be invoked at a future time on a serial
     *   io-service.
     *
+    *  The returned timer may be cancel()'d to abandon the invocation.
+    *
     *  TODO(johng): Iff delay_ms = 0, the callable will be immediately
     *   posted to the io-service.
-    *
-    *  TODO(johng): boost::asio::deadline_timer doesn't work across shared-library
-    *   boundaries, so it's use has been encapsulated within libsamoa. according
-    *   to docs, shared-libraries shouldn't be a problem-- this needs another pass
     */
     timer_ptr_t run_later(const run_later_callback_t &, unsigned delay_ms);
 
@@ -108,15 +149,29 @@ private:
 
     proactor();
 
+    void post_to_serial_io_service(const boost::function<void()> &);
+
     static boost::weak_ptr<proactor> _class_instance;
-    static spinlock _class_lock;
+    static adaptive_lock _class_lock;
 
-    std::vector<io_service_ptr_t> _serial_io_services;
-    unsigned _next_serial_service;
+    enum {
+        max_serial_io_services = 256
+    };
+
+    // slots are written once (under _class_lock) before being
+    //  published by _serial_io_service_count, and so may be read
+    //  without the lock
+    io_service_ptr_t _serial_io_services[max_serial_io_services];
+    boost::detail::atomic_count _serial_io_service_count;
+    boost::detail::atomic_count _next_serial_service;
 
     io_service_ptr_t _threaded_io_service;
     unsigned _concurrent_thread_count;
 
+    work_stealing_executor_ptr_t _concurrent_executor;
+
+    std::vector<timer_wheel_ptr_t> _timer_wheels;
+
     boost::thread_specific_ptr<boost::asio::io_service> _io_srv;
 };
 
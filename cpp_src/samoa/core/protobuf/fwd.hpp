@@ -10,6 +10,8 @@ namespace protobuf {
 class PersistedRecord;
 //typedef boost::shared_ptr<PersistedRecord> PersistedRecord_ptr_t;
 
+class SamoaRequest;
+
 }
 }
 }
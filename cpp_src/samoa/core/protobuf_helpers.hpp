@@ -3,37 +3,60 @@
 
 #include "samoa/core/ref_buffer.hpp"
 #include "samoa/core/buffer_region.hpp"
+#include "samoa/core/streaming_copy.hpp"
+#include "samoa/error.hpp"
 #include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/message_lite.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cstring>
 
 namespace samoa {
 namespace core {
 
-// TODO find a common location for this
-#define ALLOC_BUF_SIZE 10
+// smallest buffer_pool size class, less ref_buffer overhead
+#define ALLOC_BUF_SIZE 4000
 
+// output adapter buffers grow geometrically, to at most this size
+#define MAX_ALLOC_BUF_SIZE (1 << 16)
+
+/*!
+ * Output adapter which serializes into pooled ref_buffers.
+ *
+ * Buffers begin at ALLOC_BUF_SIZE & double in size with each further
+ *  buffer required, up to MAX_ALLOC_BUF_SIZE. Space remaining in a
+ *  buffer after BackUp() is used by subsequent writes, and contiguous
+ *  writes to a buffer are output as a single region.
+ *
+ * serialize() pre-sizes from the message's ByteSize(), such that
+ *  the message is written as one contiguous region.
+ */
 class zero_copy_output_adapter :
     public google::protobuf::io::ZeroCopyOutputStream
 {
 public:
 
     zero_copy_output_adapter()
-      : _count(0)
+      : _count(0),
+        _next_size(ALLOC_BUF_SIZE),
+        _region_begin(0),
+        _active_pos(0)
     { }
 
     // ZeroCopyOutputStream virtual
     bool Next(void ** data, int * size)
     {
-        if(_active_buf)
+        if(!_active_buf || _active_pos == _active_buf->size())
         {
-            _buf_regions.push_back(const_buffer_region(
-                _active_buf, 0, _active_buf->size()));
+            next_buffer(_next_size);
         }
-        _active_buf = ref_buffer::aquire_ref_buffer(ALLOC_BUF_SIZE);
-        _count += _active_buf->size();
 
-        // return to protobuf
-        *data = _active_buf->data();
-        *size = _active_buf->size();
+        // return remainder of the active buffer to protobuf
+        *data = _active_buf->data() + _active_pos;
+        *size = _active_buf->size() - _active_pos;
+
+        _active_pos = _active_buf->size();
+        _count += *size;
         return true;
     }
 
@@ -45,40 +68,90 @@ public:
             throw std::runtime_error("zero_copy_output_adapter::BackUp() "
                 "No current buffer to back up");
         }
-        if(_active_buf->size() < (unsigned)count)
+        if(_active_pos - _region_begin < (unsigned)count)
         {
             throw std::runtime_error("zero_copy_output_adapter::BackUp() "
                 "Rewind beyond beginning of buffer");
         }
 
+        _active_pos -= count;
         _count -= count;
-        _buf_regions.push_back(const_buffer_region(
-            _active_buf, 0, _active_buf->size() - count));
-        _active_buf.reset();
-        return;
     }
 
     // ZeroCopyOutputStream virtual
     google::protobuf::int64 ByteCount() const
     { return _count; }
 
-    const_buffer_regions_t & output_regions()
+    /*!
+     * Ensures at least size bytes may be written contiguously
+     *  by the next call to Next()
+     */
+    void reserve(size_t size)
     {
-        if(_active_buf)
+        if(!_active_buf || _active_buf->size() - _active_pos < size)
         {
-            // 'flush' remaining active buffer; required
-            //   only if BackUp() didn't get called
-            _buf_regions.push_back(const_buffer_region(
-                _active_buf, 0, _active_buf->size()));
-            _active_buf.reset();
+            next_buffer(size);
         }
+    }
+
+    /*!
+     * Serializes message as a single contiguous region.
+     *
+     * As with (non-debug) SerializeToZeroCopyStream(), missing
+     *  required fields aren't checked.
+     */
+    void serialize(const google::protobuf::MessageLite & message)
+    {
+        size_t size = message.ByteSize();
+        reserve(size);
+
+        google::protobuf::uint8 * begin = reinterpret_cast<
+            google::protobuf::uint8*>(_active_buf->data() + _active_pos);
+
+        SAMOA_ASSERT(message.SerializeWithCachedSizesToArray(begin) == \
+            begin + size);
+
+        _active_pos += size;
+        _count += size;
+    }
+
+    const_buffer_regions_t & output_regions()
+    {
+        flush_region();
         return _buf_regions;
     }
 
 private:
 
+    // outputs written content of the active buffer, not yet output
+    void flush_region()
+    {
+        if(_active_pos != _region_begin)
+        {
+            _buf_regions.push_back(const_buffer_region(
+                _active_buf, _region_begin, _active_pos));
+        }
+        _region_begin = _active_pos;
+    }
+
+    void next_buffer(size_t size)
+    {
+        flush_region();
+
+        _active_buf = ref_buffer::aquire_ref_buffer(size);
+        _region_begin = _active_pos = 0;
+
+        _next_size = std::min<size_t>(
+            _active_buf->size() * 2, MAX_ALLOC_BUF_SIZE);
+    }
+
     unsigned _count;
+    size_t _next_size;
+
     ref_buffer::ptr_t _active_buf;
+    size_t _region_begin;
+    size_t _active_pos;
+
     const_buffer_regions_t _buf_regions;
 };
 
@@ -162,6 +235,182 @@ private:
     const buffer_regions_t * _buffers;
 };
 
+
+// messages spanning regions, of at most this size, are
+//  coalesced into a stack buffer for parsing
+#define PARSE_SCRATCH_SIZE 4096
+
+/*!
+ * Parses message from regions.
+ *
+ * The common case of a message held by a single region is parsed
+ *  directly from that region. Small messages spanning regions are
+ *  first coalesced into scratch space, and only larger messages are
+ *  parsed through a zero_copy_input_adapter.
+ */
+inline bool parse_from_regions(google::protobuf::MessageLite & message,
+    const buffer_regions_t & regions)
+{
+    if(regions.size() == 1)
+    {
+        return message.ParseFromArray(
+            regions[0].begin(), regions[0].size());
+    }
+
+    size_t size = 0;
+    for(auto it = regions.begin(); it != regions.end(); ++it)
+        size += it->size();
+
+    if(size <= PARSE_SCRATCH_SIZE)
+    {
+        char scratch[PARSE_SCRATCH_SIZE];
+        copy_regions(regions, scratch);
+
+        return message.ParseFromArray(scratch, size);
+    }
+
+    zero_copy_input_adapter zci_adapter(regions);
+    return message.ParseFromZeroCopyStream(&zci_adapter);
+}
+
+/*!
+ * Output adapter which serializes into a fixed, pre-sized output range
+ *  through a small cache-resident bounce buffer. Each filled bounce
+ *  buffer is moved to the output range with core::streaming_copy(),
+ *  so only the bounce buffer (and not the complete message) is pulled
+ *  through the CPU cache.
+ *
+ * flush() must be called once serialization is complete (eg, after any
+ *  wrapping CodedOutputStream has been destroyed).
+ */
+class streaming_output_adapter :
+    public google::protobuf::io::ZeroCopyOutputStream
+{
+public:
+
+    streaming_output_adapter(char * out, size_t capacity)
+     : _out(out),
+       _out_end(out + capacity),
+       _pending(0),
+       _count(0)
+    { }
+
+    // ZeroCopyOutputStream virtual
+    bool Next(void ** data, int * size)
+    {
+        flush();
+
+        if(_out == _out_end)
+            return false;
+
+        _pending = std::min(sizeof(_buffer), (size_t)(_out_end - _out));
+        _count += _pending;
+
+        // return to protobuf
+        *data = _buffer;
+        *size = _pending;
+        return true;
+    }
+
+    // ZeroCopyOutputStream virtual
+    void BackUp(int count)
+    {
+        if(_pending < (unsigned)count)
+        {
+            throw std::runtime_error("streaming_output_adapter::BackUp() "
+                "Rewind beyond beginning of buffer");
+        }
+        _pending -= count;
+        _count -= count;
+    }
+
+    // ZeroCopyOutputStream virtual
+    google::protobuf::int64 ByteCount() const
+    { return _count; }
+
+    /// Writes pending bounce-buffer content to the output range
+    void flush()
+    {
+        streaming_copy(_buffer, _buffer + _pending, _out);
+        _out += _pending;
+        _pending = 0;
+    }
+
+private:
+
+    char * _out;
+    char * const _out_end;
+
+    unsigned _pending;
+    unsigned _count;
+
+    char _buffer[4096] __attribute__((__aligned__(16)));
+};
+
+// wire protocol version implemented by this build. Version 2 adds
+//  extended frames, having a 32-bit message length
+#define SAMOA_PROTOCOL_VERSION 2
+
+// 16-bit message length which is followed by a 32-bit extended length.
+//  As this is also a legal version 1 length, it marks an extended frame
+//  only once the peer has advertised version 2 (see is_extended_frame())
+#define EXTENDED_FRAME_MARKER 0xffff
+
+// bound on the message length of an extended frame
+#define MAX_EXTENDED_FRAME_LENGTH (1 << 26)
+
+// maximum bytes of a frame length preamble
+#define MAX_FRAME_PREAMBLE_SIZE 6
+
+/*!
+ * Whether a peer of protocol_version may accept a message of length bytes.
+ *
+ * Version 1 frames are capped below EXTENDED_FRAME_MARKER, so that the
+ *  marker is never ambiguous to a peer which reads extended frames.
+ */
+inline bool frame_length_supported(size_t length, unsigned protocol_version)
+{
+    if(length < EXTENDED_FRAME_MARKER)
+        return true;
+
+    return protocol_version >= 2 && length <= MAX_EXTENDED_FRAME_LENGTH;
+}
+
+/*!
+ * Whether a 16-bit (host order) frame length, read from a peer of
+ *  protocol_version, is followed by a 32-bit extended length
+ */
+inline bool is_extended_frame(uint16_t length, unsigned protocol_version)
+{
+    return protocol_version >= 2 && length == EXTENDED_FRAME_MARKER;
+}
+
+/*!
+ * Writes the network-order length preamble of a message of length
+ *  bytes, for a peer of protocol_version, to out. Returns the size
+ *  of the preamble.
+ *
+ * Messages of EXTENDED_FRAME_MARKER bytes or more are written as
+ *  extended frames. Precondition: frame_length_supported()
+ */
+inline size_t write_frame_preamble(size_t length,
+    unsigned protocol_version, char * out)
+{
+    SAMOA_ASSERT(frame_length_supported(length, protocol_version));
+
+    uint16_t short_len = htons((uint16_t) std::min<size_t>(
+        length, EXTENDED_FRAME_MARKER));
+
+    memcpy(out, &short_len, 2);
+
+    if(length < EXTENDED_FRAME_MARKER)
+        return 2;
+
+    uint32_t long_len = htonl((uint32_t) length);
+    memcpy(out + 2, &long_len, 4);
+    return 6;
+}
+
 }
 }
 
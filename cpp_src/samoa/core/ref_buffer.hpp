@@ -1,6 +1,7 @@
-#ifndef SAMOA_CORE_BUFFER_POOL_HPP
-#define SAMOA_CORE_BUFFER_POOL_HPP
+#ifndef SAMOA_CORE_REF_BUFFER_HPP
+#define SAMOA_CORE_REF_BUFFER_HPP
 
+#include "samoa/core/buffer_pool.hpp"
 #include <boost/detail/atomic_count.hpp>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/noncopyable.hpp>
@@ -29,22 +30,37 @@ public:
     size_t size() const
     { return _size; }
     
+    /*!
+     * Acquires a buffer of at least size bytes from the buffer_pool.
+     *  Buffers are sized to fill their complete size class, and
+     *  size() may be larger than requested.
+     */
     static ptr_t aquire_ref_buffer(size_t size)
     {
-        void * buf = new char[sizeof(ref_buffer) + size];
-        return ptr_t(new (buf) ref_buffer(size));
+        unsigned size_class = buffer_pool::size_class_of(
+            sizeof(ref_buffer) + size);
+
+        if(size_class != buffer_pool::no_class)
+        {
+            size = buffer_pool::class_size(size_class) - sizeof(ref_buffer);
+        }
+
+        void * buf = buffer_pool::allocate(size_class,
+            sizeof(ref_buffer) + size);
+        return ptr_t(new (buf) ref_buffer(size, size_class));
     }
     
 private:
     
-    ref_buffer(size_t size)
-     : _size(size), _ref_cnt(0)
+    ref_buffer(size_t size, unsigned size_class)
+     : _size(size), _size_class(size_class), _ref_cnt(0)
     { }
     
     ~ref_buffer()
     { }
     
     const size_t  _size;
+    const unsigned _size_class;
     mutable boost::detail::atomic_count _ref_cnt;
     char          _data[];
     
@@ -59,8 +75,10 @@ inline void intrusive_ptr_release(const ref_buffer * cp)
 {
     if( --(cp->_ref_cnt) == 0)
     {
+        unsigned size_class = cp->_size_class;
+
         cp->~ref_buffer();
-        delete [] (char*) cp;
+        buffer_pool::release((void*) cp, size_class);
     }
 }
 
@@ -1,6 +1,7 @@
 
 #include "samoa/core/stream_protocol.hpp"
 #include <boost/bind.hpp>
+#include <algorithm>
 
 namespace samoa {
 namespace core {
@@ -8,8 +9,17 @@ namespace core {
 ////////////////////////////////////////////////////////////////////////
 //  stream_protocol_read_interface
 
+const size_t stream_protocol_read_interface::min_read_ahead;
+const size_t stream_protocol_read_interface::max_read_ahead;
+const unsigned stream_protocol_read_interface::max_sync_reads;
+
 stream_protocol_read_interface::stream_protocol_read_interface()
- : _in_read(false)
+ : _in_read(false),
+   _read_ahead(min_read_ahead),
+   _read_offered(0),
+   _sync_read_count(0),
+   _read_count(0),
+   _socket_read_count(0)
 { }
 
 void stream_protocol_read_interface::read_regex(
@@ -45,24 +55,77 @@ void stream_protocol_read_interface::read_data(
     assert(!_in_read);
     _in_read = true;
 
+    if(_r_ring.available_read() >= read_length &&
+       ++_sync_read_count > max_sync_reads)
+    {
+        // we've completed many reads from buffered data without
+        //  returning to the io_service; yield before completing this one
+        _sync_read_count = 0;
+
+        static_cast<stream_protocol*>(this)->get_io_service()->post(
+            boost::bind(&stream_protocol::on_read_data, this,
+                boost::system::error_code(), 0, read_length, callback));
+        return;
+    }
+
     on_read_data(
         boost::system::error_code(),
         0, read_length, callback);
 }
 
+void stream_protocol_read_interface::read_data_chunks(
+    const stream_protocol_read_interface::read_chunk_callback_t & callback,
+    size_t read_length)
+{
+    assert(!_in_read);
+    _in_read = true;
+
+    on_read_chunk(
+        boost::system::error_code(),
+        0, read_length, callback);
+}
+
 void stream_protocol_read_interface::pre_socket_read(size_t read_target)
 {
     assert(read_target > _r_ring.available_read());
 
-    _r_ring.reserve(read_target);
+    // read beyond the target by the read-ahead window, so that
+    //  subsequent (eg, pipelined) reads may be satisfied from
+    //  already-buffered data without another socket read
+    size_t write_target = std::max(read_target,
+        _r_ring.available_read() + _read_ahead) - _r_ring.available_read();
+
+    _r_ring.reserve(write_target);
 
+    // offer all allocated write space to the socket
     _r_regions.clear();
-    _r_ring.get_write_regions(_r_regions,
-        read_target - _r_ring.available_read());
+    _r_ring.get_write_regions(_r_regions);
+
+    _read_offered = _r_ring.available_write();
 }
 
 void stream_protocol_read_interface::post_socket_read(size_t bytes_read)
-{ _r_ring.produced(bytes_read); }
+{
+    if(!bytes_read)
+        return;
+
+    _r_ring.produced(bytes_read);
+    _socket_read_count += 1;
+    _sync_read_count = 0;
+
+    if(bytes_read == _read_offered)
+    {
+        // the socket had at least as much as we'd offered;
+        //  more is likely pending
+        _read_ahead = std::min(_read_ahead * 2, max_read_ahead);
+    }
+    else
+    {
+        // decay towards recently observed read sizes
+        _read_ahead = std::max(min_read_ahead,
+            (_read_ahead + bytes_read) / 2);
+    }
+}
 
 void stream_protocol_read_interface::on_regex_read(
     const  boost::system::error_code & ec,
@@ -96,6 +159,7 @@ void stream_protocol_read_interface::on_regex_read(
     {
         // mark match as delivered
         _r_ring.consumed(std::distance(begin, match[0].second));
+        _read_count += 1;
         _in_read = false;
         // call back to client w/ matches
         callback(ec, match);
@@ -160,6 +224,7 @@ void stream_protocol_read_interface::on_read_line(
         // mark match as delivered
         _r_ring.consumed(std::distance(begin, match));
         // call back to client w/ matches
+        _read_count += 1;
         _in_read = false;
         callback(ec, begin, match);
         return;
@@ -215,6 +280,7 @@ void stream_protocol_read_interface::on_read_data(
         // mark as delivered
         _r_ring.consumed(read_length);
         // call back to client
+        _read_count += 1;
         _in_read = false;
         callback(ec, read_length, _r_regions);
         return;
@@ -228,19 +294,71 @@ void stream_protocol_read_interface::on_read_data(
     boost::asio::ip::tcp::socket & sock(
         static_cast<stream_protocol*>(this)->get_socket());
 
-    // Schedule read-till-completion
-    boost::asio::async_read(sock, _r_regions,
+    // Schedule a partial read; we're called again
+    //  until read_length bytes are available
+    sock.async_read_some(_r_regions,
         boost::bind(&stream_protocol::on_read_data, this,
             boost::asio::placeholders::error,
             boost::asio::placeholders::bytes_transferred,
             read_length, callback));
 }
 
+void stream_protocol_read_interface::on_read_chunk(
+    const  boost::system::error_code & ec,
+    size_t bytes_transferred,
+    size_t remaining,
+    const  stream_protocol_read_interface::read_chunk_callback_t & callback)
+{
+    if(ec)
+    {
+        _in_read = false;
+        callback(ec, remaining, buffer_regions_t());
+        return;
+    }
+
+    post_socket_read(bytes_transferred);
+
+    size_t chunk_length = std::min(_r_ring.available_read(), remaining);
+
+    if(chunk_length || !remaining)
+    {
+        remaining -= chunk_length;
+
+        // extract & deliver buffered chunk
+        _r_regions.clear();
+        _r_ring.get_read_regions(_r_regions, chunk_length);
+        _r_ring.consumed(chunk_length);
+
+        if(!remaining)
+        {
+            _read_count += 1;
+            _in_read = false;
+            callback(ec, remaining, _r_regions);
+            return;
+        }
+        callback(ec, remaining, _r_regions);
+    }
+
+    // the ring is drained; target the next chunk, rather than the
+    //  full remainder, so that buffering is bounded by the read-ahead
+    pre_socket_read(std::min(remaining, max_read_ahead));
+
+    boost::asio::ip::tcp::socket & sock(
+        static_cast<stream_protocol*>(this)->get_socket());
+
+    sock.async_read_some(_r_regions,
+        boost::bind(&stream_protocol::on_read_chunk, this,
+            boost::asio::placeholders::error,
+            boost::asio::placeholders::bytes_transferred,
+            remaining, callback));
+}
+
 ////////////////////////////////////////////////////////////////////////
 //  stream_protocol_write_interface
 
 stream_protocol_write_interface::stream_protocol_write_interface()
- : _in_write(false)
+ : _in_write(false),
+   _write_count(0)
 { }
 
 bool stream_protocol_write_interface::has_queued_writes() const
@@ -263,12 +381,17 @@ void stream_protocol_write_interface::write_queued(
 {
     assert(!_in_write);
     _in_write = true;
+    _write_count += 1;
+
+    // further queued regions are held for the next write
+    _w_active_regions.swap(_w_regions);
+    _w_regions.clear();
 
     boost::asio::ip::tcp::socket & sock(
         static_cast<stream_protocol*>(this)->get_socket());
 
     // Schedule write-till-completion
-    boost::asio::async_write(sock, _w_regions,
+    boost::asio::async_write(sock, _w_active_regions,
         boost::bind(&stream_protocol_write_interface::on_write_queued, this,
         boost::asio::placeholders::error,
         boost::asio::placeholders::bytes_transferred,
@@ -284,13 +407,13 @@ void stream_protocol_write_interface::on_write_queued(
     if(!ec)
     {
         size_t pending = 0;
-        for(size_t i = 0; i != _w_regions.size(); ++i)
-            pending += _w_regions[i].size();
+        for(size_t i = 0; i != _w_active_regions.size(); ++i)
+            pending += _w_active_regions[i].size();
         assert(pending == bytes_transferred);
     }
     // end temp
 
-    _w_regions.clear();
+    _w_active_regions.clear();
     _in_write = false;
 
     callback(ec, bytes_transferred);
@@ -8,6 +8,7 @@
 #include <boost/function.hpp>
 #include <boost/regex.hpp>
 #include <boost/system/error_code.hpp>
+#include <cstdint>
 
 namespace samoa {
 namespace core {
@@ -54,12 +55,53 @@ public:
             size_t, const buffer_regions_t &)
     > read_data_callback_t;
 
+    // if read_length bytes are already buffered, the read completes
+    //  synchronously (up to max_sync_reads consecutive times, after
+    //  which completion is posted to the io_service)
     void read_data(
         const read_data_callback_t &,
         size_t read_length);
 
+    // size_t argument is the count of bytes which remain to be read
+    //  after the chunk. buffer_regions_t argument is invalidated by
+    //  the next chunk
+    typedef boost::function<
+        void(const boost::system::error_code &,
+            size_t, const buffer_regions_t &)
+    > read_chunk_callback_t;
+
+    // reads read_length bytes, invoking the callback with each chunk
+    //  as it's received (rather than buffering the complete read).
+    //  The read is complete when the remaining count reaches zero;
+    //  only then may the callback begin another read_*
+    void read_data_chunks(
+        const read_chunk_callback_t &,
+        size_t read_length);
+
+    // metrics
+
+    //! Count of completed read_* operations
+    uint64_t get_read_count() const
+    { return _read_count; }
+
+    //! Count of socket reads performed to complete them
+    uint64_t get_socket_read_count() const
+    { return _socket_read_count; }
+
+    //! Bytes which the next socket read will attempt beyond its target
+    size_t get_read_ahead() const
+    { return _read_ahead; }
+
 private:
 
+    // bounds of the adaptive read-ahead window
+    static const size_t min_read_ahead = 1 << 12;
+    static const size_t max_read_ahead = 1 << 16;
+
+    // bound on consecutive reads completed from buffered data,
+    //  before yielding to other io_service handlers
+    static const unsigned max_sync_reads = 64;
+
     void pre_socket_read(size_t read_target);
     void post_socket_read(size_t bytes_read);
 
@@ -83,9 +125,23 @@ private:
         size_t read_length,
         const  read_data_callback_t &);
 
+    void on_read_chunk(
+        const  boost::system::error_code & ec,
+        size_t bytes_transferred,
+        size_t remaining,
+        const  read_chunk_callback_t &);
+
     bool _in_read;
     buffer_ring _r_ring;
     buffer_regions_t _r_regions;
+
+    size_t _read_ahead;
+    size_t _read_offered;
+
+    unsigned _sync_read_count;
+
+    uint64_t _read_count;
+    uint64_t _socket_read_count;
 };
 
 class stream_protocol_write_interface
@@ -100,8 +156,8 @@ public:
     // queue_write(*) - schedule buffer for writing to the client,
     //  using gather-IO.
     //
-    // It is an error to call queue_write() while a
-    //  write operation is in progress.
+    // Buffers may be queued while a write operation is in progress;
+    //  they're written by the next call to write_queued().
     void queue_write(const const_buffer_region &);
     void queue_write(const const_buffer_regions_t &);
     void queue_write(const buffer_regions_t &);
@@ -130,6 +186,16 @@ public:
     //
     void write_queued(const write_queued_callback_t &);
 
+    //! Whether a write_queued() operation is in progress
+    bool in_write() const
+    { return _in_write; }
+
+    // metrics
+
+    //! Count of write_queued() operations
+    uint64_t get_write_count() const
+    { return _write_count; }
+
 private:
 
     void on_write_queued(
@@ -139,7 +205,13 @@ private:
 
     bool _in_write;
     buffer_ring _w_ring;
+
+    // regions queued for the next write_queued(),
+    //  and those of a write in progress
     const_buffer_regions_t _w_regions;
+    const_buffer_regions_t _w_active_regions;
+
+    uint64_t _write_count;
 };
 
 class stream_protocol :
@@ -0,0 +1,58 @@
+#ifndef SAMOA_CORE_STREAMING_COPY_HPP
+#define SAMOA_CORE_STREAMING_COPY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace samoa {
+namespace core {
+
+/*!
+ * Byte-length at and above which copies of record data should use
+ *  streaming_copy() rather than cached stores.
+ *
+ * Large values are rarely read back soon after they're written, and
+ *  writing them through the cache evicts hot index and record lines.
+ */
+static const size_t streaming_copy_threshold = 1 << 14;
+
+/*!
+ * Copies range [begin, end) to out, using non-temporal (streaming)
+ *  stores which bypass the CPU cache where the platform supports them.
+ *
+ * Like std::copy, the copy proceeds forward: out may overlap the input
+ *  range only if out <= begin.
+ *
+ * Streamed stores are fenced before returning, so the copy is ordered
+ *  ahead of any subsequent stores (eg, a hash-chain update publishing
+ *  the record).
+ */
+inline void streaming_copy(const char * begin, const char * end, char * out)
+{
+#ifdef __SSE2__
+    // bring output to 16-byte alignment with ordinary stores
+    while(begin != end && ((uintptr_t)out & 15))
+        *(out++) = *(begin++);
+
+    for(; end - begin >= 16; begin += 16, out += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) begin);
+        _mm_stream_si128((__m128i *) out, chunk);
+    }
+    _mm_sfence();
+#endif
+
+    // remaining unaligned tail
+    std::copy(begin, end, out);
+}
+
+}
+}
+
+#endif
+
@@ -0,0 +1,304 @@
+#include "samoa/core/timer_wheel.hpp"
+#include "samoa/core/proactor.hpp"
+#include "samoa/log.hpp"
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace samoa {
+namespace core {
+
+static const uint64_t tick_us = uint64_t(timer_wheel::tick_ms) * 1000;
+
+timer_wheel::timer_wheel(const io_service_ptr_t & io_service)
+ : _io_service(io_service),
+   _epoch(boost::asio::deadline_timer::traits_type::now()),
+   _tick(0),
+   _pending_count(0),
+   _driver_count(0)
+{
+    std::fill(_slots, _slots + slot_count, (wheel_timer*) 0);
+}
+
+timer_wheel::~timer_wheel()
+{
+    // outstanding timers hold a reference to the wheel
+    //  (not SAMOA_ASSERT, which would throw from the destructor)
+    assert(!_pending_count);
+}
+
+size_t timer_wheel::get_pending_count() const
+{
+    spinlock::guard guard(_lock);
+    return _pending_count;
+}
+
+size_t timer_wheel::get_driver_count() const
+{
+    spinlock::guard guard(_lock);
+    return _driver_count;
+}
+
+uint64_t timer_wheel::now_tick() const
+{
+    return (boost::asio::deadline_timer::traits_type::now() - _epoch
+        ).total_microseconds() / tick_us;
+}
+
+void timer_wheel::link(wheel_timer & timer, uint64_t due)
+{
+    wheel_timer * & head = _slots[due % slot_count];
+
+    timer._due = due;
+    timer._prev = 0;
+    timer._next = head;
+
+    if(head)
+        head->_prev = &timer;
+
+    head = &timer;
+    timer._scheduled = true;
+    _pending_count += 1;
+}
+
+void timer_wheel::unlink(wheel_timer & timer)
+{
+    if(timer._prev)
+        timer._prev->_next = timer._next;
+    else
+        _slots[timer._due % slot_count] = timer._next;
+
+    if(timer._next)
+        timer._next->_prev = timer._prev;
+
+    timer._prev = timer._next = 0;
+    timer._scheduled = false;
+    _pending_count -= 1;
+}
+
+bool timer_wheel::next_due(uint64_t & due) const
+{
+    if(!_pending_count)
+        return false;
+
+    // the first non-empty slot may hold only timers of later
+    //  revolutions, in which case the driver wakes spuriously
+    for(uint64_t tick = _tick; tick != _tick + slot_count; ++tick)
+    {
+        if(_slots[tick % slot_count])
+        {
+            due = tick;
+            return true;
+        }
+    }
+    SAMOA_ASSERT(false);
+    return false;
+}
+
+void timer_wheel::schedule(wheel_timer & timer,
+    callback_t & callback, unsigned delay_ms)
+{
+    driver_ptr_t driver;
+    bool arm = false;
+    uint64_t due;
+    {
+        spinlock::guard guard(_lock);
+
+        if(timer._scheduled)
+            unlink(timer);
+
+        // callback is swapped with any previous callback,
+        //  which is released by the caller outside of the lock
+        timer._callback.swap(callback);
+
+        // round up, so that timers never expire early
+        due = ((boost::asio::deadline_timer::traits_type::now() - _epoch
+            ).total_microseconds() + uint64_t(delay_ms) * 1000 + tick_us - 1)
+            / tick_us;
+
+        due = std::max(due, _tick);
+        link(timer, due);
+
+        if(_wakes.empty() || *_wakes.begin() > due)
+        {
+            // no armed driver will wake by the due tick
+            arm = true;
+            _wakes.insert(due);
+
+            if(!_idle_drivers.empty())
+            {
+                driver = _idle_drivers.back();
+                _idle_drivers.pop_back();
+            }
+            else
+                _driver_count += 1;
+        }
+    }
+
+    if(arm)
+    {
+        if(!driver)
+        {
+            driver = boost::make_shared<boost::asio::deadline_timer>(
+                *_io_service);
+        }
+        arm_driver(driver, due);
+    }
+}
+
+bool timer_wheel::cancel(wheel_timer & timer, callback_t & callback)
+{
+    spinlock::guard guard(_lock);
+
+    if(!timer._scheduled)
+        return false;
+
+    unlink(timer);
+    timer._callback.swap(callback);
+    return true;
+}
+
+void timer_wheel::arm_driver(driver_ptr_t driver, uint64_t wake_tick)
+{
+    // drivers are owned by at most one wake, and so may
+    //  safely be armed from any thread
+    driver->expires_at(_epoch +
+        boost::posix_time::microseconds(wake_tick * tick_us));
+
+    driver->async_wait(boost::bind(&timer_wheel::on_driver_wake, _1,
+        boost::weak_ptr<timer_wheel>(shared_from_this()),
+        driver, wake_tick));
+}
+
+void timer_wheel::on_driver_wake(const boost::system::error_code & ec,
+    const boost::weak_ptr<timer_wheel> & weak_wheel,
+    const driver_ptr_t & driver, uint64_t wake_tick)
+{
+    timer_wheel::ptr_t wheel = weak_wheel.lock();
+
+    if(ec || !wheel)
+    {
+        // io_service is shutting down
+        return;
+    }
+    wheel->on_wake(driver, wake_tick);
+}
+
+void timer_wheel::on_wake(const driver_ptr_t & driver, uint64_t wake_tick)
+{
+    std::vector<callback_t> expired;
+
+    bool rearm = false;
+    uint64_t next;
+    {
+        spinlock::guard guard(_lock);
+
+        _wakes.erase(_wakes.find(wake_tick));
+
+        uint64_t now = now_tick();
+
+        // visit each slot at most once, even after a long stall
+        uint64_t end = std::min(now + 1, _tick + slot_count);
+
+        for(uint64_t tick = _tick; tick < end; ++tick)
+        {
+            wheel_timer * timer = _slots[tick % slot_count];
+
+            while(timer)
+            {
+                wheel_timer * next_timer = timer->_next;
+
+                if(timer->_due <= now)
+                {
+                    unlink(*timer);
+
+                    expired.push_back(callback_t());
+                    expired.back().swap(timer->_callback);
+                }
+                timer = next_timer;
+            }
+        }
+        _tick = std::max(_tick, now + 1);
+
+        if(next_due(next) && (_wakes.empty() || *_wakes.begin() > next))
+        {
+            rearm = true;
+            _wakes.insert(next);
+        }
+        else
+            _idle_drivers.push_back(driver);
+    }
+
+    if(rearm)
+    {
+        arm_driver(driver, next);
+    }
+
+    for(size_t i = 0; i != expired.size(); ++i)
+    {
+        try
+        {
+            expired[i]();
+        }
+        catch(...)
+        {
+            // as with asio handlers, exceptions propagate from run();
+            //  remaining callbacks are deferred to later handlers
+            for(size_t j = i + 1; j != expired.size(); ++j)
+                _io_service->post(expired[j]);
+
+            throw;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+//  wheel_timer
+
+wheel_timer::wheel_timer(const io_service_ptr_t & io_service)
+ : _wheel(proactor::get_proactor()->get_timer_wheel(io_service)),
+   _prev(0),
+   _next(0),
+   _due(0),
+   _scheduled(false)
+{ }
+
+wheel_timer::wheel_timer(const timer_wheel_ptr_t & wheel)
+ : _wheel(wheel),
+   _prev(0),
+   _next(0),
+   _due(0),
+   _scheduled(false)
+{ }
+
+wheel_timer::~wheel_timer()
+{
+    cancel();
+}
+
+void wheel_timer::schedule(const callback_t & callback, unsigned delay_ms)
+{
+    callback_t tmp(callback);
+    _wheel->schedule(*this, tmp, delay_ms);
+
+    // tmp now holds the replaced callback, if any, and is
+    //  released here (outside of the wheel lock)
+}
+
+bool wheel_timer::cancel()
+{
+    // note that release of tmp may release the final
+    //  reference to this timer; don't touch members after
+    callback_t tmp;
+    return _wheel->cancel(*this, tmp);
+}
+
+bool wheel_timer::is_scheduled() const
+{
+    spinlock::guard guard(_wheel->_lock);
+    return _scheduled;
+}
+
+}
+}
+
@@ -0,0 +1,148 @@
+#ifndef SAMOA_CORE_TIMER_WHEEL_HPP
+#define SAMOA_CORE_TIMER_WHEEL_HPP
+
+#include "samoa/core/fwd.hpp"
+#include "samoa/spinlock.hpp"
+#include <boost/asio.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace samoa {
+namespace core {
+
+class wheel_timer;
+
+/*!
+ * A hashed timing wheel of millisecond timers, run by an io_service.
+ *
+ * Timers are bucketed by expiry tick into one of slot_count intrusive
+ *  lists, making schedule & cancel O(1) regardless of the number of
+ *  pending timers. A small number of asio deadline_timers ("drivers")
+ *  wake the io_service at the next non-empty slot; expired timers of
+ *  each wake are invoked from a single io_service handler.
+ *
+ * Use proactor::get_timer_wheel() to obtain the wheel of an io_service.
+ */
+class timer_wheel :
+    public boost::enable_shared_from_this<timer_wheel>,
+    private boost::noncopyable
+{
+public:
+
+    typedef timer_wheel_ptr_t ptr_t;
+
+    enum {
+        slot_count = 4096,
+        tick_ms = 1
+    };
+
+    explicit timer_wheel(const io_service_ptr_t &);
+
+    ~timer_wheel();
+
+    const io_service_ptr_t & get_io_service() const
+    { return _io_service; }
+
+    // metrics
+
+    size_t get_pending_count() const;
+    size_t get_driver_count() const;
+
+private:
+
+    friend class wheel_timer;
+
+    typedef boost::function<void()> callback_t;
+    typedef boost::shared_ptr<boost::asio::deadline_timer> driver_ptr_t;
+
+    // lock must be held
+    uint64_t now_tick() const;
+    void link(wheel_timer &, uint64_t due);
+    void unlink(wheel_timer &);
+    bool next_due(uint64_t & due) const;
+
+    void schedule(wheel_timer &, callback_t &, unsigned delay_ms);
+    bool cancel(wheel_timer &, callback_t &);
+
+    void arm_driver(driver_ptr_t, uint64_t wake_tick);
+
+    static void on_driver_wake(const boost::system::error_code &,
+        const boost::weak_ptr<timer_wheel> &,
+        const driver_ptr_t &, uint64_t wake_tick);
+
+    void on_wake(const driver_ptr_t &, uint64_t wake_tick);
+
+    const io_service_ptr_t _io_service;
+    const boost::posix_time::ptime _epoch;
+
+    mutable spinlock _lock;
+
+    wheel_timer * _slots[slot_count];
+
+    // next tick to be expired
+    uint64_t _tick;
+    size_t _pending_count;
+
+    // wake ticks of armed drivers
+    std::multiset<uint64_t> _wakes;
+    std::vector<driver_ptr_t> _idle_drivers;
+    size_t _driver_count;
+};
+
+/*!
+ * A single-shot timer of a timer_wheel.
+ *
+ * Unlike boost::asio::deadline_timer, a cancelled (or re-scheduled)
+ *  timer's callback is simply released, rather than invoked with an
+ *  error. A timer is cancelled on destruction.
+ */
+class wheel_timer :
+    private boost::noncopyable
+{
+public:
+
+    typedef timer_ptr_t ptr_t;
+
+    typedef boost::function<void()> callback_t;
+
+    //! Constructs a timer of the io_service's timer_wheel
+    explicit wheel_timer(const io_service_ptr_t &);
+
+    explicit wheel_timer(const timer_wheel_ptr_t &);
+
+    ~wheel_timer();
+
+    /*!
+     * Schedules callback to be invoked on the wheel's io_service
+     *  after delay_ms, replacing any pending callback.
+     */
+    void schedule(const callback_t &, unsigned delay_ms);
+
+    //! Returns true iff a pending callback was cancelled
+    bool cancel();
+
+    bool is_scheduled() const;
+
+private:
+
+    friend class timer_wheel;
+
+    const timer_wheel_ptr_t _wheel;
+
+    // state guarded by the wheel's lock
+    wheel_timer * _prev;
+    wheel_timer * _next;
+    uint64_t _due;
+    bool _scheduled;
+
+    callback_t _callback;
+};
+
+}
+}
+
+#endif
+
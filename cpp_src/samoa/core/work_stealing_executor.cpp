@@ -0,0 +1,254 @@
+#include "samoa/core/work_stealing_executor.hpp"
+#include "samoa/error.hpp"
+#include "samoa/log.hpp"
+
+namespace samoa {
+namespace core {
+
+// lifetime is managed by the worker's run() or strand's on_run()
+template<typename T>
+void null_tss_cleanup(T *) {}
+
+// strand currently running a handler on this thread, if any
+static boost::thread_specific_ptr<work_stealing_executor::strand>
+    _current_strand(&null_tss_cleanup<work_stealing_executor::strand>);
+
+work_stealing_executor::work_stealing_executor(
+    const fallback_post_t & fallback_post)
+ : _fallback_post(fallback_post),
+   _worker_count(0),
+   _next_worker(0),
+   _worker_index(&null_tss_cleanup<size_t>),
+   _pending_count(0),
+   _parked_count(0),
+   _stopped(0)
+{ }
+
+work_stealing_executor::~work_stealing_executor()
+{ }
+
+void work_stealing_executor::post_handler(const handler_t & handler)
+{
+    size_t worker_count = _worker_count;
+
+    if(!worker_count)
+    {
+        _fallback_post(handler);
+        return;
+    }
+
+    size_t index;
+    if(_worker_index.get())
+    {
+        // push to this worker's own deque
+        index = *_worker_index.get();
+    }
+    else
+    {
+        index = size_t(++_next_worker) % worker_count;
+    }
+
+    ++_pending_count;
+    {
+        spinlock::guard guard(_workers[index].lock);
+        _workers[index].handlers.push_back(handler);
+    }
+
+    if(_parked_count)
+    {
+        // lock, so a worker can't miss the notification
+        //  between checking _pending_count & waiting
+        boost::lock_guard<boost::mutex> guard(_park_mutex);
+        _park_condition.notify_one();
+    }
+}
+
+bool work_stealing_executor::pop_local(worker & self, handler_t & handler)
+{
+    spinlock::guard guard(self.lock);
+
+    if(self.handlers.empty())
+        return false;
+
+    handler.swap(self.handlers.front());
+    self.handlers.pop_front();
+    return true;
+}
+
+bool work_stealing_executor::steal(size_t thief, handler_t & handler)
+{
+    size_t worker_count = _worker_count;
+
+    for(size_t i = 1; i < worker_count; ++i)
+    {
+        worker & victim = _workers[(thief + i) % worker_count];
+        spinlock::guard guard(victim.lock);
+
+        if(victim.handlers.empty())
+            continue;
+
+        // take the most-recently posted handler; the victim
+        //  is likely to be further along its older handlers
+        handler.swap(victim.handlers.back());
+        victim.handlers.pop_back();
+        return true;
+    }
+    return false;
+}
+
+void work_stealing_executor::run()
+{
+    SAMOA_ASSERT(!_worker_index.get() && "thread is already a worker");
+
+    size_t index;
+    {
+        // registration is serialized, so that a worker's
+        //  slot is reserved before it's counted
+        boost::lock_guard<boost::mutex> guard(_park_mutex);
+
+        index = _worker_count;
+        SAMOA_ASSERT(index < max_worker_count);
+
+        ++_worker_count;
+    }
+
+    size_t worker_index = index;
+    _worker_index.reset(&worker_index);
+
+    LOG_DBG("worker " << index << " running");
+
+    worker & self = _workers[index];
+    handler_t handler;
+
+    try
+    {
+        while(!_stopped)
+        {
+            if(pop_local(self, handler) || steal(index, handler))
+            {
+                --_pending_count;
+
+                handler();
+                handler.clear();
+                continue;
+            }
+
+            boost::unique_lock<boost::mutex> lock(_park_mutex);
+            ++_parked_count;
+
+            while(!_pending_count && !_stopped)
+                _park_condition.wait(lock);
+
+            --_parked_count;
+        }
+    }
+    catch(...)
+    {
+        // as with io_service::run(), handler exceptions propagate
+        _worker_index.reset();
+        throw;
+    }
+    _worker_index.reset();
+}
+
+void work_stealing_executor::stop()
+{
+    boost::lock_guard<boost::mutex> guard(_park_mutex);
+
+    if(!_stopped)
+        ++_stopped;
+
+    _park_condition.notify_all();
+}
+
+bool work_stealing_executor::running_in_this_thread() const
+{ return _worker_index.get() != 0; }
+
+size_t work_stealing_executor::get_worker_count() const
+{ return _worker_count; }
+
+////////////////////////////////////////////////////////////////////////
+//  work_stealing_executor::strand
+
+work_stealing_executor::strand::strand(
+    const work_stealing_executor::ptr_t & executor)
+ : _executor(executor),
+   _running(false)
+{ }
+
+bool work_stealing_executor::strand::running_in_this_thread() const
+{ return _current_strand.get() == this; }
+
+void work_stealing_executor::strand::post_handler(const handler_t & handler)
+{
+    bool start;
+    {
+        spinlock::guard guard(_lock);
+
+        _handlers.push_back(handler);
+
+        start = !_running;
+        _running = true;
+    }
+
+    if(start)
+    {
+        _executor->post(boost::bind(&strand::on_run, this));
+    }
+}
+
+void work_stealing_executor::strand::on_run()
+{
+    handler_t handler;
+    {
+        spinlock::guard guard(_lock);
+
+        SAMOA_ASSERT(_running && !_handlers.empty());
+
+        handler.swap(_handlers.front());
+        _handlers.pop_front();
+    }
+
+    strand * previous = _current_strand.get();
+    _current_strand.reset(this);
+
+    bool more;
+    try
+    {
+        handler();
+    }
+    catch(...)
+    {
+        _current_strand.reset(previous);
+        {
+            spinlock::guard guard(_lock);
+            more = !_handlers.empty();
+            _running = more;
+        }
+        if(more)
+            _executor->post(boost::bind(&strand::on_run, this));
+
+        throw;
+    }
+
+    _current_strand.reset(previous);
+    {
+        spinlock::guard guard(_lock);
+        more = !_handlers.empty();
+        _running = more;
+    }
+
+    if(more)
+    {
+        // run further handlers as separate executor jobs,
+        //  so that other work interleaves (and may steal them)
+        _executor->post(boost::bind(&strand::on_run, this));
+    }
+
+    // note that destruction of handler may release the final
+    //  reference to this strand's owner; don't touch members
+}
+
+}
+}
+
@@ -0,0 +1,191 @@
+#ifndef SAMOA_CORE_WORK_STEALING_EXECUTOR_HPP
+#define SAMOA_CORE_WORK_STEALING_EXECUTOR_HPP
+
+#include "samoa/core/fwd.hpp"
+#include "samoa/spinlock.hpp"
+#include <boost/detail/atomic_count.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <boost/noncopyable.hpp>
+#include <deque>
+
+namespace samoa {
+namespace core {
+
+/*!
+ * Executes (potentially blocking) handlers over a pool of threads,
+ *  each of which owns a deque of runnable handlers.
+ *
+ * Handlers posted from a worker thread are pushed to that worker's own
+ *  deque; handlers posted from other threads are spread across worker
+ *  deques round-robin. A worker which runs dry steals from the deques of
+ *  its peers before parking. Unlike a shared io_service, workers thus
+ *  contend only when stealing, rather than on every post.
+ *
+ * Provides the post / dispatch / wrap surface of boost::asio::io_service.
+ *  If no thread has entered run(), handlers are passed to a fallback
+ *  post function (eg, of a serial io_service).
+ */
+class work_stealing_executor :
+    public boost::enable_shared_from_this<work_stealing_executor>
+{
+public:
+
+    typedef work_stealing_executor_ptr_t ptr_t;
+
+    typedef boost::function<void()> handler_t;
+
+    typedef boost::function<void(const handler_t &)> fallback_post_t;
+
+    enum {
+        max_worker_count = 64
+    };
+
+    explicit work_stealing_executor(const fallback_post_t &);
+
+    ~work_stealing_executor();
+
+    template<typename Handler>
+    void post(const Handler & handler)
+    { post_handler(handler_t(handler)); }
+
+    //! Invokes handler directly if called from a worker; else posts
+    template<typename Handler>
+    void dispatch(const Handler & handler)
+    {
+        if(running_in_this_thread())
+            handler();
+        else
+            post(handler);
+    }
+
+    template<typename Handler>
+    class wrapped_handler;
+
+    //! Returns a callable which dispatches handler through this executor
+    template<typename Handler>
+    wrapped_handler<Handler> wrap(const Handler & handler)
+    { return wrapped_handler<Handler>(shared_from_this(), handler); }
+
+    /*!
+     * Registers the calling thread as a worker, and runs handlers until
+     *  stop() is called.
+     */
+    void run();
+
+    //! Causes all workers to return from run()
+    void stop();
+
+    bool running_in_this_thread() const;
+
+    size_t get_worker_count() const;
+
+    /*!
+     * Serializes execution of handlers posted through it, in the fashion
+     *  of boost::asio::strand, while running them on the executor.
+     */
+    class strand;
+
+private:
+
+    struct worker
+    {
+        spinlock lock;
+        std::deque<handler_t> handlers;
+    };
+
+    void post_handler(const handler_t &);
+
+    bool pop_local(worker &, handler_t &);
+    bool steal(size_t thief, handler_t &);
+
+    const fallback_post_t _fallback_post;
+
+    worker _workers[max_worker_count];
+    boost::detail::atomic_count _worker_count;
+    boost::detail::atomic_count _next_worker;
+
+    // index of the worker run() by this thread, or null
+    boost::thread_specific_ptr<size_t> _worker_index;
+
+    boost::detail::atomic_count _pending_count;
+    boost::detail::atomic_count _parked_count;
+    boost::detail::atomic_count _stopped;
+
+    boost::mutex _park_mutex;
+    boost::condition_variable _park_condition;
+};
+
+template<typename Handler>
+class work_stealing_executor::wrapped_handler
+{
+public:
+
+    wrapped_handler(const ptr_t & executor, const Handler & handler)
+     : _executor(executor), _handler(handler)
+    { }
+
+    void operator()()
+    { _executor->dispatch(_handler); }
+
+    template<typename Arg1>
+    void operator()(const Arg1 & arg1)
+    { _executor->dispatch(boost::bind(_handler, arg1)); }
+
+    template<typename Arg1, typename Arg2>
+    void operator()(const Arg1 & arg1, const Arg2 & arg2)
+    { _executor->dispatch(boost::bind(_handler, arg1, arg2)); }
+
+private:
+
+    ptr_t _executor;
+    Handler _handler;
+};
+
+class work_stealing_executor::strand :
+    private boost::noncopyable
+{
+public:
+
+    explicit strand(const work_stealing_executor::ptr_t &);
+
+    template<typename Handler>
+    void post(const Handler & handler)
+    { post_handler(handler_t(handler)); }
+
+    //! Invokes handler directly if called from within this strand
+    template<typename Handler>
+    void dispatch(const Handler & handler)
+    {
+        if(running_in_this_thread())
+            handler();
+        else
+            post(handler);
+    }
+
+    bool running_in_this_thread() const;
+
+    const work_stealing_executor::ptr_t & get_executor() const
+    { return _executor; }
+
+private:
+
+    void post_handler(const handler_t &);
+
+    void on_run();
+
+    const work_stealing_executor::ptr_t _executor;
+
+    spinlock _lock;
+    std::deque<handler_t> _handlers;
+    bool _running;
+};
+
+}
+}
+
+#endif
+
@@ -19,6 +19,12 @@ class mapped_rolling_hash;
 class persister;
 typedef boost::shared_ptr<persister> persister_ptr_t;
 
+class replication_log;
+typedef boost::shared_ptr<replication_log> replication_log_ptr_t;
+
+class record_cache;
+typedef boost::shared_ptr<record_cache> record_cache_ptr_t;
+
 }
 }
 
@@ -3,8 +3,12 @@
 #include "samoa/persistence/rolling_hash.hpp"
 #include "samoa/persistence/heap_rolling_hash.hpp"
 #include "samoa/persistence/mapped_rolling_hash.hpp"
+#include "samoa/persistence/record_cache.hpp"
+#include "samoa/core/protobuf_helpers.hpp"
+#include "samoa/core/streaming_copy.hpp"
 #include "samoa/core/proactor.hpp"
 #include "samoa/log.hpp"
+#include <google/protobuf/io/coded_stream.h>
 #include <boost/bind.hpp>
 #include <algorithm>
 
@@ -15,9 +19,10 @@ using namespace std;
 
 persister::persister()
  : _proactor(core::proactor::get_proactor()),
-   _strand(*_proactor->concurrent_io_service()),
+   _strand(_proactor->concurrent_executor()),
    _min_rotations(2),
-   _max_rotations(10)
+   _max_rotations(10),
+   _max_spill_length(1 << 16)
 {}
 
 persister::~persister()
@@ -50,11 +55,30 @@ void persister::add_mapped_hash(
         file, storage_size, index_size).release());
 }
 
+void persister::set_commit_callback(commit_callback_t && callback)
+{
+    _commit_callback = std::move(callback);
+}
+
+void persister::set_record_cache(const record_cache_ptr_t & cache)
+{
+    _record_cache = cache;
+}
+
 void persister::get(
     get_callback_t && callback,
     const std::string & key,
     spb::PersistedRecord & precord)
 {
+    if(_record_cache && _record_cache->get(key, precord))
+    {
+        // cache hit; we needn't serialize with the strand
+        _proactor->concurrent_executor()->post(
+            boost::bind<void>(std::move(callback),
+                boost::system::error_code(), true));
+        return;
+    }
+
     _strand.post(
         boost::bind(&persister::on_get,
             shared_from_this(),
@@ -93,9 +117,50 @@ void persister::drop(
             boost::ref(precord)));
 }
 
+void persister::get_batch(
+    batch_callback_t && callback,
+    batch_t & batch)
+{
+    bool all_cached = true;
+
+    for(auto it = batch.begin(); it != batch.end(); ++it)
+    {
+        it->found = _record_cache && \
+            _record_cache->get(*it->key, *it->local_record);
+
+        all_cached = all_cached && it->found;
+    }
+
+    if(all_cached)
+    {
+        // we needn't serialize with the strand
+        _proactor->concurrent_executor()->post(std::move(callback));
+        return;
+    }
+
+    _strand.post(
+        boost::bind(&persister::on_get_batch,
+            shared_from_this(),
+            std::move(callback),
+            boost::ref(batch)));
+}
+
+void persister::put_batch(
+    batch_callback_t && callback,
+    datamodel::merge_func_t && merge_func,
+    batch_t & batch)
+{
+    _strand.post(
+        boost::bind(&persister::on_put_batch,
+            shared_from_this(),
+            std::move(callback),
+            std::move(merge_func),
+            boost::ref(batch)));
+}
+
 unsigned persister::begin_iteration()
 {
-    spinlock::guard guard(_iterators_lock);
+    adaptive_lock::guard guard(_iterators_lock);
 
     unsigned i = 0;
     for(; i != _iterators.size(); ++i)
@@ -119,7 +184,7 @@ unsigned persister::begin_iteration()
 
 bool persister::iterate(iterate_callback_t && callback, unsigned ticket)
 {
-    spinlock::guard guard(_iterators_lock);
+    adaptive_lock::guard guard(_iterators_lock);
 
     SAMOA_ASSERT(_iterators.at(ticket).state != iterator::DEAD);
 
@@ -149,6 +214,54 @@ void persister::on_get(
     const get_callback_t & callback,
     const std::string & key,
     spb::PersistedRecord & precord)
+{
+    bool found = read_record(key, precord);
+    callback(boost::system::error_code(), found);
+}
+
+void persister::on_put(
+    const put_callback_t & put_callback,
+    const datamodel::merge_func_t & merge_func,
+    const std::string & key,
+    const spb::PersistedRecord & remote_precord,
+    spb::PersistedRecord & local_precord)
+{
+    datamodel::merge_result result;
+
+    boost::system::error_code ec = write_record(merge_func,
+        key, remote_precord, local_precord, result);
+
+    put_callback(ec, result);
+}
+
+void persister::on_get_batch(
+    const batch_callback_t & callback,
+    batch_t & batch)
+{
+    for(auto it = batch.begin(); it != batch.end(); ++it)
+    {
+        if(!it->found)
+            it->found = read_record(*it->key, *it->local_record);
+    }
+    callback();
+}
+
+void persister::on_put_batch(
+    const batch_callback_t & callback,
+    const datamodel::merge_func_t & merge_func,
+    batch_t & batch)
+{
+    for(auto it = batch.begin(); it != batch.end(); ++it)
+    {
+        it->error = write_record(merge_func, *it->key,
+            *it->remote_record, *it->local_record, it->merge_result);
+    }
+    callback();
+}
+
+bool persister::read_record(
+    const std::string & key,
+    spb::PersistedRecord & precord)
 {
     for(size_t i = 0; i != _layers.size(); ++i)
     {
@@ -159,23 +272,26 @@ void persister::on_get(
         SAMOA_ASSERT(precord.ParseFromArray(
             rec->value_begin(), rec->value_length()));
 
-        callback(boost::system::error_code(), true);
-        return;
+        if(_record_cache)
+        {
+            // populated from the strand, and so ordered with invalidations
+            _record_cache->insert(key, precord);
+        }
+        return true;
     }
-    callback(boost::system::error_code(), false);
+    return false;
 }
 
-void persister::on_put(
-    const put_callback_t & put_callback,
+boost::system::error_code persister::write_record(
     const datamodel::merge_func_t & merge_func,
     const std::string & key,
     const spb::PersistedRecord & remote_precord,
-    spb::PersistedRecord & local_precord)
+    spb::PersistedRecord & local_precord,
+    datamodel::merge_result & result)
 {
     unsigned value_length = remote_precord.ByteSize();
 
     // garden path result
-    datamodel::merge_result result;
     result.local_was_updated = true;
     result.remote_is_stale = false;
 
@@ -213,10 +329,8 @@ void persister::on_put(
     if(!_layers[0]->would_fit(key.length(), value_length))
     {
         // won't fit? return error to caller
-        put_callback(boost::system::errc::make_error_code(
-            boost::system::errc::not_enough_memory),
-            result);
-        return;
+        return boost::system::errc::make_error_code(
+            boost::system::errc::not_enough_memory);
     }
 
     record * new_rec = _layers[0]->prepare_record(
@@ -235,8 +349,7 @@ void persister::on_put(
         if(!result.local_was_updated)
         {
             // merge-callback aborted the write
-            put_callback(boost::system::error_code(), result);
-            return;
+            return boost::system::error_code();
         }
     }
     else
@@ -250,9 +363,25 @@ void persister::on_put(
     SAMOA_ASSERT(value_length <= new_rec->value_length());
 
     // write, trim, & commit record
-    local_precord.SerializeWithCachedSizesToArray(
-        reinterpret_cast<google::protobuf::uint8*>(
-            new_rec->value_begin()));
+    if(value_length < core::streaming_copy_threshold)
+    {
+        local_precord.SerializeWithCachedSizesToArray(
+            reinterpret_cast<google::protobuf::uint8*>(
+                new_rec->value_begin()));
+    }
+    else
+    {
+        // large values are written around the CPU cache
+        core::streaming_output_adapter so_adapter(
+            new_rec->value_begin(), value_length);
+        {
+            google::protobuf::io::CodedOutputStream coded_out(&so_adapter);
+            local_precord.SerializeWithCachedSizes(&coded_out);
+        }
+        so_adapter.flush();
+
+        SAMOA_ASSERT(so_adapter.ByteCount() == value_length);
+    }
 
     new_rec->trim_value_length(value_length);
     _layers[0]->commit_record(root_hint);
@@ -263,7 +392,17 @@ void persister::on_put(
         _layers[cur_layer]->mark_for_deletion(key.begin(), key.end(), cur_hint);
     }
 
-    put_callback(boost::system::error_code(), result);
+    if(_record_cache)
+    {
+        _record_cache->invalidate(key);
+    }
+
+    if(_commit_callback)
+    {
+        _commit_callback(key, rec, new_rec);
+    }
+
+    return boost::system::error_code();
 }
 
 void persister::on_drop(
@@ -283,6 +422,17 @@ void persister::on_drop(
             rec->value_begin(), rec->value_length()));
 
         layer.mark_for_deletion(key.begin(), key.end(), hint);
+
+        if(_record_cache)
+        {
+            _record_cache->invalidate(key);
+        }
+
+        if(_commit_callback)
+        {
+            _commit_callback(key, rec, 0);
+        }
+
         make_room(0, 0, 0, 0, 0);
 
         callback(boost::system::error_code(), true);
@@ -295,7 +445,7 @@ void persister::on_iterate(
     const iterate_callback_t & callback,
     size_t ticket)
 {
-    spinlock::guard guard(_iterators_lock);
+    adaptive_lock::guard guard(_iterators_lock);
 
     iterator & iter = _iterators[ticket];
     assert(!iter.state == iterator::DEAD);
@@ -356,7 +506,7 @@ bool persister::make_room(size_t key_length, size_t val_length,
 
     auto iterator_step = [&](rolling_hash & layer, const record * r)
     {
-        spinlock::guard guard(_iterators_lock);
+        adaptive_lock::guard guard(_iterators_lock);
         for(auto it = _iterators.begin(); it != _iterators.end(); ++it)
         {
             if(it->state == iterator::LIVE && it->rec == r)
@@ -364,39 +514,39 @@ bool persister::make_room(size_t key_length, size_t val_length,
         }
     };
 
-    auto rotate_down = [&](rolling_hash & layer, rolling_hash & next)-> bool
+    auto spill_down = [&](size_t layer)
     {
-        const record * head = layer.head();
-
-        assert(next.would_fit(head->key_length(), head->value_length()));
+        rolling_hash & hash = *_layers[layer];
+        rolling_hash & next = *_layers[layer + 1];
 
-        // allocate new record copy at tail of the next layer down
-        record * new_rec = next.prepare_record(
-            head->key_begin(), head->key_end(), head->value_length());
+        // hints into either layer may reference records of the spilled run
+        if(layer == 0 || layer == cur_layer || layer + 1 == cur_layer)
+        {
+            invalid = true;
+        }
 
-        std::copy(head->value_begin(), head->value_end(),
-            new_rec->value_begin());
+        const char * old_head = (const char *) hash.head();
+        const record * new_head = 0;
 
-        next.commit_record();
+        // move a run of live records to the tail of the next layer down
+        size_t run_length = hash.spill_head(next, _max_spill_length, &new_head);
+        SAMOA_ASSERT(run_length);
 
-        // shift any iterators pointed at head down to
-        //  the new record on the lower layer
+        // shift any iterators pointed into the run down to
+        //  the corresponding record on the lower layer
+        adaptive_lock::guard guard(_iterators_lock);
+        for(auto it = _iterators.begin(); it != _iterators.end(); ++it)
         {
-            spinlock::guard guard(_iterators_lock);
-            for(auto it = _iterators.begin(); it != _iterators.end(); ++it)
+            const char * it_rec = (const char *) it->rec;
+
+            if(it->state == iterator::LIVE &&
+               it_rec >= old_head && it_rec < old_head + run_length)
             {
-                if(it->state == iterator::LIVE && it->rec == head)
-                {
-                    it->layer += 1;
-                    it->rec = new_rec;
-                }
+                it->layer += 1;
+                it->rec = (const record *)(
+                    (const char *) new_head + (it_rec - old_head));
             }
         }
-
-        // mark original head record as dead, & reclaim
-        layer.mark_for_deletion(head->key_begin(), head->key_end());
-        layer.reclaim_head();
-        return true;
     };
 
     auto prep_leaf = [&](size_t trg_key, size_t trg_val) -> bool
@@ -452,8 +602,7 @@ bool persister::make_room(size_t key_length, size_t val_length,
                 if(!prep(layer + 1, head->key_length(), head->value_length()))
                     return false;
 
-                invalidates_check(layer);
-                rotate_down(hash, *_layers[layer+1]);
+                spill_down(layer);
             }
         }
         return true;
@@ -6,7 +6,8 @@
 #include "samoa/datamodel/merge_func.hpp"
 #include "samoa/core/protobuf/fwd.hpp"
 #include "samoa/core/fwd.hpp"
-#include "samoa/spinlock.hpp"
+#include "samoa/core/work_stealing_executor.hpp"
+#include "samoa/adaptive_lock.hpp"
 #include <boost/asio.hpp>
 #include <boost/function.hpp>
 #include <string>
@@ -38,6 +39,28 @@ public:
         const record * &)
     > iterate_callback_t;
 
+    //! A single key operation of a get_batch() or put_batch()
+    struct batch_entry
+    {
+        const std::string * key;
+        const spb::PersistedRecord * remote_record; // put_batch only
+        spb::PersistedRecord * local_record;
+
+        // set on completion
+        boost::system::error_code error;
+        bool found; // get_batch only
+        datamodel::merge_result merge_result; // put_batch only
+    };
+
+    typedef std::vector<batch_entry> batch_t;
+
+    typedef boost::function<void()> batch_callback_t;
+
+    typedef boost::function<void(
+        const std::string &, // key
+        const record *, // previous record, or nullptr
+        const record *) // written record, or nullptr if dropped
+    > commit_callback_t;
 
     persister();
     virtual ~persister();
@@ -47,6 +70,24 @@ public:
     void add_mapped_hash(const std::string & file,
         size_t storage_size, size_t index_size);
 
+    /*!
+     * Sets a callback to be invoked from persister's io_service as each
+     *  write or drop is committed. Records passed to the callback are
+     *  valid only for the duration of the call, and the callback must
+     *  not itself call into the persister.
+     */
+    void set_commit_callback(commit_callback_t &&);
+
+    /*!
+     * Sets a cache of decoded records to be consulted by get(). The
+     *  persister populates the cache as records are read, and
+     *  invalidates entries as their records are written or dropped.
+     */
+    void set_record_cache(const record_cache_ptr_t &);
+
+    const record_cache_ptr_t & get_record_cache() const
+    { return _record_cache; }
+
     void get(
         get_callback_t &&,
         const std::string & key, // referenced
@@ -64,6 +105,26 @@ public:
         const std::string & key, // referenced
         spb::PersistedRecord &); // referenced
 
+    /*!
+     * Reads each entry of the batch, as by get(). Entries missing from
+     *  the record cache are read within a single pass through the
+     *  persister's strand, and callback is invoked once all entries
+     *  have completed.
+     */
+    void get_batch(
+        batch_callback_t &&,
+        batch_t &); // referenced
+
+    /*!
+     * Writes each entry of the batch in order, as by put(), within a
+     *  single pass through the persister's strand. Callback is invoked
+     *  once all entries have completed.
+     */
+    void put_batch(
+        batch_callback_t &&,
+        datamodel::merge_func_t &&,
+        batch_t &); // referenced
+
     /*!
      * No preconditions
      * 
@@ -108,12 +169,33 @@ private:
         const std::string &,
         spb::PersistedRecord &);
 
+    void on_get_batch(const batch_callback_t &, batch_t &);
+
+    void on_put_batch(
+        const batch_callback_t &,
+        const datamodel::merge_func_t &,
+        batch_t &);
+
     void on_iterate(const iterate_callback_t &, size_t);
 
+    // reads key into the record, returning whether it was found
+    bool read_record(const std::string &, spb::PersistedRecord &);
+
+    // writes the merged record, returning an error if it couldn't fit
+    boost::system::error_code write_record(
+        const datamodel::merge_func_t &,
+        const std::string &,
+        const spb::PersistedRecord &,
+        spb::PersistedRecord &,
+        datamodel::merge_result &);
+
     bool make_room(size_t, size_t, record::offset_t, record::offset_t, size_t);
 
     std::vector<rolling_hash*> _layers;
 
+    commit_callback_t _commit_callback;
+    record_cache_ptr_t _record_cache;
+
     struct iterator {
         enum {
             DEAD,
@@ -126,13 +208,16 @@ private:
     };
     std::vector<iterator> _iterators;
 
-    spinlock _iterators_lock;
+    adaptive_lock _iterators_lock;
 
     core::proactor_ptr_t _proactor;
-    boost::asio::strand _strand;
+    core::work_stealing_executor::strand _strand;
 
     size_t _min_rotations;
     size_t _max_rotations;
+
+    // upper bound on bytes moved by a single layer spill
+    size_t _max_spill_length;
 };
 
 }
@@ -0,0 +1,195 @@
+#include "samoa/persistence/record_cache.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+#include "samoa/error.hpp"
+#include <boost/functional/hash.hpp>
+#include <boost/make_shared.hpp>
+
+namespace samoa {
+namespace persistence {
+
+// approximate bookkeeping overhead of an entry, beyond
+//  the key & decoded record themselves
+const size_t entry_overhead = sizeof(void*) * 8;
+
+record_cache::record_cache(size_t max_size)
+ : _shard_size(max_size / shard_count)
+{
+    for(size_t i = 0; i != shard_count; ++i)
+    {
+        _shards[i].hand = 0;
+        _shards[i].used_size = 0;
+        _shards[i].hit_count = 0;
+        _shards[i].miss_count = 0;
+        _shards[i].eviction_count = 0;
+    }
+}
+
+record_cache::shard & record_cache::shard_of(const std::string & key)
+{
+    return _shards[boost::hash<std::string>()(key) % shard_count];
+}
+
+bool record_cache::get(const std::string & key,
+    spb::PersistedRecord & record)
+{
+    shard & s = shard_of(key);
+    record_ptr_t cached;
+    {
+        spinlock::guard guard(s.lock);
+
+        auto it = s.index.find(key);
+        if(it == s.index.end())
+        {
+            s.miss_count += 1;
+            return false;
+        }
+
+        entry & e = s.entries[it->second];
+        e.referenced = true;
+        cached = e.record;
+
+        s.hit_count += 1;
+    }
+
+    // cached records are immutable; copy outside of the lock
+    record.CopyFrom(*cached);
+    return true;
+}
+
+void record_cache::insert(const std::string & key,
+    const spb::PersistedRecord & record)
+{
+    size_t size = key.size() + record.SpaceUsed() + entry_overhead;
+
+    if(size > _shard_size / 8)
+    {
+        // caching this record would displace too many others
+        invalidate(key);
+        return;
+    }
+
+    record_ptr_t cached = boost::make_shared<spb::PersistedRecord>(record);
+
+    shard & s = shard_of(key);
+    spinlock::guard guard(s.lock);
+
+    auto it = s.index.find(key);
+    if(it != s.index.end())
+    {
+        remove_entry(s, it->second);
+    }
+
+    while(s.used_size + size > _shard_size)
+    {
+        if(s.hand >= s.entries.size())
+            s.hand = 0;
+
+        entry & e = s.entries[s.hand];
+
+        if(e.referenced)
+        {
+            // give a second chance
+            e.referenced = false;
+            s.hand += 1;
+        }
+        else
+        {
+            remove_entry(s, s.hand);
+            s.eviction_count += 1;
+        }
+    }
+
+    s.index[key] = s.entries.size();
+    s.entries.push_back(entry({key, cached, size, false}));
+    s.used_size += size;
+}
+
+void record_cache::invalidate(const std::string & key)
+{
+    shard & s = shard_of(key);
+    spinlock::guard guard(s.lock);
+
+    auto it = s.index.find(key);
+    if(it != s.index.end())
+    {
+        remove_entry(s, it->second);
+    }
+}
+
+void record_cache::remove_entry(shard & s, size_t index)
+{
+    SAMOA_ASSERT(index < s.entries.size());
+
+    s.used_size -= s.entries[index].size;
+    s.index.erase(s.entries[index].key);
+
+    if(index + 1 != s.entries.size())
+    {
+        // fill the vacated slot with the final entry
+        std::swap(s.entries[index], s.entries.back());
+        s.index[s.entries[index].key] = index;
+    }
+    s.entries.pop_back();
+}
+
+size_t record_cache::total_size() const
+{ return _shard_size * shard_count; }
+
+size_t record_cache::used_size() const
+{
+    size_t result = 0;
+    for(size_t i = 0; i != shard_count; ++i)
+    {
+        spinlock::guard guard(_shards[i].lock);
+        result += _shards[i].used_size;
+    }
+    return result;
+}
+
+size_t record_cache::entry_count() const
+{
+    size_t result = 0;
+    for(size_t i = 0; i != shard_count; ++i)
+    {
+        spinlock::guard guard(_shards[i].lock);
+        result += _shards[i].entries.size();
+    }
+    return result;
+}
+
+uint64_t record_cache::hit_count() const
+{
+    uint64_t result = 0;
+    for(size_t i = 0; i != shard_count; ++i)
+    {
+        spinlock::guard guard(_shards[i].lock);
+        result += _shards[i].hit_count;
+    }
+    return result;
+}
+
+uint64_t record_cache::miss_count() const
+{
+    uint64_t result = 0;
+    for(size_t i = 0; i != shard_count; ++i)
+    {
+        spinlock::guard guard(_shards[i].lock);
+        result += _shards[i].miss_count;
+    }
+    return result;
+}
+
+uint64_t record_cache::eviction_count() const
+{
+    uint64_t result = 0;
+    for(size_t i = 0; i != shard_count; ++i)
+    {
+        spinlock::guard guard(_shards[i].lock);
+        result += _shards[i].eviction_count;
+    }
+    return result;
+}
+
+}
+}
+
@@ -0,0 +1,118 @@
+#ifndef SAMOA_PERSISTENCE_RECORD_CACHE_HPP
+#define SAMOA_PERSISTENCE_RECORD_CACHE_HPP
+
+#include "samoa/persistence/fwd.hpp"
+#include "samoa/core/protobuf/fwd.hpp"
+#include "samoa/spinlock.hpp"
+#include <boost/shared_ptr.hpp>
+#include <unordered_map>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace samoa {
+namespace persistence {
+
+namespace spb = samoa::core::protobuf;
+
+/*!
+ * A bounded cache of decoded PersistedRecords, by key.
+ *
+ * Hits are served with a copy of the decoded record, bypassing both the
+ *  persister's strand and a re-parse of the persisted record. Entries are
+ *  sharded by key hash, each shard being guarded by its own spinlock
+ *  and evicted under the CLOCK (second-chance) algorithm.
+ *
+ * The cache is not itself aware of writes; it's kept consistent by
+ *  the persister, which populates & invalidates it from its strand.
+ */
+class record_cache
+{
+public:
+
+    typedef record_cache_ptr_t ptr_t;
+
+    //! Constructs a cache of at most max_size bytes
+    explicit record_cache(size_t max_size);
+
+    /*
+    No Preconditions
+
+    Postconditions:
+     - if key is cached, record is assigned its cached value,
+       the entry is marked as referenced, and true is returned
+     - otherwise, false is returned
+    */
+    bool get(const std::string & key, spb::PersistedRecord & record);
+
+    /*
+    Preconditions:
+     - record is the current, committed value of key
+
+    Postconditions:
+     - key is cached with a copy of record, replacing any previous entry
+     - unreferenced entries are evicted as required to make room
+     - if the entry is too large to reasonably cache, it isn't cached
+    */
+    void insert(const std::string & key, const spb::PersistedRecord & record);
+
+    //! Removes any cached entry of key
+    void invalidate(const std::string & key);
+
+    // metrics
+
+    size_t total_size() const;
+    size_t used_size() const;
+
+    size_t entry_count() const;
+
+    uint64_t hit_count() const;
+    uint64_t miss_count() const;
+    uint64_t eviction_count() const;
+
+private:
+
+    typedef boost::shared_ptr<const spb::PersistedRecord> record_ptr_t;
+
+    struct entry
+    {
+        std::string key;
+        record_ptr_t record;
+        size_t size;
+        bool referenced;
+    };
+
+    struct shard
+    {
+        mutable spinlock lock;
+
+        std::unordered_map<std::string, size_t> index;
+        std::vector<entry> entries;
+
+        // CLOCK hand, as an index into entries
+        size_t hand;
+        size_t used_size;
+
+        uint64_t hit_count;
+        uint64_t miss_count;
+        uint64_t eviction_count;
+    };
+
+    enum {
+        shard_count = 16
+    };
+
+    shard & shard_of(const std::string & key);
+
+    // Preconditions: shard lock is held
+    void remove_entry(shard &, size_t index);
+
+    const size_t _shard_size;
+    shard _shards[shard_count];
+};
+
+}
+}
+
+#endif
+
@@ -0,0 +1,321 @@
+
+#include "samoa/persistence/replication_log.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+#include "samoa/error.hpp"
+#include <google/protobuf/io/coded_stream.h>
+#include <boost/interprocess/anonymous_shared_memory.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <sys/time.h>
+#include <fstream>
+
+namespace samoa {
+namespace persistence {
+
+namespace bip = boost::interprocess;
+
+typedef std::unique_ptr<bip::file_mapping> file_mapping_ptr_t;
+typedef std::unique_ptr<bip::file_lock> file_lock_ptr_t;
+typedef std::unique_ptr<bip::mapped_region> mapped_region_ptr_t;
+
+typedef google::protobuf::io::CodedOutputStream coded_output_t;
+
+enum log_state_enum {
+    FROZEN = 0xf1f1f1f1,
+    ACTIVE = FROZEN + 1
+};
+
+// ReplicationLogEntry field tags, as length-delimited (wire-type 2)
+const uint32_t key_tag = (1 << 3) | 2;
+const uint32_t cluster_clock_tag = (2 << 3) | 2;
+
+struct replication_log::log_header
+{
+    unsigned state;
+    unsigned reserved;
+    uint64_t region_size;
+
+    uint64_t begin_sequence;
+    uint64_t end_sequence;
+
+    // offset of first entry
+    uint64_t begin;
+    // 1 beyond last entry
+    uint64_t end;
+    // if end < begin, 1 beyond final entry
+    uint64_t wrap;
+};
+
+struct replication_log::entry_header
+{
+    uint64_t sequence;
+    uint32_t length;
+    uint32_t reserved;
+
+    // entries are 8-byte aligned
+    static uint64_t allocated_size(uint32_t length)
+    { return (sizeof(entry_header) + length + 7) & ~uint64_t(7); }
+
+    char * begin()
+    { return (char*)(this + 1); }
+};
+
+// private implementation pattern for boost::interprocess state
+struct replication_log::pimpl_t
+{
+    file_lock_ptr_t     flock;
+    file_mapping_ptr_t  fmapping;
+    mapped_region_ptr_t mregion;
+};
+
+replication_log::replication_log(size_t region_size)
+ : _pimpl(new pimpl_t())
+{
+    _pimpl->mregion.reset(new bip::mapped_region(
+        bip::anonymous_shared_memory(region_size)));
+
+    init(region_size);
+}
+
+replication_log::replication_log(
+    const std::string & file, size_t region_size)
+ : _pimpl(new pimpl_t())
+{
+    if(std::ifstream(file.c_str()).fail())
+    {
+        std::ofstream tmp(file.c_str());
+        if(tmp.fail())
+            throw std::runtime_error("Failed to open " + file);
+
+        tmp.seekp(region_size);
+        tmp.put(0);
+
+        if(tmp.fail())
+            throw std::runtime_error("Failed to size " + file);
+    }
+
+    // obtain a lock on the file
+    _pimpl->flock.reset(new bip::file_lock(file.c_str()));
+    if(!_pimpl->flock->try_lock())
+        throw std::runtime_error(file + " is locked");
+
+    // open the file in read/write mode for mapping
+    _pimpl->fmapping.reset(
+        new bip::file_mapping(file.c_str(), bip::read_write));
+
+    // map complete file to a chunk of address space
+    _pimpl->mregion.reset(new bip::mapped_region(
+        *_pimpl->fmapping, bip::read_write, 0, region_size));
+
+    init(region_size);
+}
+
+replication_log::~replication_log()
+{
+    if(_pimpl->fmapping)
+    {
+        // persist log by 'freezing' it & flushing
+        _hdr->state = FROZEN;
+        _pimpl->mregion->flush();
+    }
+}
+
+void replication_log::init(size_t region_size)
+{
+    _region_ptr = (char*) _pimpl->mregion->get_address();
+    _hdr = (log_header*) _region_ptr;
+
+    if(region_size < entries_offset() + entry_header::allocated_size(0))
+    {
+        throw std::runtime_error("replication_log::replication_log(): "
+            "region_size too small");
+    }
+
+    if(_hdr->state == FROZEN)
+    {
+        // this is a persisted log; resume it
+        if(_hdr->region_size != region_size)
+            throw std::runtime_error("replication_log::replication_log(): "
+                "stored region_size != region_size");
+    }
+    else
+    {
+        // sequences of a new log begin at the current time in
+        //  microseconds, so that sequences a peer observed of a
+        //  previous (eg, heap-backed) incarnation of this log
+        //  will always precede it
+        timeval tv;
+        gettimeofday(&tv, 0);
+
+        _hdr->region_size = region_size;
+        _hdr->begin_sequence = _hdr->end_sequence = \
+            uint64_t(tv.tv_sec) * 1000000 + tv.tv_usec;
+        _hdr->begin = _hdr->end = entries_offset();
+        _hdr->wrap = 0;
+    }
+    _hdr->state = ACTIVE;
+}
+
+size_t replication_log::entries_offset() const
+{ return sizeof(log_header); }
+
+void replication_log::reclaim_head()
+{
+    entry_header * head = (entry_header*)(_region_ptr + _hdr->begin);
+
+    _hdr->begin += entry_header::allocated_size(head->length);
+    _hdr->begin_sequence += 1;
+
+    if(_hdr->begin == _hdr->wrap)
+    {
+        _hdr->wrap = 0;
+        _hdr->begin = entries_offset();
+    }
+    if(!_hdr->wrap && _hdr->begin == _hdr->end)
+    {
+        // empty; re-base
+        _hdr->begin = _hdr->end = entries_offset();
+    }
+}
+
+uint64_t replication_log::append(
+    const std::string & key, const spb::ClusterClock & clock)
+{
+    uint32_t clock_length = clock.ByteSize();
+
+    uint32_t length = \
+        coded_output_t::VarintSize32(key_tag) +
+        coded_output_t::VarintSize32(key.size()) + key.size() +
+        coded_output_t::VarintSize32(cluster_clock_tag) +
+        coded_output_t::VarintSize32(clock_length) + clock_length;
+
+    uint64_t alloc_size = entry_header::allocated_size(length);
+
+    spinlock::guard guard(_lock);
+
+    if(alloc_size > _hdr->region_size - entries_offset())
+    {
+        // this entry can never fit; discard the entire log
+        _hdr->begin = _hdr->end = entries_offset();
+        _hdr->wrap = 0;
+
+        uint64_t sequence = _hdr->end_sequence++;
+        _hdr->begin_sequence = _hdr->end_sequence;
+        return sequence;
+    }
+
+    while(true)
+    {
+        if(!_hdr->wrap)
+        {
+            // begin <= end
+            if(_hdr->end + alloc_size <= _hdr->region_size)
+                break;
+
+            // wrap ring tail to the region beginning
+            _hdr->wrap = _hdr->end;
+            _hdr->end = entries_offset();
+        }
+        else if(_hdr->end + alloc_size <= _hdr->begin)
+        {
+            // end < begin, with room between
+            break;
+        }
+        else
+        {
+            reclaim_head();
+        }
+    }
+
+    entry_header * entry = (entry_header*)(_region_ptr + _hdr->end);
+    entry->sequence = _hdr->end_sequence;
+    entry->length = length;
+    entry->reserved = 0;
+
+    // write a ReplicationLogEntry directly in wire format
+    google::protobuf::uint8 * out = \
+        (google::protobuf::uint8*) entry->begin();
+
+    out = coded_output_t::WriteVarint32ToArray(key_tag, out);
+    out = coded_output_t::WriteVarint32ToArray(key.size(), out);
+    out = coded_output_t::WriteRawToArray(key.data(), key.size(), out);
+    out = coded_output_t::WriteVarint32ToArray(cluster_clock_tag, out);
+    out = coded_output_t::WriteVarint32ToArray(clock_length, out);
+    out = clock.SerializeWithCachedSizesToArray(out);
+
+    SAMOA_ASSERT((char*) out == entry->begin() + length);
+
+    _hdr->end += alloc_size;
+    return _hdr->end_sequence++;
+}
+
+bool replication_log::read(uint64_t sequence, size_t max_entries,
+    std::vector<std::string> & entries, uint64_t & next_sequence) const
+{
+    spinlock::guard guard(_lock);
+
+    if(sequence < _hdr->begin_sequence || sequence > _hdr->end_sequence)
+    {
+        next_sequence = _hdr->end_sequence;
+        return false;
+    }
+
+    uint64_t offset = _hdr->begin;
+    uint64_t wrap = _hdr->wrap;
+    size_t count = 0;
+
+    for(uint64_t cur = _hdr->begin_sequence;
+        cur != _hdr->end_sequence && count != max_entries; ++cur)
+    {
+        if(offset == wrap)
+        {
+            wrap = 0;
+            offset = entries_offset();
+        }
+
+        entry_header * entry = (entry_header*)(_region_ptr + offset);
+        SAMOA_ASSERT(entry->sequence == cur);
+
+        if(cur >= sequence)
+        {
+            entries.push_back(std::string(
+                entry->begin(), entry->begin() + entry->length));
+            count += 1;
+        }
+        offset += entry_header::allocated_size(entry->length);
+    }
+
+    next_sequence = sequence + count;
+    return true;
+}
+
+uint64_t replication_log::begin_sequence() const
+{
+    spinlock::guard guard(_lock);
+    return _hdr->begin_sequence;
+}
+
+uint64_t replication_log::end_sequence() const
+{
+    spinlock::guard guard(_lock);
+    return _hdr->end_sequence;
+}
+
+size_t replication_log::total_region_size() const
+{ return _hdr->region_size; }
+
+size_t replication_log::used_region_size() const
+{
+    spinlock::guard guard(_lock);
+
+    if(_hdr->wrap)
+    {
+        return _hdr->end + (_hdr->wrap - _hdr->begin);
+    }
+    return entries_offset() + (_hdr->end - _hdr->begin);
+}
+
+}
+}
+
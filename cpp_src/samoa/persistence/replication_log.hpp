@@ -0,0 +1,110 @@
+#ifndef SAMOA_PERSISTENCE_REPLICATION_LOG_HPP
+#define SAMOA_PERSISTENCE_REPLICATION_LOG_HPP
+
+#include "samoa/persistence/fwd.hpp"
+#include "samoa/core/protobuf/fwd.hpp"
+#include "samoa/spinlock.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace samoa {
+namespace persistence {
+
+namespace spb = samoa::core::protobuf;
+
+/*!
+ * A bounded, memory-mapped ring of recently committed writes.
+ *
+ * Each committed write is logged as a serialized ReplicationLogEntry
+ *  (the written key & its resulting cluster clock), and is assigned
+ *  the next value of a monotonic sequence. When the ring is full, the
+ *  oldest entries are discarded to make room.
+ *
+ * A peer which has observed the log through sequence N may catch up
+ *  by reading all entries since N, provided N hasn't been discarded.
+ *  If it has, the peer must instead fall back to a full iteration.
+ */
+class replication_log
+{
+public:
+
+    typedef replication_log_ptr_t ptr_t;
+
+    //! Constructs a log over an anonymous mapping of region_size bytes
+    explicit replication_log(size_t region_size);
+
+    //! Constructs a log over the (possibly pre-existing) file mapping
+    /*!
+        A log previously persisted to file resumes its sequence.
+    */
+    replication_log(const std::string & file, size_t region_size);
+
+    ~replication_log();
+
+    /*
+    Preconditions:
+     - key was just committed, with resulting cluster_clock
+
+    Postconditions:
+     - an entry for the write is appended, and its sequence is returned
+     - entries are discarded from the log head as required to make room
+     - if the entry is larger than the entire log, all entries
+       are discarded (and it's not logged)
+    */
+    uint64_t append(const std::string & key, const spb::ClusterClock &);
+
+    /*
+    No Preconditions
+
+    Postconditions:
+     - if sequence is in [begin_sequence(), end_sequence()], up to
+       max_entries serialized ReplicationLogEntry's starting at sequence
+       are appended to entries, next_sequence is set to the sequence
+       following the last returned entry, and true is returned
+     - otherwise, entries since sequence have been discarded (or are
+       from a prior incarnation of the log), next_sequence is set to
+       end_sequence(), and false is returned
+    */
+    bool read(uint64_t sequence, size_t max_entries,
+        std::vector<std::string> & entries, uint64_t & next_sequence) const;
+
+    //! Sequence of the oldest retained entry
+    uint64_t begin_sequence() const;
+
+    //! Sequence which will be assigned to the next appended entry
+    uint64_t end_sequence() const;
+
+    // metrics
+
+    size_t total_region_size() const;
+    size_t used_region_size() const;
+
+private:
+
+    struct log_header;
+    struct entry_header;
+
+    struct pimpl_t;
+    typedef std::unique_ptr<pimpl_t> pimpl_ptr_t;
+
+    void init(size_t region_size);
+
+    size_t entries_offset() const;
+
+    void reclaim_head();
+
+    pimpl_ptr_t _pimpl;
+
+    char * _region_ptr;
+    log_header * _hdr;
+
+    mutable spinlock _lock;
+};
+
+}
+}
+
+#endif
+
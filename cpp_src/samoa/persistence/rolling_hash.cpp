@@ -1,5 +1,6 @@
 
 #include "samoa/persistence/rolling_hash.hpp"
+#include "samoa/core/streaming_copy.hpp"
 #include <string.h>
 
 namespace samoa {
@@ -188,13 +189,21 @@ void rolling_hash::rotate_head()
     // copy raw bytes of record from old to new location
     // Big Fat Note: we're quite possibly overwriting the old record as
     // we write the new one. This is only safely done by copying-forward
-    if(rec_begin != _tbl.end)
+    if(rec_begin != _tbl.end && rec_len < core::streaming_copy_threshold)
     {
         std::copy(
             _region_ptr + rec_begin,
             _region_ptr + rec_begin + rec_len,
             _region_ptr + _tbl.end);
     }
+    else if(rec_begin != _tbl.end)
+    {
+        // large record: bypass the CPU cache (also copies-forward)
+        core::streaming_copy(
+            (char*) _region_ptr + rec_begin,
+            (char*) _region_ptr + rec_begin + rec_len,
+            (char*) _region_ptr + _tbl.end);
+    }
 
     // update the previous link in the hash chain to point to new_rec
     // the pointer we're updating here may be the next field of another
@@ -204,6 +213,165 @@ void rolling_hash::rotate_head()
     _tbl.end += rec_len;
 }
 
+offset_t rolling_hash::spill_head(rolling_hash & next,
+    offset_t max_length, const record ** moved_head /* = 0 */)
+{
+    // empty?
+    if(!_tbl.wrap && _tbl.begin == _tbl.end)
+        throw std::underflow_error("rolling_hash::spill_head(): empty");
+
+    if(&next == this)
+        throw std::invalid_argument("rolling_hash::spill_head(): "
+            "cannot spill into self");
+
+    record * head = (record*)(_region_ptr + _tbl.begin);
+
+    if(head->is_dead())
+    {
+        throw std::runtime_error("rolling_hash::spill_head(): "
+            "head is marked for deletion");
+    }
+
+    table_header & trg = next._tbl;
+
+    // an empty target ring can be re-based, which maximizes the
+    //  contiguous space available to us (applied only if we spill)
+    bool trg_rebase = !trg.wrap && trg.begin == trg.end;
+
+    // identify the contiguous target region into which the run is copied.
+    //  this mirrors would_fit(), so a successful would_fit() for the
+    //  head record guarantees that it's included in the run
+    offset_t head_len = record::allocated_size(
+        head->key_length(), head->value_length());
+
+    offset_t trg_begin, trg_avail;
+    bool trg_wraps = false;
+
+    if(trg_rebase)
+    {
+        trg_begin = next.records_offset();
+        trg_avail = trg.region_size - trg_begin;
+    }
+    else if(trg.wrap)
+    {
+        trg_begin = trg.end;
+        trg_avail = trg.begin - trg.end;
+    }
+    else if(trg.end + head_len <= trg.region_size)
+    {
+        trg_begin = trg.end;
+        trg_avail = trg.region_size - trg.end;
+    }
+    else
+    {
+        trg_begin = next.records_offset();
+        trg_avail = trg.begin - next.records_offset();
+        trg_wraps = true;
+    }
+
+    // the source run is contiguous up to the wrap-point of this ring
+    offset_t src_end = _tbl.wrap ? _tbl.wrap : _tbl.end;
+    offset_t run_len = 0, run_count = 0;
+
+    for(offset_t cur = _tbl.begin; cur != src_end; ++run_count)
+    {
+        const record * rec = (const record*)(_region_ptr + cur);
+
+        if(rec->is_dead())
+            break;
+
+        offset_t rec_len = record::allocated_size(
+            rec->key_length(), rec->value_length());
+
+        if(run_len + rec_len > trg_avail)
+            break;
+        if(run_len && run_len + rec_len > max_length)
+            break;
+
+        run_len += rec_len;
+        cur += rec_len;
+    }
+
+    if(!run_len)
+        return 0;
+
+    if(trg_rebase)
+    {
+        trg.begin = trg.end = next.records_offset();
+    }
+    else if(trg_wraps)
+    {
+        trg.wrap = trg.end;
+        trg.end = next.records_offset();
+    }
+
+    // single bulk copy of the run; regions are distinct
+    if(run_len < core::streaming_copy_threshold)
+    {
+        memcpy(next._region_ptr + trg_begin,
+            _region_ptr + _tbl.begin, run_len);
+    }
+    else
+    {
+        core::streaming_copy(
+            (char*) _region_ptr + _tbl.begin,
+            (char*) _region_ptr + _tbl.begin + run_len,
+            (char*) next._region_ptr + trg_begin);
+    }
+
+    for(offset_t cur = 0; cur != run_len;)
+    {
+        record * src_rec = (record*)(_region_ptr + _tbl.begin + cur);
+        record * trg_rec = (record*)(next._region_ptr + trg_begin + cur);
+
+        // unlink source record from it's hash chain
+        offset_t src_ptr_ptr;
+        get(src_rec->key_begin(), src_rec->key_end(), &src_ptr_ptr);
+        assert(*(offset_t*)(_region_ptr + src_ptr_ptr) == _tbl.begin + cur);
+
+        *(offset_t*)(_region_ptr + src_ptr_ptr) = src_rec->next();
+
+        // link copied record into the target's hash chain
+        offset_t trg_ptr_ptr;
+        record * old_rec = (record*) next.get(
+            trg_rec->key_begin(), trg_rec->key_end(), &trg_ptr_ptr);
+
+        if(old_rec)
+        {
+            trg_rec->set_next(old_rec->next());
+            old_rec->mark_as_dead();
+        }
+        else
+        {
+            trg_rec->set_next(0);
+            trg.live_record_count += 1;
+        }
+        *(offset_t*)(next._region_ptr + trg_ptr_ptr) = trg_begin + cur;
+
+        cur += record::allocated_size(
+            src_rec->key_length(), src_rec->value_length());
+    }
+
+    trg.end = trg_begin + run_len;
+    trg.total_record_count += run_count;
+
+    // reclaim the run from this ring
+    _tbl.begin += run_len;
+    assert(!_tbl.wrap || _tbl.begin <= _tbl.wrap);
+
+    if(_tbl.begin == _tbl.wrap)
+    {
+        _tbl.wrap = 0;
+        _tbl.begin = records_offset();
+    }
+    _tbl.total_record_count -= run_count;
+    _tbl.live_record_count -= run_count;
+
+    if(moved_head)
+        *moved_head = (const record*)(next._region_ptr + trg_begin);
+
+    return run_len;
+}
 
 const record * rolling_hash::head() const
 {
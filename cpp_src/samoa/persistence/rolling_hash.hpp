@@ -123,6 +123,30 @@ public:
     */
     void rotate_head();
 
+    /*
+    Preconditions:
+     - head()->is_dead() is false; eg the ring head is a live record
+     - next is a rolling_hash other than this one
+
+    Postconditions:
+     - a run of contiguous, live records beginning at the ring head is
+       moved to the tail of next with a single bulk copy, and indexed
+       by next (superseding any records of next under the same keys)
+     - the run is bounded by max_length, but always includes the head
+       if next has contiguous room for it
+     - memory of the run is reclaimed from this ring
+     - the byte-length of the run is returned; if next can't hold the
+       head record, 0 is returned and no changes are made
+     - if moved_head != nullptr, it's updated with the new location
+       of the previous head (records of the run keep relative offsets)
+     - step(record) is no longer valid for any record of the run
+
+    spill_head() is the bulk equivalent of rotating head records
+     into a lower layer one prepare_record()/commit_record() at a time.
+    */
+    offset_t spill_head(rolling_hash & next, offset_t max_length,
+        const record ** moved_head = 0);
+
     /*
     No Preconditions
 
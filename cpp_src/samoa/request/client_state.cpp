@@ -3,14 +3,25 @@
 #include "samoa/request/request_state.hpp"
 #include "samoa/request/state_exception.hpp"
 #include "samoa/server/client.hpp"
+#include "samoa/core/protobuf_helpers.hpp"
 #include "samoa/core/uuid.hpp"
+#include "samoa/server/request_scheduler.hpp"
+#include "samoa/log.hpp"
 #include <boost/bind.hpp>
+#include <memory>
 
 namespace samoa {
 namespace request {
 
 client_state::client_state()
- : _flush_response_called(false)
+ : _flush_response_called(false),
+   _request_bytes(0)
+{ }
+
+client_state::client_state(core::arena & arena)
+ : _request_data_blocks(core::arena_allocator<core::buffer_regions_t>(arena)),
+   _flush_response_called(false),
+   _request_bytes(0)
 { }
 
 client_state::~client_state()
@@ -78,6 +89,13 @@ void client_state::send_error(const state::ptr_t & guard,
     send_error(guard, err_code, tmp.str());
 }
 
+void client_state::set_request_scheduler(
+    const server::request_scheduler_ptr_t & scheduler)
+{
+    SAMOA_ASSERT(!_request_scheduler);
+    _request_scheduler = scheduler;
+}
+
 void client_state::load_client_state(const server::client::ptr_t & client)
 {
     SAMOA_ASSERT(!_client);
@@ -86,10 +104,26 @@ void client_state::load_client_state(const server::client::ptr_t & client)
 
 void client_state::reset_client_state()
 {
+    if(_request_bytes)
+    {
+        // the request's buffers & work are released with this state
+        _client->release_request_bytes(_request_bytes);
+        _request_bytes = 0;
+    }
+
+    if(_request_scheduler)
+    {
+        // admit the next request queued by the scheduler
+        _request_scheduler->release();
+        _request_scheduler.reset();
+    }
+
     _client.reset();
     _samoa_request.Clear();
     _samoa_response.Clear();
-    _request_data_blocks.clear();
+    // release (rather than clear) allocations, as the arena may be released
+    data_blocks_t(_request_data_blocks.get_allocator()
+        ).swap(_request_data_blocks);
     _response_data.clear();
     _flush_response_called = false;
 }
@@ -106,18 +140,49 @@ void client_state::on_response(server::client::response_interface iface,
         _samoa_response.set_type(_samoa_request.type());
     }
 
+    // advertise our protocol version
+    _samoa_response.set_protocol_version(SAMOA_PROTOCOL_VERSION);
+
     // serlialize & queue core::protobuf::SamoaResponse for writing
-    core::zero_copy_output_adapter zco_adapter;
-    _samoa_response.SerializeToZeroCopyStream(&zco_adapter);
+    std::unique_ptr<core::zero_copy_output_adapter> zco_adapter(
+        new core::zero_copy_output_adapter());
+    zco_adapter->serialize(_samoa_response);
+
+    unsigned protocol_version = _client->get_response_protocol_version();
+
+    if(!core::frame_length_supported(zco_adapter->ByteCount(),
+        protocol_version))
+    {
+        LOG_WARN("response of " << zco_adapter->ByteCount() << " bytes "
+            "exceeds frame limits of protocol version "
+            << protocol_version);
+
+        // replace with an error response, which the client can accept
+        _samoa_response.Clear();
+        _samoa_response.set_request_id(_samoa_request.request_id());
+        _samoa_response.set_type(spb::ERROR);
+        _samoa_response.mutable_error()->set_code(413);
+        _samoa_response.mutable_error()->set_message(
+            "response too large for the client's protocol version");
+        _samoa_response.set_protocol_version(SAMOA_PROTOCOL_VERSION);
+        _response_data.clear();
+
+        zco_adapter.reset(new core::zero_copy_output_adapter());
+        zco_adapter->serialize(_samoa_response);
+    }
+
+    // write network order length preamble
+    char preamble[MAX_FRAME_PREAMBLE_SIZE];
+    char * preamble_end = preamble + core::write_frame_preamble(
+        zco_adapter->ByteCount(), protocol_version, preamble);
 
-    SAMOA_ASSERT(zco_adapter.ByteCount() < (1<<16));
+    // subsequent responses may be extended frames
+    _client->set_response_version_advertised();
 
-    // write network order unsigned short length
-    uint16_t len = htons((uint16_t)zco_adapter.ByteCount());
-    iface.write_interface().queue_write((char*)&len, ((char*)&len) + 2);
+    iface.write_interface().queue_write((char*) preamble, preamble_end);
 
     // write serialized SamoaResponse output regions
-    iface.write_interface().queue_write(zco_adapter.output_regions());
+    iface.write_interface().queue_write(zco_adapter->output_regions());
 
     // write spooled data blocks
     iface.write_interface().queue_write(_response_data);
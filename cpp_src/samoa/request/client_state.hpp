@@ -5,6 +5,7 @@
 #include "samoa/server/client.hpp"
 #include "samoa/core/protobuf/samoa.pb.h"
 #include "samoa/core/buffer_region.hpp"
+#include "samoa/core/arena.hpp"
 #include <boost/shared_ptr.hpp>
 
 namespace samoa {
@@ -18,6 +19,9 @@ public:
 
     client_state();
 
+    //! Request data-blocks are allocated from the arena
+    explicit client_state(core::arena &);
+
     virtual ~client_state();
 
     /*!
@@ -42,13 +46,13 @@ public:
     /*!
      * Retrives the (const) data-blocks which accompany the client's request
      */
-    const std::vector<core::buffer_regions_t> & get_request_data_blocks() const
+    const data_blocks_t & get_request_data_blocks() const
     { return _request_data_blocks; }
 
     /*!
      * Retrives the (mutable) data-blocks; for use in fillout out the container
      */
-    std::vector<core::buffer_regions_t> & mutable_request_data_blocks()
+    data_blocks_t & mutable_request_data_blocks()
     { return _request_data_blocks; }
 
     /*!
@@ -124,6 +128,12 @@ public:
     void send_error(const state_ptr_t & guard, unsigned err_code,
         const boost::system::error_code & err_msg);
 
+    /*!
+     * Sets the scheduler which admitted the request. Its admission
+     *  is released as the client_state is reset
+     */
+    void set_request_scheduler(const server::request_scheduler_ptr_t &);
+
     void load_client_state(const server::client_ptr_t & client);
 
     void reset_client_state();
@@ -140,11 +150,16 @@ private:
     spb::SamoaRequest   _samoa_request;
     spb::SamoaResponse _samoa_response;
 
-    std::vector<core::buffer_regions_t> _request_data_blocks;
+    data_blocks_t _request_data_blocks;
     core::const_buffer_regions_t _response_data;
 
     bool _flush_response_called;
     core::buffer_ring _w_ring;
+
+    // charged against the client's request byte budgets
+    size_t _request_bytes;
+
+    server::request_scheduler_ptr_t _request_scheduler;
 };
 
 }
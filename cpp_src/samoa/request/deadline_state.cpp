@@ -0,0 +1,78 @@
+#include "samoa/request/deadline_state.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+#include "samoa/error.hpp"
+#include <boost/asio/deadline_timer.hpp>
+
+namespace samoa {
+namespace request {
+
+typedef boost::asio::deadline_timer::traits_type time_traits_t;
+
+static unsigned expired_count = 0;
+
+deadline_state::deadline_state()
+ : _expired(0)
+{ }
+
+deadline_state::~deadline_state()
+{ }
+
+unsigned deadline_state::get_remaining_ms() const
+{
+    SAMOA_ASSERT(has_deadline());
+
+    boost::posix_time::time_duration remaining = \
+        _deadline - time_traits_t::now();
+
+    if(remaining.is_negative())
+        return 0;
+
+    return remaining.total_milliseconds();
+}
+
+bool deadline_state::is_expired() const
+{
+    return has_deadline() && time_traits_t::now() >= _deadline;
+}
+
+bool deadline_state::check_deadline()
+{
+    if(!is_expired())
+        return false;
+
+    // checks may race from multiple peer io_services;
+    //  only the first to observe the expiry counts it
+    if(__sync_bool_compare_and_swap(&_expired, 0, 1))
+    {
+        __sync_fetch_and_add(&expired_count, 1);
+    }
+    return true;
+}
+
+void deadline_state::propagate_deadline(
+    core::protobuf::SamoaRequest & request) const
+{
+    if(has_deadline())
+        request.set_timeout_ms(get_remaining_ms());
+    else
+        request.clear_timeout_ms();
+}
+
+unsigned deadline_state::get_expired_count()
+{ return __sync_fetch_and_add(&expired_count, 0); }
+
+void deadline_state::load_deadline_state(unsigned timeout_ms)
+{
+    _deadline = time_traits_t::now() + \
+        boost::posix_time::milliseconds(timeout_ms);
+}
+
+void deadline_state::reset_deadline_state()
+{
+    _deadline = boost::posix_time::ptime();
+    _expired = 0;
+}
+
+}
+}
+
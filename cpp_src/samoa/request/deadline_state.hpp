@@ -0,0 +1,68 @@
+#ifndef SAMOA_REQUEST_DEADLINE_STATE_HPP
+#define SAMOA_REQUEST_DEADLINE_STATE_HPP
+
+#include "samoa/core/protobuf/fwd.hpp"
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace samoa {
+namespace request {
+
+/*!
+ * Deadline by which the requester abandons the request.
+ *
+ * Deadlines travel on the wire as a relative timeout_ms, as servers'
+ *  clocks needn't agree, and are held as an absolute time from receipt
+ *  of the request. A request without a timeout never expires.
+ */
+class deadline_state
+{
+public:
+
+    deadline_state();
+
+    virtual ~deadline_state();
+
+    bool has_deadline() const
+    { return !_deadline.is_not_a_date_time(); }
+
+    /*!
+     * Milliseconds remaining until the deadline, or zero if passed.
+     * Precondition: has_deadline()
+     */
+    unsigned get_remaining_ms() const;
+
+    //! Whether the request has a deadline which has passed
+    bool is_expired() const;
+
+    /*!
+     * As is_expired(), but counts the request as expired on
+     *  the first such check which fails
+     */
+    bool check_deadline();
+
+    /*!
+     * Sets the timeout of a request made on behalf of this
+     *  one to the time remaining, if the request has a deadline
+     */
+    void propagate_deadline(core::protobuf::SamoaRequest &) const;
+
+    //! Count of requests found to be expired, since startup
+    static unsigned get_expired_count();
+
+    void load_deadline_state(unsigned timeout_ms);
+
+    void reset_deadline_state();
+
+private:
+
+    boost::posix_time::ptime _deadline;
+
+    // set (once) by check_deadline(), via atomic compare-and-swap
+    unsigned _expired;
+};
+
+}
+}
+
+#endif
+
@@ -1,7 +1,10 @@
 #ifndef SAMOA_REQUEST_FWD_HPP
 #define SAMOA_REQUEST_FWD_HPP
 
+#include "samoa/core/fwd.hpp"
+#include "samoa/core/buffer_region.hpp"
 #include <boost/shared_ptr.hpp>
+#include <vector>
 
 namespace samoa {
 namespace request {
@@ -13,10 +16,15 @@ class table_state;
 class route_state;
 class record_state;
 class replication_state;
+class deadline_state;
 
 class state;
 typedef boost::shared_ptr<state> state_ptr_t;
 
+//! Data-blocks of a request, allocated from the request::state arena
+typedef std::vector<core::buffer_regions_t,
+    core::arena_allocator<core::buffer_regions_t> > data_blocks_t;
+
 }
 }
 
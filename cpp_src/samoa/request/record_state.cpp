@@ -4,9 +4,31 @@
 namespace samoa {
 namespace request {
 
+// blob-value capacity beyond which a record is released on reset
+const size_t max_retained_value_capacity = 1 << 16;
+
+static void reset_record(spb::PersistedRecord & record)
+{
+    for(int i = 0; i != record.blob_value_size(); ++i)
+    {
+        if(record.blob_value(i).capacity() > max_retained_value_capacity)
+        {
+            spb::PersistedRecord().Swap(&record);
+            return;
+        }
+    }
+    record.Clear();
+}
+
 record_state::~record_state()
 { }
 
+void record_state::reset_record_state()
+{
+    reset_record(_local_record);
+    reset_record(_remote_record);
+}
+
 }
 }
 
@@ -23,11 +23,12 @@ public:
     spb::PersistedRecord & get_remote_record()
     { return _remote_record; }
 
-    void reset_record_state()
-    {
-        _local_record.Clear();
-        _remote_record.Clear();
-    }
+    /*!
+     * Clears local & remote records. Records which held large values
+     *  are released rather than cleared, so that a recycled
+     *  request::state doesn't pin their capacity.
+     */
+    void reset_record_state();
 
 private:
 
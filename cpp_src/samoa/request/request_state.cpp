@@ -2,18 +2,144 @@
 #include "samoa/request/state_exception.hpp"
 #include "samoa/datamodel/clock_util.hpp"
 #include "samoa/server/table.hpp"
+#include "samoa/log.hpp"
+#include <boost/smart_ptr/make_shared.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/bind.hpp>
+#include <vector>
 
 namespace samoa {
 namespace request {
 
 namespace spb = samoa::core::protobuf;
 
+// states which a thread may pool; beyond this, released states are deleted
+const size_t max_pooled_states = 64;
+
+struct state_pool
+{
+    state_pool()
+    { states.reserve(max_pooled_states); }
+
+    ~state_pool()
+    {
+        for(auto it = states.begin(); it != states.end(); ++it)
+            delete *it;
+    }
+
+    std::vector<state*> states;
+};
+
+static boost::thread_specific_ptr<state_pool> _state_pool;
+
+static state_pool & get_state_pool()
+{
+    state_pool * pool = _state_pool.get();
+    if(!pool)
+    {
+        pool = new state_pool();
+        _state_pool.reset(pool);
+    }
+    return *pool;
+}
+
+// pools a reset state with the calling thread, or deletes it if full
+static void pool_state(state * s)
+{
+    state_pool & pool = get_state_pool();
+
+    if(pool.states.size() == max_pooled_states)
+        delete s;
+    else
+        pool.states.push_back(s);
+}
+
+// a reset state in transit to the io_service which acquired it; the
+//  state is deleted if the io_service is destroyed before it's pooled
+struct state_handoff
+{
+    explicit state_handoff(state * s)
+     : s(s)
+    { }
+
+    ~state_handoff()
+    { delete s; }
+
+    state * s;
+};
+
+static void on_state_handoff(const boost::shared_ptr<state_handoff> & handoff)
+{
+    pool_state(handoff->s);
+    handoff->s = 0;
+}
+
 state::state()
+ : core::arena(),
+   client_state(static_cast<core::arena &>(*this)),
+   route_state(static_cast<core::arena &>(*this)),
+   _pool(0)
 { }
 
 state::~state()
 { }
 
+state::ptr_t state::acquire()
+{
+    state_pool & pool = get_state_pool();
+
+    state * s = 0;
+
+    if(pool.states.empty())
+    {
+        s = new state();
+    }
+    else
+    {
+        s = pool.states.back();
+        pool.states.pop_back();
+    }
+    s->_pool = &pool;
+
+    return ptr_t(s, &state::recycle);
+}
+
+size_t state::get_pooled_count()
+{
+    return get_state_pool().states.size();
+}
+
+void state::recycle(state * s)
+{
+    // as a shared_ptr deleter, recycle() mustn't throw
+    try
+    {
+        core::io_service_ptr_t io_service = s->get_io_service();
+
+        // release references held by the request before pooling, as
+        //  the state may go unused for some time
+        s->reset_state();
+
+        if(io_service && s->_pool != _state_pool.get())
+        {
+            // released by a thread other than the acquiring one; pool
+            //  with the request's io_service, which acquired the state
+            boost::shared_ptr<state_handoff> handoff = \
+                boost::make_shared<state_handoff>(s);
+            s = 0;
+
+            io_service->post(boost::bind(&on_state_handoff, handoff));
+            return;
+        }
+        pool_state(s);
+    }
+    catch(const std::exception & e)
+    {
+        LOG_ERR("failed to recycle state: " << e.what());
+        delete s;
+    }
+}
+
 void state::flush_response()
 {
     client_state::flush_response(shared_from_this());
@@ -30,6 +156,25 @@ void state::send_error(unsigned err_code,
     client_state::send_error(shared_from_this(), err_code, err_msg);
 }
 
+bool state::drop_if_expired()
+{
+    if(!check_deadline())
+        return false;
+
+    send_error(504, "request deadline expired");
+    return true;
+}
+
+void state::load_deadline_state()
+{
+    const spb::SamoaRequest & request = client_state::get_samoa_request();
+
+    if(request.has_timeout_ms())
+    {
+        deadline_state::load_deadline_state(request.timeout_ms());
+    }
+}
+
 void state::load_table_state()
 {
     table_state::load_table_state(get_table_set());
@@ -139,6 +284,10 @@ void state::reset_state()
     reset_route_state();
     reset_record_state();
     reset_replication_state();
+    reset_deadline_state();
+
+    // sub-states have released their arena allocations
+    core::arena::release();
 }
 
 }
@@ -9,13 +9,31 @@
 #include "samoa/request/route_state.hpp"
 #include "samoa/request/record_state.hpp"
 #include "samoa/request/replication_state.hpp"
+#include "samoa/request/deadline_state.hpp"
+#include "samoa/core/arena.hpp"
 #include <boost/smart_ptr/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
 
 namespace samoa {
 namespace request {
 
+struct state_pool;
+
+/*!
+ * Composes the sub-states of a request.
+ *
+ * state is itself the core::arena (and, as the first base, outlives the
+ *  sub-states) from which request-lifetime containers are allocated.
+ *
+ * States are recycled: those obtained through acquire() are reset on
+ *  release of their last reference, and returned to the pool of the
+ *  acquiring thread (and thus, of its serial io_service). A state
+ *  released by another thread (eg, a persister or executor worker) is
+ *  posted back to the request's io_service to be pooled. Recycled
+ *  states retain the capacity of their protobuf messages & containers.
+ */
 class state :
+    private core::arena,
     private io_service_state,
     private context_state,
     private client_state,
@@ -23,6 +41,7 @@ class state :
     private route_state,
     private record_state,
     private replication_state,
+    private deadline_state,
     public boost::enable_shared_from_this<state>
 {
 public:
@@ -32,6 +51,15 @@ public:
     state();
     virtual ~state();
 
+    /*!
+     * Returns a reset state from the calling thread's pool,
+     *  or a newly allocated state if the pool is empty
+     */
+    static ptr_t acquire();
+
+    //! Count of states pooled by the calling thread
+    static size_t get_pooled_count();
+
     using io_service_state::get_io_service;
 
     using context_state::get_context;
@@ -44,6 +72,7 @@ public:
     using client_state::get_request_data_blocks;
     using client_state::get_samoa_response;
     using client_state::add_response_data_block;
+    using client_state::set_request_scheduler;
     void flush_response();
     void send_error(unsigned err_code, const std::string & err_msg);
     void send_error(unsigned err_code,
@@ -82,6 +111,28 @@ public:
     using replication_state::peer_replication_success;
     using replication_state::peer_replication_failure;
 
+    /*!
+     * Loads the deadline of the SamoaRequest's timeout_ms, timed from
+     *  the point of call. Called by samoa::server::client on parsing
+     *  the request, so that time spent queued counts against it.
+     */
+    void load_deadline_state();
+
+    using deadline_state::has_deadline;
+    using deadline_state::get_remaining_ms;
+    using deadline_state::is_expired;
+    using deadline_state::check_deadline;
+    using deadline_state::propagate_deadline;
+    using deadline_state::get_expired_count;
+
+    /*!
+     * If the request's deadline has passed, responds with a 504 error
+     *  rather than perform work the requester has abandoned.
+     *
+     * Returns true iff the request was dropped
+     */
+    bool drop_if_expired();
+
     /*!
      * Loads io_service_state, context_state, and client_state.
      *
@@ -98,6 +149,14 @@ public:
     void parse_samoa_request();    
 
     void reset_state();
+
+private:
+
+    //! Deleter of acquired states; resets & pools (or deletes) the state
+    static void recycle(state *);
+
+    // pool of the thread which acquired the state, if any
+    state_pool * _pool;
 };
 
 }
@@ -23,6 +23,14 @@ route_state::route_state()
    _loaded(false)
 { }
 
+route_state::route_state(core::arena & arena)
+ : _ring_position(0),
+   _primary_partition_uuid(boost::uuids::nil_uuid()),
+   _peer_partition_uuids(core::arena_allocator<core::uuid>(arena)),
+   _peer_partitions(core::arena_allocator<server::partition_ptr_t>(arena)),
+   _loaded(false)
+{ }
+
 route_state::~route_state()
 { }
 
@@ -78,6 +86,12 @@ void route_state::load_route_state(const server::table::ptr_t & table)
     bool has_primary_uuid = has_primary_partition_uuid();
     bool has_peer_uuids = has_peer_partition_uuids();
 
+    // size once, rather than regrowing within the arena
+    if(!has_peer_uuids)
+        _peer_partition_uuids.reserve(table->get_replication_factor());
+
+    _peer_partitions.reserve(table->get_replication_factor());
+
     for(unsigned count = 0; count != table->get_replication_factor();
         ++count, ++it)
     {
@@ -174,9 +188,13 @@ void route_state::reset_route_state()
     _key.clear();
     _ring_position = 0;
     _primary_partition_uuid = boost::uuids::nil_uuid();
-    _peer_partition_uuids.clear();
     _primary_partition.reset();
-    _peer_partitions.clear();
+
+    // release (rather than clear) allocations, as the arena may be released
+    partition_uuids_t(_peer_partition_uuids.get_allocator()
+        ).swap(_peer_partition_uuids);
+    partitions_t(_peer_partitions.get_allocator()
+        ).swap(_peer_partitions);
     _loaded = false;
 }
 
@@ -3,6 +3,7 @@
 
 #include "samoa/server/fwd.hpp"
 #include "samoa/core/uuid.hpp"
+#include "samoa/core/arena.hpp"
 #include <vector>
 #include <string>
 
@@ -13,8 +14,17 @@ class route_state
 {
 public:
 
+    typedef std::vector<core::uuid,
+        core::arena_allocator<core::uuid> > partition_uuids_t;
+
+    typedef std::vector<server::partition_ptr_t,
+        core::arena_allocator<server::partition_ptr_t> > partitions_t;
+
     route_state();
 
+    //! Peer uuids & partitions are allocated from the arena
+    explicit route_state(core::arena &);
+
     virtual ~route_state();
 
     /*!
@@ -105,7 +115,7 @@ public:
      *
      * Invariant: uuids are always returned in sorted order.
      */
-    const std::vector<core::uuid> & get_peer_partition_uuids() const
+    const partition_uuids_t & get_peer_partition_uuids() const
     { return _peer_partition_uuids; }
 
     /*!
@@ -122,7 +132,7 @@ public:
      *
      * See the chord protocol for details. 
      */
-    const std::vector<server::partition_ptr_t> & get_peer_partitions() const
+    const partitions_t & get_peer_partitions() const
     { return _peer_partitions; }
 
     void load_route_state(const server::table_ptr_t &);
@@ -135,10 +145,10 @@ private:
     uint64_t _ring_position;
 
     core::uuid _primary_partition_uuid;
-    std::vector<core::uuid> _peer_partition_uuids;
+    partition_uuids_t _peer_partition_uuids;
 
     server::local_partition_ptr_t _primary_partition;
-    std::vector<server::partition_ptr_t> _peer_partitions;
+    partitions_t _peer_partitions;
 
     bool _loaded;
 };
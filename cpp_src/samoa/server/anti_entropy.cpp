@@ -1,105 +1,376 @@
-/*
+
 #include "samoa/server/anti_entropy.hpp"
+#include "samoa/server/context.hpp"
+#include "samoa/server/cluster_state.hpp"
+#include "samoa/server/table_set.hpp"
+#include "samoa/server/table.hpp"
+#include "samoa/server/peer_set.hpp"
 #include "samoa/server/local_partition.hpp"
+#include "samoa/server/digest.hpp"
 #include "samoa/persistence/persister.hpp"
+#include "samoa/persistence/record.hpp"
 #include "samoa/core/protobuf/samoa.pb.h"
+#include "samoa/error.hpp"
+#include "samoa/log.hpp"
+#include <boost/bind.hpp>
+#include <sstream>
 
 namespace samoa {
 namespace server {
 
-anti_entropy::anti_entropy(const table::ptr_t & table,
-    const local_partition::ptr_t & partition)
- :  core::periodic_task<anti_entropy>(),
-    _weak_table(table),
-    _weak_persister(partition->get_persister()),
-    _partition_uuid(partition->get_uuid())
-    _ticket(0)
-{ }
+namespace spb = samoa::core::protobuf;
+
+// default period of 1 minute
+static boost::posix_time::time_duration anti_entropy_period = \
+    boost::posix_time::minutes(1);
+
+// is the digest range wholly within the partition's responsible range?
+static bool partition_covers_range(const partition & part, unsigned range)
+{
+    uint64_t begin = digest::range_begin(range);
+    uint64_t end = digest::range_end(range);
+
+    if(!part.position_in_responsible_range(begin) ||
+       !part.position_in_responsible_range(end))
+    {
+        return false;
+    }
+
+    // a wrapping responsible range excludes (range_end, range_begin),
+    //  which may fall between begin & end
+    return !(part.get_range_end() < part.get_range_begin() &&
+        part.get_range_end() + 1 != part.get_range_begin() &&
+        begin <= part.get_range_end() && end >= part.get_range_begin());
+}
+
+anti_entropy::anti_entropy(const context::ptr_t & context,
+    const core::uuid & table_uuid,
+    const core::uuid & partition_uuid)
+ : core::periodic_task<anti_entropy>(),
+   _weak_context(context),
+   _table_uuid(table_uuid),
+   _partition_uuid(partition_uuid),
+   _started(false),
+   _cycle_count(0),
+   _span_index(0),
+   _ticket(0)
+{
+    std::stringstream tmp;
+    tmp << "anti_entropy<" << this << ">@" << partition_uuid;
+    set_tasklet_name(tmp.str());
+}
 
 void anti_entropy::begin_cycle()
 {
     LOG_DBG("called " << get_tasklet_name());
 
-    persister::ptr_t persister = _weak_persister.lock();
-    SAMOA_ASSERT(persister);
+    if(!_started)
+    {
+        // don't compete with server start-up; wait a full period
+        _started = true;
+        next_cycle(anti_entropy_period);
+        return;
+    }
+
+    context::ptr_t context = _weak_context.lock();
+    SAMOA_ASSERT(context);
+
+    table::ptr_t table = context->get_cluster_state(
+        )->get_table_set()->get_table(_table_uuid);
 
-    if(!_ticket)
+    if(table)
     {
-        _ticket = persister->begin_iteration();
-        LOG_INFO("beginning new persister iteration round " << _ticket);
+        _partition = boost::dynamic_pointer_cast<local_partition>(
+            table->get_partition(_partition_uuid));
     }
 
-    persister->iterate(
-        boost::bind(&anti_entropy::on_iterate,
-            shared_from_this(), _1),
-        ticket);
+    if(!_partition)
+    {
+        // partition has been dropped; don't schedule another cycle
+        LOG_INFO("partition " << _partition_uuid << " no longer exists");
+        return;
+    }
+
+    std::vector<partition::ptr_t> peers;
+    for(auto it = table->get_ring().begin();
+        it != table->get_ring().end(); ++it)
+    {
+        if((*it)->get_uuid() != _partition_uuid)
+            peers.push_back(*it);
+    }
+
+    // select the next peer (round-robin) sharing responsibility
+    //  for any ranges of the ring with the local partition
+    for(size_t attempt = 0; _spans.empty() && attempt != peers.size();
+        ++attempt)
+    {
+        _peer = peers[_cycle_count++ % peers.size()];
+
+        unsigned run_begin = 0, run_length = 0;
+
+        for(unsigned range = 0; range != digest::range_count; ++range)
+        {
+            if(partition_covers_range(*_partition, range) &&
+               partition_covers_range(*_peer, range))
+            {
+                if(!run_length)
+                    run_begin = range;
+
+                run_length += 1;
+            }
+            else if(run_length)
+            {
+                _spans.push_back(span_t(run_begin, run_length));
+                run_length = 0;
+            }
+        }
+
+        if(run_length && !_spans.empty() && _spans.front().first == 0)
+        {
+            // the trailing run continues through range 0
+            _spans.front().first = run_begin;
+            _spans.front().second += run_length;
+        }
+        else if(run_length)
+        {
+            _spans.push_back(span_t(run_begin, run_length));
+        }
+    }
+
+    _span_index = 0;
+    next_span(context);
 }
 
-void anti_entropy::on_iterate(const record * raw_record)
+void anti_entropy::next_span(const context::ptr_t & context)
 {
-    if(!record)
+    if(_span_index == _spans.size())
     {
-        end_cycle(interval);
+        end_cycle();
         return;
     }
 
-    context::ptr_t context = _weak_context.lock();
-    SAMOA_ASSERT(context);
+    context->get_cluster_state()->get_peer_set()->schedule_request(
+        boost::bind(&anti_entropy::on_digest_request,
+            shared_from_this(), _1, _2, context),
+        _peer->get_server_uuid());
+}
+
+void anti_entropy::on_digest_request(
+    const boost::system::error_code & ec,
+    samoa::client::server_request_interface iface,
+    const context::ptr_t & context)
+{
+    if(ec)
+    {
+        LOG_WARN(ec.message());
+        end_cycle();
+        return;
+    }
+
+    const span_t & span = _spans[_span_index];
 
-    // build an internal request for this table & record
-    request_state::ptr_t rstate = boost::make_shared<request_state>(
-        client::ptr_t(()));
+    _range_digests.clear();
+    uint64_t combined = _partition->get_digest()->get_range_digests(
+        span.first, span.second, _range_digests);
 
-    spb::SamoaRequest & samoa_request = rstate->get_samoa_request();
-    spb::PersistedRecord & record = rstate->get_local_record();
+    spb::SamoaRequest & samoa_request = iface.get_message();
 
-    samoa_request.mutable_table_uuid().assign(
+    samoa_request.set_type(spb::DIGEST);
+    samoa_request.mutable_table_uuid()->assign(
         _table_uuid.begin(), _table_uuid.end());
-    samoa_request.mutable_partition_uuid().assign(
-        _partition_uuid.begin(), _partition_uuid.end());
+    samoa_request.mutable_partition_uuid()->assign(
+        _peer->get_uuid().begin(), _peer->get_uuid().end());
 
-    samoa_request.mutable_key().assign(
-        record->key_begin(), record->key_end());
+    spb::DigestRequest & digest_request = *samoa_request.mutable_digest();
+    digest_request.set_range_begin(span.first);
+    digest_request.set_range_count(span.second);
+    digest_request.set_digest(combined);
 
-    // set to callback only after replication has fully completed
-    samoa_request.set_requested_quorum(0);
+    iface.flush_request(
+        boost::bind(&anti_entropy::on_digest_response,
+            shared_from_this(), _1, _2, context));
+}
 
-    // TODO: this is awful; rework it
-    try {
-        rstate->load_from_samoa_request(context);
+void anti_entropy::on_digest_response(
+    const boost::system::error_code & ec,
+    samoa::client::server_response_interface iface,
+    const context::ptr_t & context)
+{
+    if(ec)
+    {
+        LOG_WARN(ec.message());
+        end_cycle();
+        return;
     }
-    catch(const std::runtime_error & e)
+
+    if(iface.get_error_code())
     {
-        // partition_uuid isn't responsible for this key;
-        //   back off and let the table route
-        samoa_request.clear_partition_uuid();
-        rstate->load_from_samoa_request(context);
+        LOG_WARN("remote error: " << \
+            iface.get_message().error().ShortDebugString());
+
+        iface.finish_response();
+        end_cycle();
+        return;
     }
 
-    // parse the iterated record
-    SAMOA_ASSERT(record.ParseFromArray(
-        raw_record->value_begin(), raw_record->value_length()));
+    const spb::SamoaResponse & samoa_response = iface.get_message();
+    const span_t & span = _spans[_span_index];
 
-    if(!rstate->get_primary_partition())
+    if(samoa_response.success())
     {
-        // this key has moved off of this server entirely;
-        //   forward replicated-write to the best available peer
-        replication::forwarded_write(
-            boost::bind(&anti_entropy::on_moved, shared_from_this(), rstate),
-            rstate, rstate->get_partition_peers().first().partition);
+        // combined digests match; nothing to repair
+        iface.finish_response();
+
+        _span_index += 1;
+        next_span(context);
+        return;
     }
-    else if(rstate->get_primary_partition()->get_uuid() != _partition_uuid)
+
+    if((unsigned) samoa_response.range_digest_size() != span.second)
+    {
+        LOG_WARN("expected " << span.second << " range digests, but got "
+            << samoa_response.range_digest_size());
+
+        iface.finish_response();
+        end_cycle();
+        return;
+    }
+
+    // mark ranges having differing digests
+    _diverged.assign(digest::range_count, false);
+    unsigned diverged_count = 0;
+
+    for(unsigned i = 0; i != span.second; ++i)
     {
-        // this key has moved to another primary partition on this server;
-        //   forward replicated-write to the new primary partition
-        replication::forwarded_write(
-            boost::bind(&anti_entropy::on_moved, shared_from_this(), rstate),
-            rstate, rstate->get_primary_partition());
+        if(samoa_response.range_digest(i) != _range_digests[i])
+        {
+            _diverged[(span.first + i) % digest::range_count] = true;
+            diverged_count += 1;
+        }
     }
+    iface.finish_response();
 
+    LOG_INFO(_partition_uuid << ": " << diverged_count << " of " \
+        << span.second << " ranges diverge from peer " << _peer->get_uuid());
 
+    _ticket = _partition->get_persister()->begin_iteration();
+    next_record(context);
+}
+
+void anti_entropy::next_record(const context::ptr_t & context)
+{
+    if(!_partition->get_persister()->iterate(
+        boost::bind(&anti_entropy::on_iterate,
+            shared_from_this(), _1, context),
+        _ticket))
+    {
+        // iteration is complete
+        _span_index += 1;
+        next_span(context);
+    }
 }
 
+void anti_entropy::on_iterate(const persistence::record * rec,
+    const context::ptr_t & context)
+{
+    // called from the persister's io_service; we may not call back
+    //  into the persister, and the record is only valid for this call
+
+    if(rec)
+    {
+        _key.assign(rec->key_begin(), rec->key_end());
+
+        if(_diverged[digest::range_of(table::key_ring_position(_key))])
+        {
+            _value.assign(rec->value_begin(), rec->value_end());
+
+            get_io_service()->post(
+                boost::bind(&anti_entropy::replicate_record,
+                    shared_from_this(), context));
+            return;
+        }
+    }
+
+    get_io_service()->post(
+        boost::bind(&anti_entropy::next_record,
+            shared_from_this(), context));
 }
+
+void anti_entropy::replicate_record(const context::ptr_t & context)
+{
+    context->get_cluster_state()->get_peer_set()->schedule_request(
+        boost::bind(&anti_entropy::on_replicate_request,
+            shared_from_this(), _1, _2, context),
+        _peer->get_server_uuid());
 }
-*/
+
+void anti_entropy::on_replicate_request(
+    const boost::system::error_code & ec,
+    samoa::client::server_request_interface iface,
+    const context::ptr_t & context)
+{
+    if(ec)
+    {
+        LOG_WARN(ec.message());
+
+        // abandon repair, but complete iteration to release the ticket
+        _diverged.assign(digest::range_count, false);
+        next_record(context);
+        return;
+    }
+
+    spb::SamoaRequest & samoa_request = iface.get_message();
+
+    samoa_request.set_type(spb::REPLICATE);
+    samoa_request.set_key(_key);
+    samoa_request.mutable_table_uuid()->assign(
+        _table_uuid.begin(), _table_uuid.end());
+    samoa_request.mutable_partition_uuid()->assign(
+        _peer->get_uuid().begin(), _peer->get_uuid().end());
+
+    // persisted record value is a serialized PersistedRecord
+    iface.add_data_block(_value.begin(), _value.end());
+
+    iface.flush_request(
+        boost::bind(&anti_entropy::on_replicate_response,
+            shared_from_this(), _1, _2, context));
+}
+
+void anti_entropy::on_replicate_response(
+    const boost::system::error_code & ec,
+    samoa::client::server_response_interface iface,
+    const context::ptr_t & context)
+{
+    if(ec)
+    {
+        LOG_WARN(ec.message());
+
+        // abandon repair, but complete iteration to release the ticket
+        _diverged.assign(digest::range_count, false);
+    }
+    else
+    {
+        if(iface.get_error_code())
+        {
+            LOG_WARN("remote error: " << \
+                iface.get_message().error().ShortDebugString());
+        }
+        iface.finish_response();
+    }
+
+    next_record(context);
+}
+
+void anti_entropy::end_cycle()
+{
+    // release references held for the cycle
+    _partition.reset();
+    _peer.reset();
+    _spans.clear();
+
+    next_cycle(anti_entropy_period);
+}
+
+}
+}
+
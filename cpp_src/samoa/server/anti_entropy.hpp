@@ -1,14 +1,33 @@
-/*#ifndef SAMOA_SERVER_ANTI_ENTROPY_HPP
+#ifndef SAMOA_SERVER_ANTI_ENTROPY_HPP
 #define SAMOA_SERVER_ANTI_ENTROPY_HPP
 
 #include "samoa/server/fwd.hpp"
+#include "samoa/client/fwd.hpp"
 #include "samoa/persistence/fwd.hpp"
 #include "samoa/core/periodic_task.hpp"
 #include "samoa/core/uuid.hpp"
+#include <boost/asio.hpp>
+#include <string>
+#include <vector>
 
 namespace samoa {
 namespace server {
 
+/*!
+ * Periodically repairs divergence between a local partition and the
+ *  peer partitions with which it shares responsibility for ring ranges.
+ *
+ * Each cycle selects the next peer partition (round-robin), and
+ *  exchanges digests of the ring ranges both partitions are responsible
+ *  for. Only if the combined digest differs are per-range digests
+ *  returned, and only records of differing ranges are replicated to the
+ *  peer. Records the peer holds which are newer (or which are missing
+ *  locally) flow back through the peer's reverse replication, and its
+ *  own anti_entropy cycles.
+ *
+ * Network cost of repair is thus proportional to divergence,
+ *  rather than partition size.
+ */
 class anti_entropy :
     public core::periodic_task<anti_entropy>
 {
@@ -17,23 +36,66 @@ public:
     using core::periodic_task<anti_entropy>::ptr_t;
     using core::periodic_task<anti_entropy>::weak_ptr_t;
 
-    anti_entropy(const table_ptr_t &, const local_partition_ptr_t &);
+    anti_entropy(const context_ptr_t &,
+        const core::uuid & table_uuid,
+        const core::uuid & partition_uuid);
 
     void begin_cycle();
 
 protected:
 
-    const context_ptr_t _weak_context;
-    const persister_weak_ptr_t _weak_persister;
+    typedef std::pair<unsigned, unsigned> span_t;
 
+    void next_span(const context_ptr_t &);
+
+    void on_digest_request(const boost::system::error_code &,
+        samoa::client::server_request_interface,
+        const context_ptr_t &);
+
+    void on_digest_response(const boost::system::error_code &,
+        samoa::client::server_response_interface,
+        const context_ptr_t &);
+
+    void next_record(const context_ptr_t &);
+
+    void on_iterate(const persistence::record *, const context_ptr_t &);
+
+    void replicate_record(const context_ptr_t &);
+
+    void on_replicate_request(const boost::system::error_code &,
+        samoa::client::server_request_interface,
+        const context_ptr_t &);
+
+    void on_replicate_response(const boost::system::error_code &,
+        samoa::client::server_response_interface,
+        const context_ptr_t &);
+
+    void end_cycle();
+
+    context_weak_ptr_t _weak_context;
     const core::uuid _table_uuid;
     const core::uuid _partition_uuid;
 
+    bool _started;
+    unsigned _cycle_count;
+
+    // state of the current cycle
+    local_partition_ptr_t _partition;
+    partition_ptr_t _peer;
+
+    std::vector<span_t> _spans;
+    size_t _span_index;
+
+    std::vector<uint64_t> _range_digests;
+    std::vector<bool> _diverged;
     unsigned _ticket;
+
+    std::string _key;
+    std::string _value;
 };
 
 }
 }
 
 #endif
-*/
+
@@ -3,6 +3,7 @@
 #include "samoa/server/context.hpp"
 #include "samoa/server/protocol.hpp"
 #include "samoa/server/command_handler.hpp"
+#include "samoa/server/request_scheduler.hpp"
 #include "samoa/request/request_state.hpp"
 #include "samoa/request/state_exception.hpp"
 #include "samoa/core/stream_protocol.hpp"
@@ -11,9 +12,14 @@
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
 #include <sstream>
 
 #define MAX_DATA_BLOCK_LENGTH 4194304
+#define MIN_STREAMED_DATA_BLOCK_LENGTH 65536
+#define MAX_STREAMED_DATA_BLOCK_LENGTH 67108864
+#define DEFAULT_MAX_REQUEST_BYTES 8388608
+#define DEFAULT_MAX_TOTAL_REQUEST_BYTES 268435456
 
 namespace samoa {
 namespace server {
@@ -23,7 +29,11 @@ using namespace boost::asio;
 // default timeout of 1 minute
 unsigned default_timeout_ms = 10 * 1000;
 
-const unsigned client::max_request_concurrency = 100;
+static size_t max_request_bytes = DEFAULT_MAX_REQUEST_BYTES;
+static size_t max_total_request_bytes = DEFAULT_MAX_TOTAL_REQUEST_BYTES;
+
+// bytes charged to admitted requests of all clients
+static size_t total_request_bytes = 0;
 
 //////////////////////////////////////////////////////////////////////////////
 //  client::response_interface
@@ -31,7 +41,7 @@ const unsigned client::max_request_concurrency = 100;
 client_response_interface::client_response_interface(const client::ptr_t & p)
  : _client(p)
 {
-    SAMOA_ASSERT(_client && !_client->has_queued_writes())
+    SAMOA_ASSERT(_client)
 }
 
 core::stream_protocol::write_interface_t &
@@ -42,8 +52,9 @@ client_response_interface::write_interface()
 
 void client_response_interface::finish_response()
 {
-    write_interface().write_queued(
-        boost::bind(&client::on_response_finish, _client, _1));
+    // queued writes are flushed by the client, coalesced
+    //  with those of other finished responses
+    _client->on_response_finish();
 
     // release ownership of client::response_interface
     _client.reset();
@@ -61,12 +72,18 @@ client::client(context::ptr_t context, protocol::ptr_t protocol,
    core::tasklet<client>(io_srv),
    _context(context),
    _protocol(protocol),
-   _ready_for_read(true),
-   _ready_for_write(true),
+   _read_paused(false),
+   _request_bytes(0),
+   _write_in_progress(false),
+   _finished_response_count(0),
+   _writing_response_count(0),
+   _response_count(0),
    _cur_requests_outstanding(0),
+   _peer_protocol_version(1),
+   _response_version_advertised(false),
    _ignore_timeout(false),
    _timeout_ms(default_timeout_ms),
-   _timeout_timer(*get_io_service())
+   _timeout_timer(get_io_service())
 {
     LOG_DBG("created");
 
@@ -79,15 +96,28 @@ client::~client()
     LOG_DBG("destroyed");
 }
 
+size_t client::get_max_request_bytes()
+{ return max_request_bytes; }
+
+void client::set_max_request_bytes(size_t bytes)
+{ max_request_bytes = bytes; }
+
+size_t client::get_max_total_request_bytes()
+{ return max_total_request_bytes; }
+
+void client::set_max_total_request_bytes(size_t bytes)
+{ max_total_request_bytes = bytes; }
+
+size_t client::get_total_request_bytes()
+{ return __sync_fetch_and_add(&total_request_bytes, 0); }
+
 void client::run_tasklet()
 {
     on_next_request();
 
     // start a timeout timer, waiting for requests from the client
-    _timeout_timer.expires_from_now(
-        boost::posix_time::milliseconds(_timeout_ms));
-    _timeout_timer.async_wait(boost::bind(
-        &client::on_timeout, shared_from_this(), _1));
+    _timeout_timer.schedule(boost::bind(
+        &client::on_timeout, shared_from_this()), _timeout_ms);
 }
 
 void client::halt_tasklet()
@@ -98,23 +128,74 @@ void client::halt_tasklet()
 
 void client::schedule_response(const response_callback_t & callback)
 {
-    on_next_response(false, &callback);
+    _queued_response_callbacks.push(callback);
+
+    if(++_response_count == 1)
+    {
+        // no response was held or scheduled; begin this one
+        begin_next_response();
+    }
 }
 
 void client::on_next_request()
 {
-    if(_cur_requests_outstanding < client::max_request_concurrency)
     {
-        ++_cur_requests_outstanding;
-        _ready_for_read = false;
+        adaptive_lock::guard guard(_lock);
+
+        if(!admits_request())
+        {
+            _read_paused = true;
 
-        read_data(boost::bind(&client::on_request_length,
-            shared_from_this(), _1, _3), 2);
+            LOG_INFO("request byte budget reached (" << _request_bytes
+                << " bytes); pausing read-loop");
+            return;
+        }
     }
-    else
+
+    ++_cur_requests_outstanding;
+
+    read_data(boost::bind(&client::on_request_length,
+        shared_from_this(), _1, _3), 2);
+}
+
+bool client::admits_request() const
+{
+    // a client without outstanding requests always makes progress
+    if(!_request_bytes)
+        return true;
+
+    return _request_bytes < max_request_bytes &&
+        get_total_request_bytes() < max_total_request_bytes;
+}
+
+void client::charge_request_bytes(size_t bytes)
+{
+    __sync_fetch_and_add(&total_request_bytes, bytes);
+
+    adaptive_lock::guard guard(_lock);
+    _request_bytes += bytes;
+}
+
+void client::release_request_bytes(size_t bytes)
+{
+    __sync_fetch_and_sub(&total_request_bytes, bytes);
+
     {
-        LOG_WARN("reached maximum request concurrency; pausing read-loop");
+        adaptive_lock::guard guard(_lock);
+        _request_bytes -= bytes;
+
+        if(!_read_paused || !admits_request())
+            return;
+
+        _read_paused = false;
     }
+
+    // restart the request read-loop via post, as we
+    //  may be called from any thread
+    get_io_service()->post(boost::bind(&client::on_next_request,
+        shared_from_this()));
+
+    LOG_INFO("request bytes released; restarting read-loop");
 }
 
 void client::on_request_length(const boost::system::error_code & ec,
@@ -128,13 +209,46 @@ void client::on_request_length(const boost::system::error_code & ec,
     }
 
     uint16_t len;
-    std::copy(buffers_begin(read_body), buffers_end(read_body),
-        (char*) &len);
+    core::copy_regions(read_body, (char*) &len);
+
+    // a version 1 client may write a frame of EXTENDED_FRAME_MARKER
+    //  bytes; extended frames follow a request advertising version 2
+    if(core::is_extended_frame(ntohs(len), _peer_protocol_version))
+    {
+        read_data(boost::bind(&client::on_request_extended_length,
+            shared_from_this(), _1, _3), 4);
+        return;
+    }
 
     read_data(boost::bind(&client::on_request_body,
         shared_from_this(), _1, _3), ntohs(len));
 }
 
+void client::on_request_extended_length(const boost::system::error_code & ec,
+    const core::buffer_regions_t & read_body)
+{
+    if(ec)
+    {
+        LOG_WARN(ec.message());
+        _timeout_timer.cancel();
+        return;
+    }
+
+    uint32_t len;
+    core::copy_regions(read_body, (char*) &len);
+
+    if(ntohl(len) > MAX_EXTENDED_FRAME_LENGTH)
+    {
+        // our transport is corrupted: don't read further
+        LOG_WARN("request frame of " << ntohl(len) << " bytes is too large");
+        _timeout_timer.cancel();
+        return;
+    }
+
+    read_data(boost::bind(&client::on_request_body,
+        shared_from_this(), _1, _3), ntohl(len));
+}
+
 void client::on_request_body(const boost::system::error_code & ec,
     const core::buffer_regions_t & read_body)
 {
@@ -145,14 +259,13 @@ void client::on_request_body(const boost::system::error_code & ec,
         return;
     }
 
-    request::state::ptr_t rstate = boost::make_shared<request::state>();
+    request::state::ptr_t rstate = request::state::acquire();
 
     request::client_state & client_state = \
         rstate->initialize_from_client(shared_from_this());
 
-    core::zero_copy_input_adapter zci_adapter(read_body);
-    if(!client_state.mutable_samoa_request(
-        ).ParseFromZeroCopyStream(&zci_adapter))
+    if(!core::parse_from_regions(
+        client_state.mutable_samoa_request(), read_body))
     {
         rstate->send_error(400, "protobuf parse error");
         // our transport is corrupted: don't begin a new read
@@ -161,6 +274,34 @@ void client::on_request_body(const boost::system::error_code & ec,
         return;
     }
 
+    if(client_state.get_samoa_request().has_protocol_version())
+    {
+        _peer_protocol_version = \
+            client_state.get_samoa_request().protocol_version();
+    }
+
+    rstate->load_deadline_state();
+
+    // charge the request's buffered bytes (including data blocks
+    //  yet to be read) until its request::state is released
+    size_t request_bytes = 0;
+
+    for(auto it = read_body.begin(); it != read_body.end(); ++it)
+    {
+        request_bytes += it->size();
+    }
+    for(int i = 0; i != client_state.get_samoa_request(
+        ).data_block_length_size(); ++i)
+    {
+        request_bytes += client_state.get_samoa_request(
+            ).data_block_length(i);
+    }
+
+    client_state._request_bytes = std::max(request_bytes,
+        sizeof(request::state));
+
+    charge_request_bytes(client_state._request_bytes);
+
     on_request_data_block(boost::system::error_code(),
         0, core::buffer_regions_t(), rstate,
         client_state.mutable_request_data_blocks());
@@ -169,7 +310,7 @@ void client::on_request_body(const boost::system::error_code & ec,
 void client::on_request_data_block(const boost::system::error_code & ec,
     unsigned ind, const core::buffer_regions_t & data,
     const request::state::ptr_t & rstate,
-    std::vector<core::buffer_regions_t> & data_blocks)
+    request::data_blocks_t & data_blocks)
 {
     if(ec)
     {
@@ -197,6 +338,34 @@ void client::on_request_data_block(const boost::system::error_code & ec,
         // still more data blocks to read
         unsigned block_len = samoa_request.data_block_length(ind);
 
+        std::string * stream_target = 0;
+
+        if(block_len >= MIN_STREAMED_DATA_BLOCK_LENGTH &&
+           block_len <= MAX_STREAMED_DATA_BLOCK_LENGTH)
+        {
+            command_handler::ptr_t handler = \
+                _protocol->get_command_handler(samoa_request.type());
+
+            if(handler)
+            {
+                stream_target = handler->stream_data_block(
+                    rstate, ind, block_len);
+            }
+        }
+
+        if(stream_target)
+        {
+            stream_target->clear();
+            stream_target->reserve(block_len);
+
+            read_data_chunks(
+                boost::bind(&client::on_request_data_chunk,
+                    shared_from_this(), _1, _2, _3, ind, stream_target,
+                    rstate, boost::ref(data_blocks)),
+                block_len);
+            return;
+        }
+
         if(block_len > MAX_DATA_BLOCK_LENGTH)
         {
             rstate->send_error(400, "data block too large");
@@ -214,117 +383,139 @@ void client::on_request_data_block(const boost::system::error_code & ec,
     // we're done reading data blocks, and have recieved a 
     // complete request in the timeout period
     _ignore_timeout = true;
-    _ready_for_read = true;
-
-    // post to continue request read-loop
-    get_io_service()->post(boost::bind(
-        &client::on_next_request, shared_from_this()));
 
     command_handler::ptr_t handler = _protocol->get_command_handler(
         samoa_request.type());
 
     if(handler)
     {
-        handler->checked_handle(rstate);
+        _protocol->get_request_scheduler()->schedule(handler, rstate);
     }
     else
     {
         rstate->send_error(501, "unknown operation type");
     }
+
+    // continue request read-loop; if the next request is already
+    //  buffered, it's read synchronously (stream_protocol bounds
+    //  the depth of such reads before yielding to the io_service)
+    on_next_request();
 }
 
-void client::on_next_response(bool is_write_complete,
-    const response_callback_t * new_callback)
+void client::on_request_data_chunk(const boost::system::error_code & ec,
+    size_t remaining, const core::buffer_regions_t & chunk,
+    unsigned ind, std::string * stream_target,
+    const request::state::ptr_t & rstate,
+    request::data_blocks_t & data_blocks)
 {
-    SAMOA_ASSERT(is_write_complete ^ (new_callback != 0));
-
-    spinlock::guard guard(_lock);
-
-    if(is_write_complete)
+    if(ec)
     {
-        _ready_for_write = true;
-
+        LOG_WARN(ec.message());
+        _timeout_timer.cancel();
+        return;
     }
 
-    if(!_ready_for_write)
+    for(auto it = chunk.begin(); it != chunk.end(); ++it)
     {
-        if(new_callback)
-        {
-            _queued_response_callbacks.push_back(*new_callback);
-        }
-        return;
+        stream_target->append(it->begin(), it->end());
     }
 
-    // we're ready to start a new response
+    if(remaining)
+        return;
+
+    // the data-block is complete; present it as an (unowned)
+    //  region of the stream target, which the request holds
+    char * begin = &(*stream_target)[0];
 
-    if(!_queued_response_callbacks.empty())
+    on_request_data_block(ec, ind,
+        core::buffer_regions_t(1, core::buffer_region(
+            begin, begin + stream_target->size())),
+        rstate, data_blocks);
+}
+
+void client::on_response_finish()
+{
+    bool more_responses;
     {
-        // it should never be possible for us to be ready-to-write,
-        //  and have both a new_callback & queued callbacks.
-        //
-        // only on_response_finish can clear the ready_for_write bit,
-        //  and that call never issues a new_callback
-        SAMOA_ASSERT(!new_callback);
+        adaptive_lock::guard guard(_lock);
 
-        _ready_for_write = false;
+        _finished_response_count += 1;
 
-        // post call to next queued response callback
-        get_io_service()->post(boost::bind(_queued_response_callbacks.front(),
-            response_interface(shared_from_this())));
+        // decrement under the lock, so that on_write_complete can't
+        //  observe this response as both finished & still held
+        more_responses = --_response_count != 0;
 
-        _queued_response_callbacks.pop_front();
+        if(!_write_in_progress)
+        {
+            begin_write();
+        }
+        // else, on_write_complete will write this response,
+        //  together with any others which finish in the meantime
     }
-    else if(new_callback)
-    {
-        _ready_for_write = false;
 
-        // post call directly to new_callback
-        get_io_service()->post(boost::bind(*new_callback,
-            response_interface(shared_from_this())));
+    if(more_responses)
+    {
+        begin_next_response();
     }
-    // else, no response to begin at this point
 }
 
-void client::on_response_finish(const boost::system::error_code & ec)
+void client::begin_next_response()
+{
+    response_callback_t callback;
+
+    // the callback was pushed prior to the count increment
+    //  which passed us the response token
+    _queued_response_callbacks.pop(callback);
+
+    get_io_service()->post(boost::bind(callback,
+        response_interface(shared_from_this())));
+}
+
+void client::begin_write()
+{
+    _write_in_progress = true;
+
+    _writing_response_count = _finished_response_count;
+    _finished_response_count = 0;
+
+    write_queued(boost::bind(&client::on_write_complete,
+        shared_from_this(), _1));
+}
+
+void client::on_write_complete(const boost::system::error_code & ec)
 {
     if(ec)
     {
         LOG_WARN(ec.message());
     }
 
-    if(_ready_for_read &&
-       _cur_requests_outstanding == client::max_request_concurrency)
-    {
-        // this response caused us to drop back below maximum
-        //  request concurrency; restart the request read-loop via post
-        get_io_service()->post(boost::bind(&client::on_next_request,
-            shared_from_this()));
+    adaptive_lock::guard guard(_lock);
 
-        LOG_INFO("request concurrency dropped; restarting read-loop");
-    }
-    --_cur_requests_outstanding;
+    _cur_requests_outstanding -= _writing_response_count;
 
-    on_next_response(true, 0);
-}
+    _write_in_progress = false;
+    _writing_response_count = 0;
 
-void client::on_timeout(boost::system::error_code ec)
-{
-    if(ec)
+    // if responses finished during the write, and the response
+    //  interface isn't held or scheduled (and so queued writes can't
+    //  change), write them now as a single batch. otherwise, the
+    //  holder's finished response will begin the next write
+    if(_finished_response_count && !_response_count)
     {
-        // timer cancelled; ignore
-        return;
+        begin_write();
     }
+}
 
+void client::on_timeout()
+{
     if(_ignore_timeout || _cur_requests_outstanding > 1)
     {
         // we've recently receieved a request from this client,
         //  or they have pending responses still in flight
 
         // start a timeout timer, waiting for requests from the client
-        _timeout_timer.expires_from_now(
-            boost::posix_time::milliseconds(_timeout_ms));
-        _timeout_timer.async_wait(boost::bind(
-            &client::on_timeout, shared_from_this(), _1));
+        _timeout_timer.schedule(boost::bind(
+            &client::on_timeout, shared_from_this()), _timeout_ms);
 
         _ignore_timeout = false;
     }
@@ -8,7 +8,10 @@
 #include "samoa/core/protobuf/samoa.pb.h"
 #include "samoa/core/stream_protocol.hpp"
 #include "samoa/core/tasklet.hpp"
-#include "samoa/spinlock.hpp"
+#include "samoa/core/timer_wheel.hpp"
+#include "samoa/core/mpsc_queue.hpp"
+#include "samoa/adaptive_lock.hpp"
+#include <boost/detail/atomic_count.hpp>
 #include <boost/asio.hpp>
 #include <list>
 
@@ -30,6 +33,9 @@ typedef boost::function<
  * When the response generation is complete, finish_response() is called to
  * flush remaining writes and notify the client that the next response handler
  * can be called back.
+ *
+ * Responses which finish while a write to the client is in progress are
+ * held, and written together in a single gather-write when it completes.
  */
 class client_response_interface
 {
@@ -42,8 +48,9 @@ public:
     core::stream_protocol::write_interface_t & write_interface();
 
     /*!
-     * Flushes remaining queued writes, and releases ownership
-     * of the client_response_interface.
+     * Flushes remaining queued writes (possibly as part of a later,
+     * coalesced write), and releases ownership of the
+     * client_response_interface.
      */
     void finish_response();
 
@@ -67,7 +74,28 @@ public:
     typedef client_response_callback_t response_callback_t;
     typedef client_response_interface response_interface;
 
-    static const unsigned max_request_concurrency;
+    /*!
+     * Per-client budget of bytes held by admitted requests which haven't
+     *  yet completed. Each request is charged its frame and data-block
+     *  lengths (or at least the size of a request::state), from when its
+     *  SamoaRequest is read until its request::state is released.
+     *
+     * A client reaching the budget pauses its request read-loop until
+     *  charges are released. A client with no outstanding requests is
+     *  always admitted a request, however large.
+     */
+    static size_t get_max_request_bytes();
+    static void set_max_request_bytes(size_t);
+
+    /*!
+     * Budget of bytes held by admitted requests of all clients. Clients
+     *  having outstanding requests pause their read-loops while exceeded.
+     */
+    static size_t get_max_total_request_bytes();
+    static void set_max_total_request_bytes(size_t);
+
+    //! Bytes charged to admitted requests of all clients
+    static size_t get_total_request_bytes();
 
     client(context_ptr_t, protocol_ptr_t,
         core::io_service_ptr_t,
@@ -90,6 +118,28 @@ public:
     void set_timeout_ms(unsigned timeout_ms)
     { _timeout_ms = timeout_ms; }
 
+    /*!
+     * Highest wire protocol version advertised by the client,
+     *  which bounds the frames that responses may use
+     */
+    unsigned get_peer_protocol_version() const
+    { return _peer_protocol_version; }
+
+    /*!
+     * Protocol version which a response may be written with: that
+     *  advertised by the client, once a prior response has advertised
+     *  our own. Responses are written in the order they're serialized,
+     *  so the client reads our version before any extended frame.
+     *
+     * Called only while holding the response_interface.
+     */
+    unsigned get_response_protocol_version() const
+    { return _response_version_advertised ? _peer_protocol_version : 1; }
+
+    //! Marks that a response advertising our version was serialized
+    void set_response_version_advertised()
+    { _response_version_advertised = true; }
+
     /*!
      * \brief Schedules writing of response.
      *
@@ -99,26 +149,51 @@ public:
      */
     void schedule_response(const response_callback_t &);
 
+    //! Bytes charged to this client's admitted requests
+    size_t get_request_bytes() const
+    { return _request_bytes; }
+
     void run_tasklet();
     void halt_tasklet();
 
 private:
 
     friend class client_response_interface;
+    friend class request::client_state;
 
     /*
-     * If a read-operation isn't already in progress and
-     *  we haven't yet reach max request concurrency,
-     *  begin a new request read (starting with length preamble)
+     * If admitted by request byte budgets, begin a new request read
+     *  (starting with length preamble). Otherwise, the read-loop is
+     *  paused until charged bytes are released.
      */
     void on_next_request();
 
+    // Preconditions: _lock is held
+    bool admits_request() const;
+
+    /*
+     * Charges bytes of a newly read request against budgets
+     */
+    void charge_request_bytes(size_t);
+
     /*
-     * Begins read of SamoaRequest body
+     * Releases bytes of a completed request::state, restarting
+     *  a paused read-loop if budgets now admit a request
+     */
+    void release_request_bytes(size_t);
+
+    /*
+     * Begins read of SamoaRequest body, or of an extended length
      */
     void on_request_length(const boost::system::error_code &,
         const core::buffer_regions_t &);
 
+    /*
+     * Begins read of an extended-frame SamoaRequest body
+     */
+    void on_request_extended_length(const boost::system::error_code &,
+        const core::buffer_regions_t &);
+
     /*
      * Allocates a request::state; parses SamoaRequest; enters on_request_data_block
      */
@@ -134,52 +209,78 @@ private:
     void on_request_data_block(const boost::system::error_code &,
         unsigned, const core::buffer_regions_t &,
         const request::state_ptr_t &,
-        std::vector<core::buffer_regions_t> &);
+        request::data_blocks_t &);
 
     /*
-     * Response scheduling workhorse.
-     *
-     * If we're ready to write a new response (_ready_for_write),
-     *  and have a queued callback, that callback is posted.
+     * Appends a chunk of a streamed data block to its target. When the
+     *  block is complete, re-enters on_request_data_block
+     */
+    void on_request_data_chunk(const boost::system::error_code &,
+        size_t, const core::buffer_regions_t &,
+        unsigned, std::string *,
+        const request::state_ptr_t &,
+        request::data_blocks_t &);
+
+    /*
+     * Marks that the current response has finished. Its queued writes
+     *  are written immediately if no write is in progress, and the next
+     *  scheduled response callback (if any) is begun.
+     */
+    void on_response_finish();
+
+    /*
+     * Pops & posts the next scheduled response callback.
      *
-     * If a new callback is given, that callback is either
-     *  posted (if we're ready to write, and there's no queued
-     *  callback) or itself queued.
+     * Preconditions: the caller holds the (implied) response token; ie,
+     *  it incremented _response_count from zero, or decremented it
+     *  to a non-zero value.
+     */
+    void begin_next_response();
+
+    /*
+     * Begins a write of all queued writes, of all finished responses.
      *
-     * @param is_write_complete Whether this call marks that a
-     *  current response operation has completed.
-     * @param new_callback A new response callback to invoke or queue.
+     * Preconditions: _lock is held, and no write is in progress.
      */
-    void on_next_response(bool is_write_complete,
-        const response_callback_t * new_callback);
+    void begin_write();
 
     /*
-     * Logs errors, and begins the next queued response.
+     * Logs errors, and begins a write of responses
+     *  which finished in the meantime.
      */
-    void on_response_finish(const boost::system::error_code &);
+    void on_write_complete(const boost::system::error_code &);
 
     /*
      * If a client hasn't responded within the timeout period, and has
      *  no pending requests, then the client is stopped (socket is closed,
      *  timeout cancelled, etc).
      */
-    void on_timeout(boost::system::error_code);
+    void on_timeout();
 
     const context_ptr_t _context;
     const protocol_ptr_t _protocol;
 
-    bool _ready_for_read;
-    bool _ready_for_write; // xthread
+    bool _read_paused; // xthread
+    size_t _request_bytes; // xthread
+
+    bool _write_in_progress; // xthread
+    unsigned _finished_response_count; // xthread
+    unsigned _writing_response_count; // xthread
 
-    std::list<response_callback_t> _queued_response_callbacks; // xthread
+    // scheduled response callbacks, and their count plus one for
+    //  the response currently holding the response interface (if any)
+    core::mpsc_queue<response_callback_t> _queued_response_callbacks;
+    boost::detail::atomic_count _response_count; // xthread
 
     unsigned _cur_requests_outstanding;
+    unsigned _peer_protocol_version;
+    bool _response_version_advertised;
 
     bool _ignore_timeout;
     unsigned _timeout_ms;
-    boost::asio::deadline_timer _timeout_timer;
+    core::wheel_timer _timeout_timer;
     
-    spinlock _lock;
+    adaptive_lock _lock;
 };
 
 }
@@ -3,6 +3,7 @@
 #include "samoa/server/cluster_state.hpp"
 #include "samoa/server/client.hpp"
 #include "samoa/server/context.hpp"
+#include "samoa/server/peer_set.hpp"
 #include "samoa/request/request_state.hpp"
 #include "samoa/log.hpp"
 #include <boost/bind.hpp>
@@ -35,11 +36,9 @@ bool cluster_state_handler::on_state_transaction(
     spb::ClusterState & local_state,
     const request::state::ptr_t & rstate)
 {
-    core::zero_copy_input_adapter zci_adapter(
-        rstate->get_request_data_blocks()[0]);
-
     spb::ClusterState remote_state;
-    SAMOA_ASSERT(remote_state.ParseFromZeroCopyStream(&zci_adapter));
+    SAMOA_ASSERT(core::parse_from_regions(remote_state,
+        rstate->get_request_data_blocks()[0]));
 
     rstate->get_io_service()->post(
         boost::bind(&cluster_state_handler::on_complete,
@@ -51,11 +50,15 @@ bool cluster_state_handler::on_state_transaction(
 
 void cluster_state_handler::on_complete(const request::state::ptr_t & rstate)
 {
-    core::zero_copy_output_adapter zco_adapter;
+    cluster_state::ptr_t current = rstate->get_context()->get_cluster_state();
 
-    // respond with the current cluster-state, rather than the request::state's
-    SAMOA_ASSERT(rstate->get_context()->get_cluster_state(
-        )->get_protobuf_description().SerializeToZeroCopyStream(&zco_adapter));
+    // respond with the current cluster-state, rather than the request::state's,
+    //  including our statistics of each peer
+    spb::ClusterState description(current->get_protobuf_description());
+    current->get_peer_set()->set_peer_statistics(description);
+
+    core::zero_copy_output_adapter zco_adapter;
+    zco_adapter.serialize(description);
 
     rstate->add_response_data_block(zco_adapter.output_regions());
     rstate->flush_response();
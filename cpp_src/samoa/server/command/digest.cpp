@@ -0,0 +1,82 @@
+
+#include "samoa/server/command/digest.hpp"
+#include "samoa/server/local_partition.hpp"
+#include "samoa/server/table.hpp"
+#include "samoa/server/digest.hpp"
+#include "samoa/request/request_state.hpp"
+#include "samoa/request/state_exception.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+#include <sstream>
+#include <vector>
+
+namespace samoa {
+namespace server {
+namespace command {
+
+namespace spb = samoa::core::protobuf;
+
+void digest_handler::handle(const request::state::ptr_t & rstate)
+{
+    rstate->load_table_state();
+
+    if(!rstate->has_primary_partition_uuid())
+    {
+        throw request::state_exception(400, "expected partition_uuid");
+    }
+
+    if(!rstate->get_samoa_request().has_digest())
+    {
+        throw request::state_exception(400, "expected digest");
+    }
+
+    const spb::DigestRequest & digest_request = \
+        rstate->get_samoa_request().digest();
+
+    if(digest_request.range_begin() >= digest::range_count ||
+       digest_request.range_count() > digest::range_count)
+    {
+        throw request::state_exception(400, "invalid digest range");
+    }
+
+    local_partition::ptr_t partition = \
+        boost::dynamic_pointer_cast<local_partition>(
+            rstate->get_table()->get_partition(
+                rstate->get_primary_partition_uuid()));
+
+    if(!partition)
+    {
+        std::stringstream err;
+        err << "partition " << rstate->get_primary_partition_uuid();
+        err << " is not local";
+        throw request::state_exception(404, err.str());
+    }
+
+    std::vector<uint64_t> range_digests;
+
+    uint64_t combined = partition->get_digest()->get_range_digests(
+        digest_request.range_begin(), digest_request.range_count(),
+        range_digests);
+
+    spb::SamoaResponse & samoa_response = rstate->get_samoa_response();
+
+    if(combined == digest_request.digest())
+    {
+        samoa_response.set_success(true);
+    }
+    else
+    {
+        samoa_response.set_success(false);
+
+        for(auto it = range_digests.begin(); it != range_digests.end(); ++it)
+        {
+            samoa_response.add_range_digest(*it);
+        }
+    }
+
+    rstate->flush_response();
+}
+
+}
+}
+}
+
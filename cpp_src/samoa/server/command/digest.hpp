@@ -0,0 +1,38 @@
+#ifndef SAMOA_SERVER_COMMAND_DIGEST_HPP
+#define SAMOA_SERVER_COMMAND_DIGEST_HPP
+
+#include "samoa/server/fwd.hpp"
+#include "samoa/server/command_handler.hpp"
+#include "samoa/request/fwd.hpp"
+#include <boost/smart_ptr/enable_shared_from_this.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace samoa {
+namespace server {
+namespace command {
+
+/*!
+ * Compares a peer's combined digest of a span of ring ranges against
+ *  that of a local partition. If they differ, the local digest of each
+ *  range is returned, so that the peer may repair only differing ranges.
+ */
+class digest_handler :
+    public command_handler,
+    public boost::enable_shared_from_this<digest_handler>
+{
+public:
+
+    typedef boost::shared_ptr<digest_handler> ptr_t;
+
+    digest_handler()
+    { }
+
+    void handle(const request::state_ptr_t &);
+};
+
+}
+}
+}
+
+#endif
+
@@ -0,0 +1,331 @@
+
+#include "samoa/server/command/multi_blob.hpp"
+#include "samoa/server/table.hpp"
+#include "samoa/server/peer_set.hpp"
+#include "samoa/server/partition.hpp"
+#include "samoa/server/local_partition.hpp"
+#include "samoa/client/server.hpp"
+#include "samoa/request/request_state.hpp"
+#include "samoa/request/state_exception.hpp"
+#include "samoa/error.hpp"
+#include "samoa/log.hpp"
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <sstream>
+
+namespace samoa {
+namespace server {
+namespace command {
+
+struct partition_order_cmp
+{
+    bool operator()(const partition::ptr_t & lhs, uint64_t rhs) const
+    { return lhs->get_ring_position() < rhs; }
+
+    bool operator()(uint64_t lhs, const partition::ptr_t & rhs) const
+    { return lhs < rhs->get_ring_position(); }
+};
+
+multi_blob_batch::multi_blob_batch(const request::state::ptr_t & rstate)
+ : _rstate(rstate),
+   _keys(rstate->get_samoa_request().multi_key_size()),
+   // held until forward_peer_groups() has been called
+   _pending_count(1)
+{ }
+
+bool multi_blob_batch::exceeds_primary_quorum(
+    const request::state::ptr_t & rstate)
+{
+    unsigned quorum = rstate->get_samoa_request().requested_quorum();
+
+    if(quorum == 0)
+        return rstate->get_table()->get_replication_factor() > 1;
+
+    return quorum > 1;
+}
+
+void multi_blob_batch::route()
+{
+    const spb::SamoaRequest & samoa_request = _rstate->get_samoa_request();
+    const table::ptr_t & table = _rstate->get_table();
+    const peer_set::ptr_t & peer_set = _rstate->get_peer_set();
+
+    if(!samoa_request.multi_key_size())
+    {
+        throw request::state_exception(400, "expected at least one key");
+    }
+
+    for(int index = 0; index != samoa_request.multi_key_size(); ++index)
+    {
+        const std::string & key = samoa_request.multi_key(index);
+
+        if(key.empty())
+        {
+            set_key_error(index, 400, "expected non-empty key");
+            continue;
+        }
+
+        table::ring_t::const_iterator it = std::lower_bound(
+            table->get_ring().begin(), table->get_ring().end(),
+            table->ring_position(key), partition_order_cmp());
+
+        local_partition::ptr_t primary;
+        partition::ptr_t peer;
+
+        // as with route_state, the first local partition on
+        //  the key's route is primary
+        for(unsigned count = 0; !table->get_ring().empty() &&
+            count != table->get_replication_factor(); ++count, ++it)
+        {
+            if(it == table->get_ring().end())
+                it = table->get_ring().begin();
+
+            primary = boost::dynamic_pointer_cast<local_partition>(*it);
+
+            if(primary)
+                break;
+
+            // prefer a peer to which we're already connected
+            if(!peer || (!peer_set->get_server(peer->get_server_uuid()) &&
+                peer_set->get_server((*it)->get_server_uuid())))
+            {
+                peer = *it;
+            }
+        }
+
+        if(primary)
+        {
+            auto g_it = _partition_groups.begin();
+            for(; g_it != _partition_groups.end() &&
+                g_it->partition != primary; ++g_it)
+            { }
+
+            if(g_it == _partition_groups.end())
+            {
+                _partition_groups.push_back(partition_group());
+                g_it = _partition_groups.end() - 1;
+                g_it->partition = primary;
+                ++_pending_count;
+            }
+
+            key_state & kstate = _keys[index];
+
+            persistence::persister::batch_entry entry;
+            entry.key = &key;
+            entry.remote_record = &kstate.remote_record;
+            entry.local_record = &kstate.local_record;
+            entry.found = false;
+
+            g_it->key_indices.push_back(index);
+            g_it->batch.push_back(entry);
+        }
+        else if(!peer)
+        {
+            set_key_error(index, 404, "no partitions for key");
+        }
+        else if(samoa_request.forwarded())
+        {
+            // our peer's view of the ring differs from our own;
+            //  don't forward the key again
+            set_key_error(index, 404, "no local partition for forwarded key");
+        }
+        else
+        {
+            auto g_it = _peer_groups.begin();
+            for(; g_it != _peer_groups.end() &&
+                g_it->server_uuid != peer->get_server_uuid(); ++g_it)
+            { }
+
+            if(g_it == _peer_groups.end())
+            {
+                _peer_groups.push_back(peer_group());
+                g_it = _peer_groups.end() - 1;
+                g_it->server_uuid = peer->get_server_uuid();
+                ++_pending_count;
+            }
+            g_it->key_indices.push_back(index);
+        }
+    }
+}
+
+void multi_blob_batch::set_key_error(size_t index,
+    unsigned err_code, const std::string & err_msg)
+{
+    spb::KeyResult & result = _keys[index].result;
+
+    result.Clear();
+    result.mutable_error()->set_code(err_code);
+    result.mutable_error()->set_message(err_msg);
+}
+
+void multi_blob_batch::set_key_error(size_t index,
+    unsigned err_code, const boost::system::error_code & ec)
+{
+    std::stringstream tmp;
+    tmp << ec << " (" << ec.message() << ")";
+
+    set_key_error(index, err_code, tmp.str());
+}
+
+void multi_blob_batch::forward_peer_groups()
+{
+    for(size_t group_index = 0; group_index != _peer_groups.size();
+        ++group_index)
+    {
+        _rstate->get_peer_set()->schedule_request(
+            boost::bind(&multi_blob_batch::on_peer_request,
+                shared_from_this(), _1, _2, group_index),
+            _peer_groups[group_index].server_uuid);
+    }
+
+    complete_group();
+}
+
+void multi_blob_batch::complete_group()
+{
+    if(--_pending_count == 0)
+        flush_response();
+}
+
+void multi_blob_batch::on_peer_request(
+    const boost::system::error_code & ec,
+    samoa::client::server_request_interface iface,
+    size_t group_index)
+{
+    const peer_group & group = _peer_groups[group_index];
+
+    if(ec)
+    {
+        std::stringstream tmp;
+        tmp << ec << " (" << ec.message() << ")";
+
+        set_group_error(group, 500, tmp.str());
+        complete_group();
+        return;
+    }
+
+    if(_rstate->check_deadline())
+    {
+        iface.abort_request();
+
+        set_group_error(group, 504, "request deadline expired");
+        complete_group();
+        return;
+    }
+
+    const spb::SamoaRequest & samoa_request = _rstate->get_samoa_request();
+    spb::SamoaRequest & peer_request = iface.get_message();
+
+    peer_request.set_type(samoa_request.type());
+    peer_request.mutable_table_uuid()->assign(
+        _rstate->get_table_uuid().begin(), _rstate->get_table_uuid().end());
+    peer_request.set_forwarded(true);
+    _rstate->propagate_deadline(peer_request);
+
+    for(auto it = group.key_indices.begin();
+        it != group.key_indices.end(); ++it)
+    {
+        peer_request.add_multi_key(samoa_request.multi_key(*it));
+
+        if(samoa_request.type() == spb::MULTI_SET)
+        {
+            iface.add_data_block(_rstate->get_request_data_blocks()[*it]);
+        }
+    }
+
+    iface.flush_request(
+        boost::bind(&multi_blob_batch::on_peer_response,
+            shared_from_this(), _1, _2, group_index));
+}
+
+void multi_blob_batch::on_peer_response(
+    const boost::system::error_code & ec,
+    samoa::client::server_response_interface iface,
+    size_t group_index)
+{
+    const peer_group & group = _peer_groups[group_index];
+
+    if(ec)
+    {
+        std::stringstream tmp;
+        tmp << ec << " (" << ec.message() << ")";
+
+        set_group_error(group, 500, tmp.str());
+        complete_group();
+        return;
+    }
+
+    const spb::SamoaResponse & peer_response = iface.get_message();
+
+    if(iface.get_error_code())
+    {
+        set_group_error(group, iface.get_error_code(),
+            peer_response.error().message());
+    }
+    else if((size_t) peer_response.key_result_size() != \
+        group.key_indices.size())
+    {
+        LOG_WARN("expected " << group.key_indices.size() << \
+            " key results, but got " << peer_response.key_result_size());
+
+        set_group_error(group, 500, "malformed peer response");
+    }
+    else
+    {
+        // values of each key are returned in key order
+        auto block_it = iface.get_response_data_blocks().begin();
+
+        for(size_t i = 0; i != group.key_indices.size(); ++i)
+        {
+            key_state & kstate = _keys[group.key_indices[i]];
+            kstate.result.CopyFrom(peer_response.key_result(i));
+
+            for(unsigned v = 0; v != kstate.result.value_count() &&
+                block_it != iface.get_response_data_blocks().end();
+                ++v, ++block_it)
+            {
+                kstate.local_record.add_blob_value()->assign(
+                    boost::asio::buffers_begin(*block_it),
+                    boost::asio::buffers_end(*block_it));
+            }
+            kstate.result.set_value_count(
+                kstate.local_record.blob_value_size());
+        }
+    }
+
+    iface.finish_response();
+    complete_group();
+}
+
+void multi_blob_batch::set_group_error(const peer_group & group,
+    unsigned err_code, const std::string & err_msg)
+{
+    for(auto it = group.key_indices.begin();
+        it != group.key_indices.end(); ++it)
+    {
+        set_key_error(*it, err_code, err_msg);
+    }
+}
+
+void multi_blob_batch::flush_response()
+{
+    spb::SamoaResponse & samoa_response = _rstate->get_samoa_response();
+
+    for(auto it = _keys.begin(); it != _keys.end(); ++it)
+    {
+        samoa_response.add_key_result()->CopyFrom(it->result);
+
+        for(unsigned v = 0; v != it->result.value_count(); ++v)
+        {
+            const std::string & value = it->local_record.blob_value(v);
+            _rstate->add_response_data_block(value.begin(), value.end());
+        }
+    }
+
+    _rstate->flush_response();
+}
+
+}
+}
+}
+
@@ -0,0 +1,143 @@
+#ifndef SAMOA_SERVER_COMMAND_MULTI_BLOB_HPP
+#define SAMOA_SERVER_COMMAND_MULTI_BLOB_HPP
+
+#include "samoa/server/fwd.hpp"
+#include "samoa/client/fwd.hpp"
+#include "samoa/request/fwd.hpp"
+#include "samoa/persistence/persister.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+#include "samoa/core/uuid.hpp"
+#include <boost/detail/atomic_count.hpp>
+#include <boost/smart_ptr/enable_shared_from_this.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+namespace samoa {
+namespace server {
+namespace command {
+
+namespace spb = samoa::core::protobuf;
+
+/*!
+ * Shared state of a MULTI_GET or MULTI_SET request.
+ *
+ * Keys of the request are grouped by their primary local partition,
+ *  and each group is issued to the partition's persister as a single
+ *  batch by the command handler. Keys having no local partition are
+ *  grouped by a peer server responsible for them, and forwarded as a
+ *  single batched request per peer. Per-key results are gathered in
+ *  request order, and the response is flushed once all groups complete.
+ */
+class multi_blob_batch :
+    public boost::enable_shared_from_this<multi_blob_batch>,
+    private boost::noncopyable
+{
+public:
+
+    typedef boost::shared_ptr<multi_blob_batch> ptr_t;
+
+    struct key_state
+    {
+        // remote record of a MULTI_SET
+        spb::PersistedRecord remote_record;
+        // stored record; its leading result.value_count
+        //  values are returned in the response
+        spb::PersistedRecord local_record;
+
+        spb::KeyResult result;
+    };
+
+    struct partition_group
+    {
+        local_partition_ptr_t partition;
+
+        std::vector<size_t> key_indices;
+        persistence::persister::batch_t batch;
+    };
+
+    struct peer_group
+    {
+        core::uuid server_uuid;
+
+        std::vector<size_t> key_indices;
+    };
+
+    typedef std::vector<partition_group> partition_groups_t;
+
+    explicit multi_blob_batch(const request::state_ptr_t &);
+
+    /*!
+     * Whether the request's quorum requires more than the primary
+     *  partition: a requested quorum above 1, or of 0 (all replicas)
+     *  where the table has a replication factor above 1.
+     *
+     * Preconditions: the request's table state has been loaded.
+     */
+    static bool exceeds_primary_quorum(const request::state_ptr_t &);
+
+    /*!
+     * Groups keys of the request by local partition or peer server.
+     *
+     * Preconditions: the request's table state has been loaded.
+     */
+    void route();
+
+    const request::state_ptr_t & get_request_state() const
+    { return _rstate; }
+
+    key_state & get_key_state(size_t index)
+    { return _keys[index]; }
+
+    partition_groups_t & get_partition_groups()
+    { return _partition_groups; }
+
+    //! Sets an error result for the key
+    void set_key_error(size_t index, unsigned err_code,
+        const std::string & err_msg);
+
+    void set_key_error(size_t index, unsigned err_code,
+        const boost::system::error_code &);
+
+    /*!
+     * Forwards each peer group, and then begins waiting for completion
+     *  of all groups. Called by the handler once partition groups have
+     *  been dispatched.
+     */
+    void forward_peer_groups();
+
+    /*!
+     * Marks a group as complete. Completion of the final group
+     *  flushes the batch response.
+     */
+    void complete_group();
+
+private:
+
+    void on_peer_request(const boost::system::error_code &,
+        samoa::client::server_request_interface, size_t group_index);
+
+    void on_peer_response(const boost::system::error_code &,
+        samoa::client::server_response_interface, size_t group_index);
+
+    void set_group_error(const peer_group &, unsigned err_code,
+        const std::string & err_msg);
+
+    void flush_response();
+
+    const request::state_ptr_t _rstate;
+
+    std::vector<key_state> _keys;
+
+    partition_groups_t _partition_groups;
+    std::vector<peer_group> _peer_groups;
+
+    boost::detail::atomic_count _pending_count;
+};
+
+}
+}
+}
+
+#endif
+
@@ -0,0 +1,68 @@
+#include "samoa/server/command/multi_get.hpp"
+#include "samoa/server/local_partition.hpp"
+#include "samoa/persistence/persister.hpp"
+#include "samoa/request/request_state.hpp"
+#include "samoa/request/state_exception.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+#include <boost/make_shared.hpp>
+#include <boost/bind.hpp>
+
+namespace samoa {
+namespace server {
+namespace command {
+
+namespace spb = samoa::core::protobuf;
+
+void multi_get_handler::handle(const request::state::ptr_t & rstate)
+{
+    rstate->load_table_state();
+
+    if(multi_blob_batch::exceeds_primary_quorum(rstate))
+    {
+        throw request::state_exception(400,
+            "MULTI_GET supports only a requested quorum of 1");
+    }
+
+    multi_blob_batch::ptr_t batch = \
+        boost::make_shared<multi_blob_batch>(rstate);
+
+    batch->route();
+
+    multi_blob_batch::partition_groups_t & groups = \
+        batch->get_partition_groups();
+
+    for(auto it = groups.begin(); it != groups.end(); ++it)
+    {
+        it->partition->get_persister()->get_batch(
+            boost::bind(&multi_get_handler::on_get_batch,
+                shared_from_this(), batch, boost::ref(*it)),
+            it->batch);
+    }
+
+    batch->forward_peer_groups();
+}
+
+void multi_get_handler::on_get_batch(
+    const multi_blob_batch::ptr_t & batch,
+    multi_blob_batch::partition_group & group)
+{
+    for(size_t i = 0; i != group.key_indices.size(); ++i)
+    {
+        multi_blob_batch::key_state & kstate = \
+            batch->get_key_state(group.key_indices[i]);
+
+        if(group.batch[i].found)
+        {
+            kstate.result.mutable_cluster_clock()->CopyFrom(
+                kstate.local_record.cluster_clock());
+        }
+        kstate.result.set_value_count(
+            kstate.local_record.blob_value_size());
+    }
+    batch->complete_group();
+}
+
+}
+}
+}
+
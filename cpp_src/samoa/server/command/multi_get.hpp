@@ -0,0 +1,46 @@
+#ifndef SAMOA_SERVER_COMMAND_MULTI_GET_HPP
+#define SAMOA_SERVER_COMMAND_MULTI_GET_HPP
+
+#include "samoa/server/fwd.hpp"
+#include "samoa/server/command_handler.hpp"
+#include "samoa/server/command/multi_blob.hpp"
+#include "samoa/request/fwd.hpp"
+#include <boost/smart_ptr/enable_shared_from_this.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace samoa {
+namespace server {
+namespace command {
+
+/*!
+ * Reads a batch of keys, with a single persister pass per local
+ *  partition and a single forwarded request per peer server.
+ *
+ * Reads are local to the primary partition of each key (as are
+ *  GET_BLOB reads having a quorum of 1), and requests for a larger
+ *  quorum are rejected.
+ */
+class multi_get_handler :
+    public command_handler,
+    public boost::enable_shared_from_this<multi_get_handler>
+{
+public:
+
+    typedef boost::shared_ptr<multi_get_handler> ptr_t;
+
+    multi_get_handler()
+    { }
+
+    void handle(const request::state_ptr_t &);
+
+private:
+
+    void on_get_batch(const multi_blob_batch::ptr_t &,
+        multi_blob_batch::partition_group &);
+};
+
+}
+}
+}
+
+#endif
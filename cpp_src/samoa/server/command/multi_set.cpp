@@ -0,0 +1,127 @@
+#include "samoa/server/command/multi_set.hpp"
+#include "samoa/server/table.hpp"
+#include "samoa/server/local_partition.hpp"
+#include "samoa/persistence/persister.hpp"
+#include "samoa/persistence/replication_log.hpp"
+#include "samoa/request/request_state.hpp"
+#include "samoa/request/state_exception.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+#include "samoa/datamodel/clock_util.hpp"
+#include <boost/make_shared.hpp>
+#include <boost/bind.hpp>
+
+namespace samoa {
+namespace server {
+namespace command {
+
+namespace spb = samoa::core::protobuf;
+
+void multi_set_handler::handle(const request::state::ptr_t & rstate)
+{
+    if(rstate->get_request_data_blocks().size() != \
+        (size_t) rstate->get_samoa_request().multi_key_size())
+    {
+        throw request::state_exception(400,
+            "expected exactly one data block per key");
+    }
+
+    rstate->load_table_state();
+
+    if(multi_blob_batch::exceeds_primary_quorum(rstate))
+    {
+        throw request::state_exception(400,
+            "MULTI_SET supports only a requested quorum of 1");
+    }
+
+    multi_blob_batch::ptr_t batch = \
+        boost::make_shared<multi_blob_batch>(rstate);
+
+    batch->route();
+
+    multi_blob_batch::partition_groups_t & groups = \
+        batch->get_partition_groups();
+
+    for(auto it = groups.begin(); it != groups.end(); ++it)
+    {
+        const core::uuid & partition_uuid = it->partition->get_uuid();
+
+        for(auto k_it = it->key_indices.begin();
+            k_it != it->key_indices.end(); ++k_it)
+        {
+            spb::PersistedRecord & record = \
+                batch->get_key_state(*k_it).remote_record;
+
+            // assume the key doesn't exist; initial clock tick for first write
+            datamodel::clock_util::tick(*record.mutable_cluster_clock(),
+                partition_uuid);
+
+            record.add_blob_value()->assign(
+                boost::asio::buffers_begin(
+                    rstate->get_request_data_blocks()[*k_it]),
+                boost::asio::buffers_end(
+                    rstate->get_request_data_blocks()[*k_it]));
+        }
+
+        it->partition->get_persister()->put_batch(
+            boost::bind(&multi_set_handler::on_put_batch,
+                shared_from_this(), batch, boost::ref(*it)),
+            boost::bind(&multi_set_handler::on_merge,
+                shared_from_this(), _1, _2, rstate, partition_uuid),
+            it->batch);
+    }
+
+    batch->forward_peer_groups();
+}
+
+datamodel::merge_result multi_set_handler::on_merge(
+    spb::PersistedRecord & local_record,
+    const spb::PersistedRecord & remote_record,
+    const request::state::ptr_t & rstate,
+    const core::uuid & partition_uuid)
+{
+    // tick the local clock to reflect this operation
+    datamodel::clock_util::tick(*local_record.mutable_cluster_clock(),
+        partition_uuid);
+
+    datamodel::clock_util::prune_record(local_record,
+        rstate->get_table()->get_consistency_horizon());
+
+    local_record.mutable_blob_value()->CopyFrom(remote_record.blob_value());
+
+    datamodel::merge_result result;
+    result.local_was_updated = true;
+    result.remote_is_stale = true;
+    return result;
+}
+
+void multi_set_handler::on_put_batch(
+    const multi_blob_batch::ptr_t & batch,
+    multi_blob_batch::partition_group & group)
+{
+    for(size_t i = 0; i != group.key_indices.size(); ++i)
+    {
+        const persistence::persister::batch_entry & entry = group.batch[i];
+
+        if(entry.error)
+        {
+            batch->set_key_error(group.key_indices[i], 500, entry.error);
+            continue;
+        }
+
+        multi_blob_batch::key_state & kstate = \
+            batch->get_key_state(group.key_indices[i]);
+
+        kstate.result.set_success(entry.merge_result.local_was_updated);
+        kstate.result.mutable_cluster_clock()->CopyFrom(
+            kstate.local_record.cluster_clock());
+
+        group.partition->get_replication_log()->append(
+            *entry.key, kstate.local_record.cluster_clock());
+    }
+    batch->complete_group();
+}
+
+}
+}
+}
+
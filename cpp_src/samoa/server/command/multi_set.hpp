@@ -0,0 +1,58 @@
+#ifndef SAMOA_SERVER_COMMAND_MULTI_SET_HPP
+#define SAMOA_SERVER_COMMAND_MULTI_SET_HPP
+
+#include "samoa/server/fwd.hpp"
+#include "samoa/server/command_handler.hpp"
+#include "samoa/server/command/multi_blob.hpp"
+#include "samoa/datamodel/merge_func.hpp"
+#include "samoa/request/fwd.hpp"
+#include "samoa/core/protobuf/fwd.hpp"
+#include "samoa/core/uuid.hpp"
+#include <boost/smart_ptr/enable_shared_from_this.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace samoa {
+namespace server {
+namespace command {
+
+namespace spb = samoa::core::protobuf;
+
+/*!
+ * Writes a batch of keys, with a single persister pass per local
+ *  partition and a single forwarded request per peer server.
+ *
+ * Each key's value is carried by the request data block of the same
+ *  index. Writes are unconditional, and are acknowledged once committed
+ *  by the primary partition; they reach peer partitions through the
+ *  replication log and anti-entropy, rather than synchronously. As
+ *  this is the durability of a quorum of 1, larger requested quorums
+ *  (including 0, of all replicas) are rejected.
+ */
+class multi_set_handler :
+    public command_handler,
+    public boost::enable_shared_from_this<multi_set_handler>
+{
+public:
+
+    typedef boost::shared_ptr<multi_set_handler> ptr_t;
+
+    multi_set_handler()
+    { }
+
+    void handle(const request::state_ptr_t &);
+
+private:
+
+    datamodel::merge_result on_merge(spb::PersistedRecord &,
+        const spb::PersistedRecord &, const request::state_ptr_t &,
+        const core::uuid & partition_uuid);
+
+    void on_put_batch(const multi_blob_batch::ptr_t &,
+        multi_blob_batch::partition_group &);
+};
+
+}
+}
+}
+
+#endif
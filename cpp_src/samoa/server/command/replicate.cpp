@@ -8,6 +8,7 @@
 #include "samoa/request/request_state.hpp"
 #include "samoa/request/state_exception.hpp"
 #include "samoa/persistence/persister.hpp"
+#include "samoa/persistence/replication_log.hpp"
 #include "samoa/core/protobuf/fwd.hpp"
 #include "samoa/core/protobuf/samoa.pb.h"
 #include "samoa/error.hpp"
@@ -45,10 +46,8 @@ void replicate_handler::handle(const request::state::ptr_t & rstate)
         }
 
         // parse into remote-record
-        core::zero_copy_input_adapter zci_adapter(
-            rstate->get_request_data_blocks()[0]);
-        SAMOA_ASSERT(rstate->get_remote_record(
-            ).ParseFromZeroCopyStream(&zci_adapter));
+        SAMOA_ASSERT(core::parse_from_regions(rstate->get_remote_record(),
+            rstate->get_request_data_blocks()[0]));
 
         rstate->get_primary_partition()->get_persister()->put(
             boost::bind(&replicate_handler::on_write,
@@ -80,6 +79,12 @@ void replicate_handler::on_write(const boost::system::error_code & ec,
         return;
     }
 
+    if(merge_result.local_was_updated)
+    {
+        rstate->get_primary_partition()->get_replication_log()->append(
+            rstate->get_key(), rstate->get_local_record().cluster_clock());
+    }
+
     // write is committed; notify client
     rstate->flush_response();
 
@@ -106,8 +111,7 @@ void replicate_handler::on_read(const boost::system::error_code & ec,
     if(found)
     {
         core::zero_copy_output_adapter zco_adapter;
-        SAMOA_ASSERT(rstate->get_local_record(
-            ).SerializeToZeroCopyStream(&zco_adapter));
+        zco_adapter.serialize(rstate->get_local_record());
 
         rstate->add_response_data_block(zco_adapter.output_regions());
     }
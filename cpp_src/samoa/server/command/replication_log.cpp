@@ -0,0 +1,62 @@
+
+#include "samoa/server/command/replication_log.hpp"
+#include "samoa/server/local_partition.hpp"
+#include "samoa/server/table.hpp"
+#include "samoa/persistence/replication_log.hpp"
+#include "samoa/request/request_state.hpp"
+#include "samoa/request/state_exception.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+#include <sstream>
+#include <vector>
+
+namespace samoa {
+namespace server {
+namespace command {
+
+namespace spb = samoa::core::protobuf;
+
+void replication_log_handler::handle(const request::state::ptr_t & rstate)
+{
+    rstate->load_table_state();
+
+    if(!rstate->has_primary_partition_uuid())
+    {
+        throw request::state_exception(400, "expected partition_uuid");
+    }
+
+    local_partition::ptr_t partition = \
+        boost::dynamic_pointer_cast<local_partition>(
+            rstate->get_table()->get_partition(
+                rstate->get_primary_partition_uuid()));
+
+    if(!partition)
+    {
+        std::stringstream err;
+        err << "partition " << rstate->get_primary_partition_uuid();
+        err << " is not local";
+        throw request::state_exception(404, err.str());
+    }
+
+    std::vector<std::string> entries;
+    uint64_t next_sequence;
+
+    if(!partition->get_replication_log()->read(
+        rstate->get_samoa_request().log_sequence(),
+        max_entries_per_response, entries, next_sequence))
+    {
+        rstate->get_samoa_response().set_log_truncated(true);
+    }
+
+    for(auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        rstate->add_response_data_block(it->begin(), it->end());
+    }
+
+    rstate->get_samoa_response().set_log_sequence(next_sequence);
+    rstate->flush_response();
+}
+
+}
+}
+}
+
@@ -0,0 +1,43 @@
+#ifndef SAMOA_SERVER_COMMAND_REPLICATION_LOG_HPP
+#define SAMOA_SERVER_COMMAND_REPLICATION_LOG_HPP
+
+#include "samoa/server/fwd.hpp"
+#include "samoa/server/command_handler.hpp"
+#include "samoa/request/fwd.hpp"
+#include <boost/smart_ptr/enable_shared_from_this.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace samoa {
+namespace server {
+namespace command {
+
+/*!
+ * Returns entries of a local partition's replication_log, beginning
+ *  at SamoaRequest::log_sequence, as ReplicationLogEntry data blocks.
+ *
+ * A catching-up peer issues successive requests, each from the
+ *  SamoaResponse::log_sequence of the last, until no entries remain.
+ */
+class replication_log_handler :
+    public command_handler,
+    public boost::enable_shared_from_this<replication_log_handler>
+{
+public:
+
+    typedef boost::shared_ptr<replication_log_handler> ptr_t;
+
+    //! Maximum number of entries returned by a single response
+    static const unsigned max_entries_per_response = 1024;
+
+    replication_log_handler()
+    { }
+
+    void handle(const request::state_ptr_t &);
+};
+
+}
+}
+}
+
+#endif
+
@@ -7,6 +7,7 @@
 #include "samoa/server/local_partition.hpp"
 #include "samoa/server/replication.hpp"
 #include "samoa/persistence/persister.hpp"
+#include "samoa/persistence/replication_log.hpp"
 #include "samoa/request/request_state.hpp"
 #include "samoa/request/state_exception.hpp"
 #include "samoa/core/protobuf/fwd.hpp"
@@ -48,10 +49,13 @@ void set_blob_handler::handle(const request::state::ptr_t & rstate)
     datamodel::clock_util::tick(*record.mutable_cluster_clock(),
         rstate->get_primary_partition_uuid());
 
-    // assign client's value
-    record.add_blob_value()->assign(
-        boost::asio::buffers_begin(rstate->get_request_data_blocks()[0]),
-        boost::asio::buffers_end(rstate->get_request_data_blocks()[0]));
+    // assign client's value, unless it was streamed into the record
+    if(!record.blob_value_size())
+    {
+        record.add_blob_value()->assign(
+            boost::asio::buffers_begin(rstate->get_request_data_blocks()[0]),
+            boost::asio::buffers_end(rstate->get_request_data_blocks()[0]));
+    }
 
     rstate->get_primary_partition()->get_persister()->put(
         boost::bind(&set_blob_handler::on_put,
@@ -63,6 +67,15 @@ void set_blob_handler::handle(const request::state::ptr_t & rstate)
         rstate->get_local_record());
 }
 
+std::string * set_blob_handler::stream_data_block(
+    const request::state::ptr_t & rstate, unsigned block_index, size_t)
+{
+    if(block_index != 0)
+        return 0;
+
+    return rstate->get_remote_record().add_blob_value();
+}
+
 datamodel::merge_result set_blob_handler::on_merge(
     spb::PersistedRecord & local_record,
     const spb::PersistedRecord & remote_record,
@@ -123,6 +136,9 @@ void set_blob_handler::on_put(
 
     rstate->get_samoa_response().set_success(true);
 
+    rstate->get_primary_partition()->get_replication_log()->append(
+        rstate->get_key(), rstate->get_local_record().cluster_clock());
+
     // local write was a success
     if(rstate->peer_replication_success())
     {
@@ -33,6 +33,10 @@ public:
 
     void handle(const request::state_ptr_t &);
 
+    //! Streams a large value directly into the remote record
+    std::string * stream_data_block(const request::state_ptr_t &,
+        unsigned block_index, size_t length);
+
 private:
 
     datamodel::merge_result on_merge(spb::PersistedRecord &,
@@ -10,6 +10,11 @@ void command_handler::checked_handle(const request::state::ptr_t & rstate)
     try
     {
         rstate->parse_samoa_request();
+
+        // the request may have expired while queued
+        if(rstate->drop_if_expired())
+            return;
+
         handle(rstate);
     }
     catch(const request::state_exception & e)
@@ -4,6 +4,7 @@
 #include "samoa/server/fwd.hpp"
 #include "samoa/request/fwd.hpp"
 #include <boost/noncopyable.hpp>
+#include <string>
 
 namespace samoa {
 namespace server {
@@ -41,6 +42,22 @@ public:
      */
     void checked_handle(const request::state_ptr_t &);
 
+    /*!
+     * Offers to stream a large request data-block as it's read.
+     *
+     * Returns a string into which the data-block's length bytes are
+     *  appended as they arrive from the client, or null if the block
+     *  should instead be buffered in full. Called prior to handle(),
+     *  and before the request has been parsed into request::state.
+     *
+     * A streamed block remains available through
+     *  request::state::get_request_data_blocks(), as a region of the
+     *  returned string (which must live as long as the request).
+     */
+    virtual std::string * stream_data_block(const request::state_ptr_t &,
+        unsigned /* block_index */, size_t /* length */)
+    { return 0; }
+
 protected:
 
     virtual void handle(const request::state_ptr_t &) = 0;
@@ -0,0 +1,78 @@
+
+#include "samoa/server/digest.hpp"
+#include "samoa/server/table.hpp"
+#include "samoa/persistence/record.hpp"
+#include "samoa/persistence/rolling_hash.hpp"
+#include "samoa/error.hpp"
+#include <boost/functional/hash.hpp>
+
+namespace samoa {
+namespace server {
+
+digest::digest()
+ : _ranges(range_count, 0)
+{ }
+
+void digest::on_commit(const std::string & key,
+    const persistence::record * previous_record,
+    const persistence::record * written_record)
+{
+    uint64_t delta = 0;
+
+    if(previous_record)
+        delta ^= record_hash(*previous_record);
+
+    if(written_record)
+        delta ^= record_hash(*written_record);
+
+    unsigned range = range_of(table::key_ring_position(key));
+
+    spinlock::guard guard(_lock);
+    _ranges[range] ^= delta;
+}
+
+void digest::add_layer_records(const persistence::rolling_hash & layer)
+{
+    spinlock::guard guard(_lock);
+
+    for(const persistence::record * rec = layer.head(); rec;
+        rec = layer.step(rec))
+    {
+        if(rec->is_dead())
+            continue;
+
+        std::string key(rec->key_begin(), rec->key_end());
+        _ranges[range_of(table::key_ring_position(key))] ^= record_hash(*rec);
+    }
+}
+
+uint64_t digest::get_range_digests(unsigned begin, unsigned count,
+    std::vector<uint64_t> & range_digests) const
+{
+    SAMOA_ASSERT(begin < range_count && count <= range_count);
+
+    uint64_t combined = 0;
+    range_digests.reserve(range_digests.size() + count);
+
+    spinlock::guard guard(_lock);
+
+    for(unsigned i = 0; i != count; ++i)
+    {
+        uint64_t d = _ranges[(begin + i) % range_count];
+
+        range_digests.push_back(d);
+        combined ^= d;
+    }
+    return combined;
+}
+
+uint64_t digest::record_hash(const persistence::record & rec)
+{
+    size_t seed = boost::hash_range(rec.key_begin(), rec.key_end());
+    boost::hash_range(seed, rec.value_begin(), rec.value_end());
+    return seed;
+}
+
+}
+}
+
@@ -0,0 +1,84 @@
+#ifndef SAMOA_SERVER_DIGEST_HPP
+#define SAMOA_SERVER_DIGEST_HPP
+
+#include "samoa/server/fwd.hpp"
+#include "samoa/persistence/fwd.hpp"
+#include "samoa/spinlock.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace samoa {
+namespace server {
+
+/*!
+ * Incrementally-maintained digests of a local partition's records.
+ *
+ * The hash-ring continuum is divided into range_count equal ranges,
+ *  and the digest of a range is the XOR of the hashes of each record
+ *  (key & value bytes) having a ring position within it. XOR allows
+ *  the digest to be updated in place as records are written or dropped,
+ *  and replicas which hold the same records in a range will have equal
+ *  range digests, regardless of write order.
+ */
+class digest
+{
+public:
+
+    typedef digest_ptr_t ptr_t;
+
+    //! log2 of the number of ranges the ring continuum is divided into
+    static const unsigned range_bits = 14;
+    static const unsigned range_count = 1 << range_bits;
+
+    digest();
+
+    //! Index of the range holding ring_position
+    static unsigned range_of(uint64_t ring_position)
+    { return ring_position >> (64 - range_bits); }
+
+    //! Ring position beginning the range (inclusive)
+    static uint64_t range_begin(unsigned range)
+    { return uint64_t(range) << (64 - range_bits); }
+
+    //! Ring position ending the range (inclusive)
+    static uint64_t range_end(unsigned range)
+    { return range_begin(range) | ((uint64_t(1) << (64 - range_bits)) - 1); }
+
+    /*!
+     * Updates the digest to reflect a committed write or drop
+     *  of key, in the manner of persister::commit_callback_t
+     */
+    void on_commit(const std::string & key,
+        const persistence::record * previous_record,
+        const persistence::record * written_record);
+
+    /*!
+     * Adds each live record of the layer to the digest. Used to seed
+     *  the digest with records persisted prior to its construction
+     *  (eg, of a mapped layer), before any commit is observed.
+     */
+    void add_layer_records(const persistence::rolling_hash &);
+
+    /*!
+     * Copies out digests of range_count ranges beginning at range_begin,
+     *  wrapping from the last range to the first, and returns their
+     *  combined (XOR'd) digest.
+     */
+    uint64_t get_range_digests(unsigned range_begin, unsigned range_count,
+        std::vector<uint64_t> & range_digests) const;
+
+private:
+
+    static uint64_t record_hash(const persistence::record &);
+
+    std::vector<uint64_t> _ranges;
+
+    mutable spinlock _lock;
+};
+
+}
+}
+
+#endif
+
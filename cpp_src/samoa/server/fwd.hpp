@@ -50,6 +50,15 @@ typedef boost::shared_ptr<remote_partition> remote_partition_ptr_t;
 class peer_discovery;
 typedef boost::shared_ptr<peer_discovery> peer_discovery_ptr_t;
 
+class digest;
+typedef boost::shared_ptr<digest> digest_ptr_t;
+
+class anti_entropy;
+typedef boost::shared_ptr<anti_entropy> anti_entropy_ptr_t;
+
+class request_scheduler;
+typedef boost::shared_ptr<request_scheduler> request_scheduler_ptr_t;
+
 }
 }
 
@@ -15,22 +15,43 @@ namespace server {
 
 using namespace boost::asio;
 
+typedef boost::asio::detail::socket_option::boolean<
+    SOL_SOCKET, SO_REUSEPORT> reuse_port;
+
 listener::listener(const context_ptr_t & context,
     const protocol_ptr_t & protocol)
  : core::tasklet<listener>(
         core::proactor::get_proactor()->serial_io_service()),
    _context(context),
    _protocol(protocol),
+   _accepting_core_only(false),
+   _accept_sock(*get_io_service())
+{
+    bind_and_listen(false);
+}
+
+listener::listener(const context_ptr_t & context,
+    const protocol_ptr_t & protocol,
+    const core::io_service_ptr_t & io_srv)
+ : core::tasklet<listener>(io_srv),
+   _context(context),
+   _protocol(protocol),
+   _accepting_core_only(true),
    _accept_sock(*get_io_service())
+{
+    bind_and_listen(true);
+}
+
+void listener::bind_and_listen(bool reuse)
 {
     std::string str_port = boost::lexical_cast<std::string>(
-        context->get_server_port());
+        _context->get_server_port());
 
     set_tasklet_name("listener<" + \
-        context->get_server_hostname() + ":" + str_port + ">");
+        _context->get_server_hostname() + ":" + str_port + ">");
 
     // build resolution query
-    ip::tcp::resolver::query query(context->get_server_hostname(), str_port);
+    ip::tcp::resolver::query query(_context->get_server_hostname(), str_port);
 
     // blocks, & throws on resolution failure
     ip::tcp::endpoint ep = *ip::tcp::resolver(
@@ -39,6 +60,12 @@ listener::listener(const context_ptr_t & context,
     // open & bind the listening socket
     _accept_sock.open(ep.protocol());
     _accept_sock.set_option(ip::tcp::acceptor::reuse_address(true));
+
+    if(reuse)
+    {
+        _accept_sock.set_option(reuse_port(true));
+    }
+
     _accept_sock.bind(ep);
     _accept_sock.listen();
 
@@ -100,7 +127,14 @@ void listener::on_accept(const boost::system::error_code & ec)
     }
 
     // Next connection to accept
-    _next_io_srv = core::proactor::get_proactor()->serial_io_service();
+    if(_accepting_core_only)
+    {
+        _next_io_srv = get_io_service();
+    }
+    else
+    {
+        _next_io_srv = core::proactor::get_proactor()->serial_io_service();
+    }
     _next_sock.reset(new ip::tcp::socket(*_next_io_srv));
 
     // Schedule call on accept
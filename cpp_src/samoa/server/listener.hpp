@@ -16,8 +16,20 @@ public:
 
     using core::tasklet<listener>::ptr_t;
 
+    //! Accepts on a serial io_service; clients are spread round-robin
     listener(const context_ptr_t &, const protocol_ptr_t &);
 
+    /*!
+     * Accepts on the given serial io_service, and serves accepted
+     *  clients entirely on that same io_service.
+     *
+     * The listening socket is bound with SO_REUSEPORT, so that one such
+     *  listener may be run per (pinned) serial io_service, and the kernel
+     *  balances incoming connections across them.
+     */
+    listener(const context_ptr_t &, const protocol_ptr_t &,
+        const core::io_service_ptr_t &);
+
     ~listener();
 
     std::string get_address();
@@ -34,11 +46,16 @@ public:
 
 private:
 
+    void bind_and_listen(bool reuse_port);
+
     void on_accept(const boost::system::error_code & ec);
 
     const context_ptr_t  _context;
     const protocol_ptr_t _protocol;
 
+    // if true, clients are served on the listener's io_service
+    const bool _accepting_core_only;
+
     boost::asio::ip::tcp::acceptor _accept_sock;
 
     // Next connection to accept, and it's io_service
@@ -1,7 +1,14 @@
 #include "samoa/server/local_partition.hpp"
+#include "samoa/server/digest.hpp"
+#include "samoa/server/anti_entropy.hpp"
+#include "samoa/server/context.hpp"
 #include "samoa/persistence/persister.hpp"
+#include "samoa/persistence/replication_log.hpp"
+#include "samoa/persistence/record_cache.hpp"
+#include "samoa/core/tasklet_group.hpp"
 #include "samoa/error.hpp"
 #include "samoa/log.hpp"
+#include <boost/bind.hpp>
 
 namespace samoa {
 namespace server {
@@ -17,10 +24,17 @@ local_partition::local_partition(
     if(current)
     {
         _persister = current->_persister;
+        _replication_log = current->_replication_log;
+        _digest = current->_digest;
+        _anti_entropy = current->_anti_entropy;
     }
     else
     {
         _persister.reset(new persistence::persister());
+        _digest.reset(new digest());
+
+        _persister->set_commit_callback(
+            boost::bind(&digest::on_commit, _digest, _1, _2, _3));
 
         LOG_DBG("local_partition " << part.uuid() \
             << " built persister " << _persister.get());
@@ -39,9 +53,44 @@ local_partition::local_partition(
                     it->storage_size(), it->index_size());
             }
         }
+
+        // seed the digest with records already held by (mapped) layers
+        for(size_t i = 0; i != _persister->get_layer_count(); ++i)
+        {
+            _digest->add_layer_records(_persister->get_layer(i));
+        }
+
+        if(part.record_cache_size())
+        {
+            _persister->set_record_cache(
+                boost::make_shared<persistence::record_cache>(
+                    part.record_cache_size()));
+        }
+
+        if(part.has_replication_log_path())
+        {
+            _replication_log.reset(new persistence::replication_log(
+                part.replication_log_path(), part.replication_log_size()));
+        }
+        else
+        {
+            _replication_log.reset(new persistence::replication_log(
+                part.replication_log_size()));
+        }
     }
 }
 
+void local_partition::spawn_tasklets(const context::ptr_t & context,
+    const core::uuid & table_uuid)
+{
+    if(_anti_entropy)
+        return;
+
+    _anti_entropy = boost::make_shared<anti_entropy>(
+        context, table_uuid, get_uuid());
+    context->get_tasklet_group()->start_managed_tasklet(_anti_entropy);
+}
+
 bool local_partition::merge_partition(
     const spb::ClusterState::Table::Partition & peer,
     spb::ClusterState::Table::Partition & local) const
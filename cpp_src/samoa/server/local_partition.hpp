@@ -7,6 +7,7 @@
 #include "samoa/persistence/fwd.hpp"
 #include "samoa/core/protobuf/samoa.pb.h"
 #include "samoa/core/fwd.hpp"
+#include "samoa/core/uuid.hpp"
 #include <boost/shared_ptr.hpp>
 
 namespace samoa {
@@ -33,7 +34,15 @@ public:
     const persistence::persister_ptr_t & get_persister()
     { return _persister; }
 
-    void spawn_tasklets(const context_ptr_t &);
+    //! Bounded log of writes committed to this partition
+    const persistence::replication_log_ptr_t & get_replication_log()
+    { return _replication_log; }
+
+    //! Digests of this partition's records, by ring range
+    const digest_ptr_t & get_digest()
+    { return _digest; }
+
+    void spawn_tasklets(const context_ptr_t &, const core::uuid & table_uuid);
 
     bool merge_partition(
         const spb::ClusterState::Table::Partition & peer,
@@ -42,6 +51,10 @@ public:
 private:
 
     persistence::persister_ptr_t _persister;
+    persistence::replication_log_ptr_t _replication_log;
+    digest_ptr_t _digest;
+
+    anti_entropy_ptr_t _anti_entropy;
 };
 
 }
@@ -66,10 +66,16 @@ void peer_discovery::on_request(
         return;
     }
 
-    // serialize current cluster-state protobuf description;
+    // serialize current cluster-state protobuf description,
+    //  with our statistics of each peer
+    spb::ClusterState description(
+        context->get_cluster_state()->get_protobuf_description());
+
+    context->get_cluster_state()->get_peer_set(
+        )->set_peer_statistics(description);
+
     core::zero_copy_output_adapter zco_adapter;
-    context->get_cluster_state()->get_protobuf_description(
-        ).SerializeToZeroCopyStream(&zco_adapter);
+    zco_adapter.serialize(description);
 
     iface.get_message().set_type(spb::CLUSTER_STATE);
     iface.add_data_block(zco_adapter.output_regions());
@@ -104,9 +110,8 @@ void peer_discovery::on_response(
     // parse returned ClusterState protobuf message
     SAMOA_ASSERT(iface.get_response_data_blocks().size() == 1);
 
-    core::zero_copy_input_adapter zci_adapter(
-        iface.get_response_data_blocks()[0]);
-    SAMOA_ASSERT(_remote_state.ParseFromZeroCopyStream(&zci_adapter));
+    SAMOA_ASSERT(core::parse_from_regions(_remote_state,
+        iface.get_response_data_blocks()[0]));
 
     context->cluster_state_transaction(
         boost::bind(&peer_discovery::on_state_transaction,
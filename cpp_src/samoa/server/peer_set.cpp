@@ -219,6 +219,28 @@ void peer_set::merge_peer_set(const spb::ClusterState & peer,
     }
 }
 
+void peer_set::set_peer_statistics(spb::ClusterState & state)
+{
+    for(auto it = state.mutable_peer()->begin();
+        it != state.mutable_peer()->end(); ++it)
+    {
+        core::uuid uuid = core::parse_uuid(it->uuid());
+
+        if(!has_server(uuid))
+            continue;
+
+        server_stats stats = get_server_stats(uuid);
+
+        it->set_connected(stats.connected);
+        it->set_queue_size(stats.queue_size);
+
+        if(stats.has_latency)
+            it->set_latency_ms((stats.latency_us + 999) / 1000);
+        else
+            it->clear_latency_ms();
+    }
+}
+
 void peer_set::forward_request(const request::state::ptr_t & rstate)
 {
     SAMOA_ASSERT(!rstate->get_primary_partition());
@@ -229,28 +251,17 @@ void peer_set::forward_request(const request::state::ptr_t & rstate)
         return;
     }
 
-    unsigned best_peer_latency = std::numeric_limits<unsigned>::max();
-    core::uuid best_peer_uuid = boost::uuids::nil_uuid();
+    std::vector<core::uuid> candidates;
 
     for(auto it = rstate->get_peer_partitions().begin();
         it != rstate->get_peer_partitions().end(); ++it)
     {
-        unsigned peer_latency = std::numeric_limits<unsigned>::max();
-        core::uuid peer_uuid = (*it)->get_server_uuid();
-
-        // TODO(johng): factor actual latency into this selection
-        samoa::client::server::ptr_t server = get_server(peer_uuid);
-        if(server)
-        {
-            peer_latency = 0;
-        }
-
-        if(peer_latency < best_peer_latency)
-        {
-            best_peer_uuid = peer_uuid;
-        }
+        candidates.push_back((*it)->get_server_uuid());
     }
 
+    // prefer the less-loaded of two random peers
+    core::uuid best_peer_uuid = select_server(candidates);
+
     schedule_request(
         boost::bind(&peer_set::on_forwarded_request,
             boost::dynamic_pointer_cast<peer_set>(shared_from_this()),
@@ -269,8 +280,17 @@ void peer_set::on_forwarded_request(
         return;
     }
 
+    // the peer connection may have been slow to become available
+    if(rstate->drop_if_expired())
+    {
+        iface.abort_request();
+        return;
+    }
+
     iface.get_message().CopyFrom(rstate->get_samoa_request());
     iface.get_message().clear_data_block_length();
+    iface.get_message().set_forwarded(true);
+    rstate->propagate_deadline(iface.get_message());
 
     for(auto it = rstate->get_request_data_blocks().begin();
         it != rstate->get_request_data_blocks().end(); ++it)
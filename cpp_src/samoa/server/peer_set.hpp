@@ -26,6 +26,14 @@ public:
     void merge_peer_set(const spb::ClusterState & peer,
         spb::ClusterState & local) const;
 
+    /*! \brief Sets this server's statistics of each peer of the
+     *   ClusterState (connected, queue_size, & latency_ms)
+     *
+     * Statistics are local & volatile, and are set only
+     *  on descriptions published to peers and clients.
+     */
+    void set_peer_statistics(spb::ClusterState &);
+
     /*! \brief Forwards the client request to a peer server
     */
     void forward_request(const request::state_ptr_t &);
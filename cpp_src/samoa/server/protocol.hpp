@@ -2,6 +2,8 @@
 #define SAMOA_SERVER_PROTOCOL_HPP
 
 #include "samoa/server/fwd.hpp"
+#include "samoa/server/request_scheduler.hpp"
+#include <boost/make_shared.hpp>
 #include <boost/noncopyable.hpp>
 #include <vector>
 
@@ -14,6 +16,10 @@ public:
 
     typedef protocol_ptr_t ptr_t;
 
+    protocol()
+     : _request_scheduler(boost::make_shared<request_scheduler>())
+    { }
+
     void set_command_handler(unsigned operation_type,
         const command_handler_ptr_t & handler)
     {
@@ -27,9 +33,15 @@ public:
         unsigned operation_type)
     { return _handler_table.at(operation_type); }
 
+    //! Scheduler admitting requests to their command handlers
+    const request_scheduler_ptr_t & get_request_scheduler() const
+    { return _request_scheduler; }
+
 private:
 
     std::vector<command_handler_ptr_t> _handler_table;
+
+    const request_scheduler_ptr_t _request_scheduler;
 };
 
 }
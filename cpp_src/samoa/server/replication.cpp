@@ -5,13 +5,236 @@
 #include "samoa/server/partition.hpp"
 #include "samoa/server/table.hpp"
 #include "samoa/request/request_state.hpp"
+#include "samoa/core/timer_wheel.hpp"
 #include "samoa/error.hpp"
 #include "samoa/log.hpp"
+#include <boost/smart_ptr/make_shared.hpp>
 #include <boost/bind.hpp>
+#include <algorithm>
+#include <vector>
+
+#define DEFAULT_HEDGE_QUANTILE 0.95
+#define DEFAULT_MAX_HEDGE_DELAY_MS 50
 
 namespace samoa {
 namespace server {
 
+static bool hedged_reads = true;
+static double hedge_quantile = DEFAULT_HEDGE_QUANTILE;
+static unsigned max_hedge_delay_ms = DEFAULT_MAX_HEDGE_DELAY_MS;
+
+static unsigned hedge_count = 0;
+
+/*!
+ * A replicated read, sent to peers in order of recent latency.
+ *
+ * Callbacks are invoked from the request's io_service, which
+ *  serializes access to the hedged_read.
+ */
+class replication::hedged_read :
+    public boost::enable_shared_from_this<hedged_read>
+{
+public:
+
+    hedged_read(const callback_t & callback,
+        const request::state::ptr_t & rstate)
+     : _callback(callback),
+       _rstate(rstate),
+       _next_peer(0)
+    { }
+
+    void start()
+    {
+        order_peers();
+
+        unsigned needed = _rstate->get_quorum_count() - \
+            _rstate->get_peer_success_count();
+
+        unsigned delay_ms = 0;
+
+        while(needed-- && _next_peer != _peers.size())
+        {
+            delay_ms = std::max(delay_ms, send_next());
+        }
+        schedule_hedge(delay_ms);
+    }
+
+    //! Hedges a failed peer with the next, if the read is still needed
+    void on_peer_failure()
+    {
+        if(!_rstate->is_replication_finished() &&
+            _next_peer != _peers.size())
+        {
+            __sync_fetch_and_add(&hedge_count, 1);
+            send_next();
+
+            // no peers remain to hedge with
+            if(_next_peer == _peers.size() && _timer)
+                _timer->cancel();
+        }
+    }
+
+private:
+
+    struct ranked_peer
+    {
+        partition::ptr_t peer_partition;
+
+        // expected wait (see server_pool::get_server_load)
+        unsigned load;
+
+        // hedge-quantile of latency, if sampled
+        bool has_latency;
+        unsigned latency_us;
+
+        bool operator < (const ranked_peer & other) const
+        { return load < other.load; }
+    };
+
+    void order_peers()
+    {
+        const peer_set::ptr_t & peer_set = _rstate->get_peer_set();
+
+        const request::route_state::partitions_t & peers = \
+            _rstate->get_peer_partitions();
+
+        std::vector<core::uuid> candidates;
+        _peers.resize(peers.size());
+
+        for(size_t i = 0; i != peers.size(); ++i)
+        {
+            ranked_peer & peer = _peers[i];
+            const core::uuid & server_uuid = peers[i]->get_server_uuid();
+
+            peer.peer_partition = peers[i];
+            peer.load = peer_set->get_server_load(server_uuid);
+            peer.has_latency = false;
+            peer.latency_us = 0;
+
+            samoa::client::server::ptr_t server = \
+                peer_set->get_server(server_uuid);
+
+            if(server)
+            {
+                peer.has_latency = server->get_latency_quantile(
+                    hedge_quantile, peer.latency_us);
+            }
+            candidates.push_back(server_uuid);
+        }
+
+        if(candidates.empty())
+            return;
+
+        // the first peer is the less-loaded of two random peers, so
+        //  that reads don't herd onto the least-loaded; hedges follow
+        //  in order of load
+        core::uuid first = peer_set->select_server(candidates);
+
+        for(size_t i = 0; i != _peers.size(); ++i)
+        {
+            if(candidates[i] == first)
+            {
+                std::swap(_peers[0], _peers[i]);
+                break;
+            }
+        }
+
+        std::stable_sort(_peers.begin() + 1, _peers.end());
+    }
+
+    // sends to the next peer, returning its hedge delay
+    unsigned send_next()
+    {
+        const ranked_peer & peer = _peers[_next_peer++];
+
+        _rstate->get_peer_set()->schedule_request(
+            // wrap with request's io-service to synchronize callbacks
+            _rstate->get_io_service()->wrap(
+                boost::bind(&replication::on_peer_request,
+                    _1, _2, callback_t(boost::bind(&hedged_read::on_finish,
+                        shared_from_this())),
+                    _rstate, peer.peer_partition, false, shared_from_this())),
+            peer.peer_partition->get_server_uuid());
+
+        if(!peer.has_latency)
+            return max_hedge_delay_ms;
+
+        // round up to the millisecond timer resolution
+        return std::max(1u, std::min(max_hedge_delay_ms,
+            (peer.latency_us + 999) / 1000));
+    }
+
+    void schedule_hedge(unsigned delay_ms)
+    {
+        if(_next_peer == _peers.size())
+            return;
+
+        if(!_timer)
+        {
+            _timer = boost::make_shared<core::wheel_timer>(
+                _rstate->get_io_service());
+        }
+
+        // invoked from the request's io_service
+        _timer->schedule(boost::bind(&hedged_read::on_hedge_timeout,
+            shared_from_this()), delay_ms);
+    }
+
+    void on_hedge_timeout()
+    {
+        // peers may have been exhausted by failure hedges
+        if(_rstate->is_replication_finished() ||
+            _next_peer == _peers.size())
+        {
+            return;
+        }
+
+        __sync_fetch_and_add(&hedge_count, 1);
+        schedule_hedge(send_next());
+    }
+
+    void on_finish()
+    {
+        // release the timer's reference to this hedged_read
+        if(_timer)
+            _timer->cancel();
+
+        _callback();
+    }
+
+    const callback_t _callback;
+    const request::state::ptr_t _rstate;
+
+    std::vector<ranked_peer> _peers;
+    size_t _next_peer;
+
+    core::timer_ptr_t _timer;
+};
+
+bool replication::get_hedged_reads()
+{ return hedged_reads; }
+
+void replication::set_hedged_reads(bool hedged)
+{ hedged_reads = hedged; }
+
+double replication::get_hedge_quantile()
+{ return hedge_quantile; }
+
+void replication::set_hedge_quantile(double quantile)
+{
+    SAMOA_ASSERT(quantile >= 0 && quantile <= 1);
+    hedge_quantile = quantile;
+}
+
+unsigned replication::get_max_hedge_delay_ms()
+{ return max_hedge_delay_ms; }
+
+void replication::set_max_hedge_delay_ms(unsigned delay_ms)
+{ max_hedge_delay_ms = delay_ms; }
+
+unsigned replication::get_hedge_count()
+{ return __sync_fetch_and_add(&hedge_count, 0); }
+
 void replication::replicated_read(
     const replication::callback_t & callback,
     const request::state::ptr_t & rstate)
@@ -31,6 +254,12 @@ void replication::replicated_op(
     const request::state::ptr_t & rstate,
     bool write_request)
 {
+    if(!write_request && hedged_reads)
+    {
+        boost::make_shared<hedged_read>(callback, rstate)->start();
+        return;
+    }
+
     for(auto it = rstate->get_peer_partitions().begin();
             it != rstate->get_peer_partitions().end(); ++it)
     {
@@ -38,24 +267,37 @@ void replication::replicated_op(
             // wrap with request's io-service to synchronize callbacks
             rstate->get_io_service()->wrap(
                 boost::bind(&replication::on_peer_request,
-                    _1, _2, callback, rstate, *it, write_request)),
+                    _1, _2, callback, rstate, *it, write_request,
+                    hedged_read_ptr_t())),
             (*it)->get_server_uuid());
     }
 }
 
+bool replication::on_peer_failure(
+    const request::state::ptr_t & rstate,
+    const hedged_read_ptr_t & hedge)
+{
+    if(hedge)
+    {
+        hedge->on_peer_failure();
+    }
+    return rstate->peer_replication_failure();
+}
+
 void replication::on_peer_request(
     const boost::system::error_code & ec,
     samoa::client::server_request_interface iface,
     const replication::callback_t & callback,
     const request::state::ptr_t & rstate,
     const partition::ptr_t & peer_part,
-    bool write_request)
+    bool write_request,
+    const hedged_read_ptr_t & hedge)
 {
     if(ec)
     {
         LOG_WARN(ec.message());
 
-        if(rstate->peer_replication_failure())
+        if(on_peer_failure(rstate, hedge))
         {
             callback();
         }
@@ -69,10 +311,23 @@ void replication::on_peer_request(
         return;
     }
 
+    if(rstate->check_deadline())
+    {
+        // the requester has abandoned the request; count as a failure
+        iface.abort_request();
+
+        if(on_peer_failure(rstate, hedge))
+        {
+            callback();
+        }
+        return;
+    }
+
     spb::SamoaRequest & samoa_request = iface.get_message();
 
     samoa_request.set_type(spb::REPLICATE);
     samoa_request.set_key(rstate->get_key());
+    rstate->propagate_deadline(samoa_request);
 
     samoa_request.mutable_table_uuid()->assign(
         rstate->get_table_uuid().begin(),
@@ -104,7 +359,7 @@ void replication::on_peer_request(
     {
         core::zero_copy_output_adapter zco_adapter;
 
-        rstate->get_local_record().SerializeToZeroCopyStream(&zco_adapter);
+        zco_adapter.serialize(rstate->get_local_record());
         iface.add_data_block(zco_adapter.output_regions());
     }
 
@@ -112,7 +367,7 @@ void replication::on_peer_request(
         rstate->get_io_service()->wrap(
             // wrap with request's io-service to synchronize callbacks
             boost::bind(&replication::on_peer_response,
-                _1, _2, callback, rstate, write_request)));
+                _1, _2, callback, rstate, write_request, hedge)));
 }
 
 void replication::on_peer_response(
@@ -120,7 +375,8 @@ void replication::on_peer_response(
     samoa::client::server_response_interface iface,
     const replication::callback_t & callback,
     const request::state::ptr_t & rstate,
-    bool write_request)
+    bool write_request,
+    const hedged_read_ptr_t & hedge)
 {
     if(ec || iface.get_error_code())
     {
@@ -136,7 +392,7 @@ void replication::on_peer_response(
             iface.finish_response();
         }
 
-        if(rstate->peer_replication_failure())
+        if(on_peer_failure(rstate, hedge))
         {
             callback();
         }
@@ -151,11 +407,8 @@ void replication::on_peer_response(
         // parse into local-record (used here as scratch space)
         SAMOA_ASSERT(iface.get_response_data_blocks().size() == 1);
 
-        core::zero_copy_input_adapter zci_adapter(
-            iface.get_response_data_blocks()[0]);
-
-        SAMOA_ASSERT(rstate->get_local_record().ParseFromZeroCopyStream(
-            &zci_adapter));
+        SAMOA_ASSERT(core::parse_from_regions(rstate->get_local_record(),
+            iface.get_response_data_blocks()[0]));
 
         // merge local-record into remote-record
         rstate->get_table()->get_consistent_merge()(
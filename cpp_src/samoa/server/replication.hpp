@@ -33,8 +33,40 @@ public:
         const request::state_ptr_t &,
         const partition_ptr_t &); 
 
+    /*!
+     * Whether replicated reads are hedged (the default).
+     *
+     * A hedged read is first sent only to as many peers as are required
+     *  for quorum, preferring less-loaded peers (see
+     *  server_pool::select_server & get_server_load). If a
+     *  peer fails, or hasn't responded within its hedge delay (the
+     *  hedge-quantile of its recent latency, bounded by the max hedge
+     *  delay), the read is sent to one additional peer.
+     *
+     * Otherwise, reads are sent to all peers at once.
+     */
+    static bool get_hedged_reads();
+    static void set_hedged_reads(bool);
+
+    //! Quantile of peer latency used as the hedge delay (default 0.95)
+    static double get_hedge_quantile();
+    static void set_hedge_quantile(double);
+
+    /*!
+     * Upper bound of the hedge delay, which is also used for
+     *  peers without latency samples
+     */
+    static unsigned get_max_hedge_delay_ms();
+    static void set_max_hedge_delay_ms(unsigned);
+
+    //! Count of hedge requests sent, since startup
+    static unsigned get_hedge_count();
+
 private:
 
+    class hedged_read;
+    typedef boost::shared_ptr<hedged_read> hedged_read_ptr_t;
+
     static void replicated_op(
         const callback_t &,
         const request::state_ptr_t &,
@@ -46,14 +78,22 @@ private:
         const callback_t &,
         const request::state_ptr_t &,
         const partition_ptr_t &,
-        bool write_request);
+        bool write_request,
+        const hedged_read_ptr_t &);
 
     static void on_peer_response(
         const boost::system::error_code & ec,
         samoa::client::server_response_interface server,
         const callback_t &,
         const request::state_ptr_t &,
-        bool write_request);
+        bool write_request,
+        const hedged_read_ptr_t &);
+
+    // Notes a failed peer replication, and returns true iff the
+    //  replication completed as a result (see peer_replication_failure)
+    static bool on_peer_failure(
+        const request::state_ptr_t &,
+        const hedged_read_ptr_t &);
 };
 
 }
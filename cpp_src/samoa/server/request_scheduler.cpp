@@ -0,0 +1,265 @@
+
+#include "samoa/server/request_scheduler.hpp"
+#include "samoa/server/command_handler.hpp"
+#include "samoa/server/client.hpp"
+#include "samoa/request/request_state.hpp"
+#include "samoa/core/protobuf/samoa.pb.h"
+#include "samoa/error.hpp"
+#include "samoa/log.hpp"
+#include <boost/bind.hpp>
+
+#define DEFAULT_MAX_CONCURRENCY 256
+#define DEFAULT_RESERVED_CONCURRENCY 32
+
+namespace samoa {
+namespace server {
+
+namespace spb = samoa::core::protobuf;
+
+// default weight & queue depth of each priority class
+static const unsigned default_weights[] = {8, 4, 8, 4, 1};
+static const unsigned default_queue_depths[] = {1024, 1024, 1024, 1024, 64};
+
+request_scheduler::request_scheduler()
+ : _max_concurrency(DEFAULT_MAX_CONCURRENCY),
+   _reserved_concurrency(DEFAULT_RESERVED_CONCURRENCY),
+   _running_count(0)
+{
+    for(unsigned i = 0; i != CLASS_COUNT; ++i)
+    {
+        _classes[i].weight = default_weights[i];
+        _classes[i].max_queue_depth = default_queue_depths[i];
+        _classes[i].current_weight = 0;
+        _classes[i].shed_count = 0;
+    }
+}
+
+request_scheduler::priority_class request_scheduler::classify(
+    unsigned operation_type)
+{
+    switch(operation_type)
+    {
+    case spb::GET_BLOB:
+    case spb::MULTI_GET:
+        return CLIENT_READ;
+    case spb::SET_BLOB:
+    case spb::MULTI_SET:
+    case spb::CREATE_TABLE:
+    case spb::ALTER_TABLE:
+    case spb::DROP_TABLE:
+    case spb::CREATE_PARTITION:
+    case spb::DROP_PARTITION:
+        return CLIENT_WRITE;
+    case spb::REPLICATE:
+    case spb::REPLICATION_LOG:
+        return REPLICATION;
+    case spb::CLUSTER_STATE:
+    case spb::DIGEST:
+        return BACKGROUND;
+    default:
+        return UNSCHEDULED;
+    };
+}
+
+request_scheduler::priority_class request_scheduler::classify_request(
+    const spb::SamoaRequest & request)
+{
+    priority_class cls = classify(request.type());
+
+    if(request.forwarded() && (cls == CLIENT_READ || cls == CLIENT_WRITE))
+        return FORWARDED;
+
+    return cls;
+}
+
+void request_scheduler::set_max_concurrency(unsigned max_concurrency)
+{
+    {
+        adaptive_lock::guard guard(_lock);
+        _max_concurrency = max_concurrency;
+    }
+    // a raised limit may admit queued requests
+    dispatch();
+}
+
+void request_scheduler::set_reserved_concurrency(unsigned reserved)
+{
+    {
+        adaptive_lock::guard guard(_lock);
+        _reserved_concurrency = reserved;
+    }
+    dispatch();
+}
+
+unsigned request_scheduler::get_weight(priority_class cls) const
+{
+    adaptive_lock::guard guard(_lock);
+    return _classes[cls].weight;
+}
+
+void request_scheduler::set_weight(priority_class cls, unsigned weight)
+{
+    SAMOA_ASSERT(weight);
+
+    adaptive_lock::guard guard(_lock);
+    _classes[cls].weight = weight;
+}
+
+unsigned request_scheduler::get_max_queue_depth(priority_class cls) const
+{
+    adaptive_lock::guard guard(_lock);
+    return _classes[cls].max_queue_depth;
+}
+
+void request_scheduler::set_max_queue_depth(priority_class cls,
+    unsigned max_queue_depth)
+{
+    adaptive_lock::guard guard(_lock);
+    _classes[cls].max_queue_depth = max_queue_depth;
+}
+
+unsigned request_scheduler::get_running_count() const
+{
+    adaptive_lock::guard guard(_lock);
+    return _running_count;
+}
+
+unsigned request_scheduler::get_queued_count(priority_class cls) const
+{
+    adaptive_lock::guard guard(_lock);
+    return _classes[cls].queue.size();
+}
+
+unsigned request_scheduler::get_shed_count(priority_class cls) const
+{
+    adaptive_lock::guard guard(_lock);
+    return _classes[cls].shed_count;
+}
+
+void request_scheduler::schedule(const command_handler::ptr_t & handler,
+    const request::state::ptr_t & rstate)
+{
+    priority_class cls = classify_request(rstate->get_samoa_request());
+
+    if(cls == UNSCHEDULED)
+    {
+        handler->checked_handle(rstate);
+        return;
+    }
+
+    bool shed = false;
+    {
+        adaptive_lock::guard guard(_lock);
+        class_state & cstate = _classes[cls];
+
+        if(cstate.queue.empty() && admits(cls))
+        {
+            _running_count += 1;
+        }
+        else if(cstate.queue.size() < cstate.max_queue_depth)
+        {
+            cstate.queue.push_back(queued_t(handler, rstate));
+            return;
+        }
+        else
+        {
+            cstate.shed_count += 1;
+            shed = true;
+        }
+    }
+
+    if(shed)
+    {
+        // fail fast, rather than queueing without bound
+        LOG_DBG("shedding request of type "
+            << rstate->get_samoa_request().type());
+
+        rstate->send_error(503, "server overloaded; request shed");
+        return;
+    }
+    run(handler, rstate);
+}
+
+bool request_scheduler::admits(priority_class cls) const
+{
+    if(cls == REPLICATION || cls == BACKGROUND)
+        return _running_count < _max_concurrency;
+
+    if(cls == FORWARDED)
+        return _running_count + _reserved_concurrency / 2 < _max_concurrency;
+
+    return _running_count + _reserved_concurrency < _max_concurrency;
+}
+
+void request_scheduler::run(const command_handler::ptr_t & handler,
+    const request::state::ptr_t & rstate)
+{
+    // admission is released with the request::state
+    rstate->set_request_scheduler(shared_from_this());
+
+    handler->checked_handle(rstate);
+}
+
+void request_scheduler::release()
+{
+    {
+        adaptive_lock::guard guard(_lock);
+        _running_count -= 1;
+    }
+    dispatch();
+}
+
+bool request_scheduler::pop_next(queued_t & next)
+{
+    // smooth weighted round-robin over admissible, queued classes
+    int total_weight = 0;
+    class_state * best = 0;
+
+    for(unsigned i = 0; i != CLASS_COUNT; ++i)
+    {
+        class_state & cstate = _classes[i];
+
+        if(cstate.queue.empty() || !admits(priority_class(i)))
+            continue;
+
+        cstate.current_weight += cstate.weight;
+        total_weight += cstate.weight;
+
+        if(!best || cstate.current_weight > best->current_weight)
+            best = &cstate;
+    }
+
+    if(!best)
+        return false;
+
+    best->current_weight -= total_weight;
+
+    next = best->queue.front();
+    best->queue.pop_front();
+
+    _running_count += 1;
+    return true;
+}
+
+void request_scheduler::dispatch()
+{
+    while(true)
+    {
+        queued_t next;
+        {
+            adaptive_lock::guard guard(_lock);
+
+            if(!pop_next(next))
+                return;
+        }
+
+        // we may be called from any thread (as the releasing
+        //  request::state is reset); run from the client's io_service
+        next.second->get_client()->get_io_service()->post(
+            boost::bind(&request_scheduler::run, shared_from_this(),
+                next.first, next.second));
+    }
+}
+
+}
+}
@@ -0,0 +1,158 @@
+#ifndef SAMOA_SERVER_REQUEST_SCHEDULER_HPP
+#define SAMOA_SERVER_REQUEST_SCHEDULER_HPP
+
+#include "samoa/server/fwd.hpp"
+#include "samoa/request/fwd.hpp"
+#include "samoa/core/protobuf/fwd.hpp"
+#include "samoa/adaptive_lock.hpp"
+#include <boost/smart_ptr/enable_shared_from_this.hpp>
+#include <boost/noncopyable.hpp>
+#include <deque>
+
+namespace samoa {
+namespace server {
+
+/*!
+ * Admits requests to their command handlers by priority class.
+ *
+ * At most max_concurrency requests run at once (from handle() until
+ *  their request::state is released), which bounds outstanding work
+ *  queued to persisters and peers. Further requests wait in a queue of
+ *  their class, and as running requests complete, queued classes are
+ *  selected by smooth weighted round-robin. A request arriving to a full
+ *  class queue is shed immediately with a 503, rather than adding to
+ *  unbounded latency.
+ *
+ * Handlers of client classes may wait on requests to peer servers:
+ *  either forwarded client requests, or replication. Forwarded requests
+ *  may in turn wait on replication, while REPLICATION and BACKGROUND
+ *  handlers complete locally. Admission is tiered accordingly: client
+ *  classes can't use the reserved concurrency, FORWARDED requests may
+ *  use half of it, and REPLICATION and BACKGROUND may use all of it.
+ *  As each class waits only on classes having strictly more admission,
+ *  servers whose requests await one another can't deadlock.
+ *
+ * Requests which don't fall within a class (eg, PING) are never queued.
+ */
+class request_scheduler :
+    public boost::enable_shared_from_this<request_scheduler>,
+    private boost::noncopyable
+{
+public:
+
+    typedef request_scheduler_ptr_t ptr_t;
+
+    enum priority_class {
+        CLIENT_READ = 0,
+        CLIENT_WRITE = 1,
+        FORWARDED = 2, // client requests forwarded by a peer server
+        REPLICATION = 3,
+        BACKGROUND = 4, // discovery & anti-entropy
+        CLASS_COUNT = 5,
+
+        UNSCHEDULED = CLASS_COUNT
+    };
+
+    request_scheduler();
+
+    //! Priority class of a (core::protobuf::CommandType) operation type
+    static priority_class classify(unsigned operation_type);
+
+    /*!
+     * Priority class of a request: as classify(), except
+     *  that forwarded client requests are FORWARDED
+     */
+    static priority_class classify_request(
+        const core::protobuf::SamoaRequest &);
+
+    unsigned get_max_concurrency() const
+    { return _max_concurrency; }
+
+    void set_max_concurrency(unsigned);
+
+    /*!
+     * Concurrency unavailable to client classes. FORWARDED requests
+     *  may use half, and REPLICATION & BACKGROUND requests all of it.
+     */
+    unsigned get_reserved_concurrency() const
+    { return _reserved_concurrency; }
+
+    void set_reserved_concurrency(unsigned);
+
+    //! Relative share of admissions while classes are queued
+    unsigned get_weight(priority_class) const;
+    void set_weight(priority_class, unsigned);
+
+    //! Requests which may wait in the class queue before shedding
+    unsigned get_max_queue_depth(priority_class) const;
+    void set_max_queue_depth(priority_class, unsigned);
+
+    /*!
+     * Invokes handler with the request, if admitted; queues it; or
+     *  sheds it with a 503 error.
+     */
+    void schedule(const command_handler_ptr_t &, const request::state_ptr_t &);
+
+    //! Count of requests currently admitted to handlers
+    unsigned get_running_count() const;
+
+    unsigned get_queued_count(priority_class) const;
+
+    //! Count of requests shed by the class, since construction
+    unsigned get_shed_count(priority_class) const;
+
+private:
+
+    friend class request::client_state;
+
+    typedef std::pair<command_handler_ptr_t, request::state_ptr_t> queued_t;
+
+    struct class_state
+    {
+        unsigned weight;
+        unsigned max_queue_depth;
+
+        // smooth weighted round-robin credit
+        int current_weight;
+
+        unsigned shed_count;
+        std::deque<queued_t> queue;
+    };
+
+    // marks the request as running, and invokes its handler
+    void run(const command_handler_ptr_t &, const request::state_ptr_t &);
+
+    // Preconditions: _lock is held
+    bool admits(priority_class) const;
+
+    /*!
+     * Releases the admission of a completed request, and
+     *  admits the next queued request (if any).
+     */
+    void release();
+
+    /*!
+     * Selects the next admissible queued request, marking it running.
+     *  Returns false if no queued request may be admitted.
+     *
+     * Preconditions: _lock is held
+     */
+    bool pop_next(queued_t &);
+
+    //! Admits queued requests until the concurrency limit is reached
+    void dispatch();
+
+    mutable adaptive_lock _lock;
+
+    unsigned _max_concurrency;
+    unsigned _reserved_concurrency;
+    unsigned _running_count;
+
+    class_state _classes[CLASS_COUNT];
+};
+
+}
+}
+
+#endif
+
@@ -155,13 +155,25 @@ const datamodel::merge_func_t & table::get_consistent_merge() const
 { return _consistent_merge; }
 
 uint64_t table::ring_position(const std::string & key) const
+{
+    return key_ring_position(key);
+}
+
+uint64_t table::key_ring_position(const std::string & key)
 {
     return boost::hash<std::string>()(key);
 }
 
 void table::spawn_tasklets(const context::ptr_t & context)
 {
+    for(auto it = _ring.begin(); it != _ring.end(); ++it)
+    {
+        local_partition::ptr_t part = \
+            boost::dynamic_pointer_cast<local_partition>(*it);
 
+        if(part)
+            part->spawn_tasklets(context, get_uuid());
+    }
 }
 
 bool table::merge_table(
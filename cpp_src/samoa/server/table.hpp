@@ -58,6 +58,9 @@ public:
     /// The key's position on the hash-ring continuum
     uint64_t ring_position(const std::string & key) const;
 
+    /// The key's position on the hash-ring continuum of any table
+    static uint64_t key_ring_position(const std::string & key);
+
     //! Launches all tasklets required by the runtime table
     void spawn_tasklets(const context_ptr_t &);
 
@@ -1,3 +1 @@
-
-from _client import ServerPool
-
+from _client import ServerPool, ServerStats
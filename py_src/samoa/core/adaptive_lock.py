@@ -0,0 +1 @@
+from _core import adaptive_lock_stress
@@ -0,0 +1 @@
+from _core import Arena
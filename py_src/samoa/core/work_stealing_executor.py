@@ -0,0 +1,2 @@
+
+from _core import WorkStealingExecutor, Strand
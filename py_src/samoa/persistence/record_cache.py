@@ -0,0 +1 @@
+from _persistence import RecordCache
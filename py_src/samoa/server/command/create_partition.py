@@ -38,6 +38,13 @@ class CreatePartitionHandler(CommandHandler):
             ring_layer = part.add_ring_layer()
             ring_layer.CopyFrom(req_rlayer)
 
+        if req.has_replication_log_size():
+            part.set_replication_log_size(req.replication_log_size)
+        if req.has_replication_log_path():
+            part.set_replication_log_path(req.replication_log_path)
+        if req.has_record_cache_size():
+            part.set_record_cache_size(req.record_cache_size)
+
         self.log.info('created partition %s (table %s)' % (
             part.uuid, table_uuid))
 
@@ -0,0 +1 @@
+from _command import DigestHandler
@@ -2,6 +2,8 @@
 import getty
 import samoa.core.protobuf
 
+from samoa.core.proactor import Proactor
+
 import _server
 
 class Context(_server.Context):
@@ -10,5 +12,9 @@ class Context(_server.Context):
         cluster_state = samoa.core.protobuf.ClusterState)
     def __init__(self, cluster_state):
         _server.Context.__init__(self, cluster_state)
+
+        # persister operations run on concurrent executor workers,
+        #  of the proactor held by this context
+        Proactor.get_proactor().start_concurrent_executor()
         self.spawn_tasklets()
 
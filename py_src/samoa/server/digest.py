@@ -0,0 +1 @@
+from _server import Digest
@@ -11,6 +11,10 @@ import samoa.server.command.cluster_state
 import samoa.server.command.get_blob
 import samoa.server.command.set_blob
 import samoa.server.command.replicate
+import samoa.server.command.replication_log
+import samoa.server.command.digest
+import samoa.server.command.multi_get
+import samoa.server.command.multi_set
 
 import samoa.server.command as cmd
 from samoa.core.protobuf import CommandType
@@ -30,6 +34,10 @@ class Protocol(_server.Protocol):
         get_blob = cmd.get_blob.GetBlobHandler,
         set_blob = cmd.set_blob.SetBlobHandler,
         replicate = cmd.replicate.ReplicateHandler,
+        replication_log = cmd.replication_log.ReplicationLogHandler,
+        digest = cmd.digest.DigestHandler,
+        multi_get = cmd.multi_get.MultiGetHandler,
+        multi_set = cmd.multi_set.MultiSetHandler,
     )
     def __init__(self,
            ping,
@@ -41,7 +49,11 @@ class Protocol(_server.Protocol):
            cluster_state,
            get_blob,
            set_blob,
-           replicate):
+           replicate,
+           replication_log,
+           digest,
+           multi_get,
+           multi_set):
 
         _server.Protocol.__init__(self)
 
@@ -65,4 +77,12 @@ class Protocol(_server.Protocol):
             CommandType.SET_BLOB, set_blob)
         self.set_command_handler(
             CommandType.REPLICATE, replicate)
+        self.set_command_handler(
+            CommandType.REPLICATION_LOG, replication_log)
+        self.set_command_handler(
+            CommandType.DIGEST, digest)
+        self.set_command_handler(
+            CommandType.MULTI_GET, multi_get)
+        self.set_command_handler(
+            CommandType.MULTI_SET, multi_set)
 
@@ -0,0 +1,29 @@
+
+import unittest
+
+from samoa.core.adaptive_lock import adaptive_lock_stress
+
+class TestAdaptiveLock(unittest.TestCase):
+
+    def _check(self, thread_count, acquire_count, yield_interval):
+
+        count, overlaps = adaptive_lock_stress(
+            thread_count, acquire_count, yield_interval)
+
+        # holders were excluded, and no increment was lost
+        self.assertEquals(overlaps, 0)
+        self.assertEquals(count, thread_count * acquire_count)
+
+    def test_spinning_contention(self):
+        # short critical sections, which waiters acquire by spinning
+        self._check(8, 100000, 0)
+
+    def test_parking_contention(self):
+        # holders yield while holding the lock, so that
+        #  waiters exhaust their spin & park on the futex
+        self._check(8, 20000, 16)
+
+    def test_oversubscribed_contention(self):
+        # more threads than cores, so holders are preempted
+        self._check(64, 5000, 64)
+
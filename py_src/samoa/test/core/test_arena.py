@@ -0,0 +1,104 @@
+
+import unittest
+
+from samoa.core.arena import Arena
+from samoa.core.buffer_pool import BufferPool
+
+class TestArena(unittest.TestCase):
+
+    def test_aligned_allocation(self):
+
+        arena = Arena()
+
+        addresses = [arena.allocate(size) for size in [1, 17, 16, 33]]
+
+        for address in addresses:
+            self.assertEquals(address % Arena.alignment, 0)
+
+        # sizes are rounded up to the alignment
+        self.assertEquals([b - a for a, b in zip(addresses, addresses[1:])],
+            [16, 32, 16])
+
+    def test_spill_to_new_block(self):
+
+        arena = Arena()
+        count = Arena.inline_size / 16
+
+        # the inline block is used first
+        first = arena.allocate(16)
+        for i in xrange(count - 1):
+            arena.allocate(16)
+
+        self.assertEquals(arena.get_block_count(), 0)
+
+        # a further allocation spills to a block of buffer_pool
+        spilled = arena.allocate(16)
+        self.assertEquals(arena.get_block_count(), 1)
+        self.assertFalse(first <= spilled < first + Arena.inline_size)
+
+        # which serves subsequent allocations
+        self.assertEquals(arena.allocate(16), spilled + 16)
+        self.assertEquals(arena.get_block_count(), 1)
+
+    def test_large_allocation_spills_to_fitting_block(self):
+
+        arena = Arena()
+        arena.allocate(16)
+
+        # larger than both the inline block and smallest size class
+        size = 3 * BufferPool.class_size(0)
+        large = arena.allocate(size)
+        self.assertEquals(arena.get_block_count(), 1)
+
+        # the remainder of its block serves small allocations
+        self.assertEquals(arena.allocate(16), large + size)
+        self.assertEquals(arena.get_block_count(), 1)
+
+        # as does a further block, once it's exhausted
+        arena.allocate(BufferPool.class_size(2))
+        self.assertEquals(arena.get_block_count(), 2)
+
+    def test_deallocate_rolls_back_latest(self):
+
+        arena = Arena()
+
+        first = arena.allocate(64)
+        second = arena.allocate(64)
+
+        # deallocation other than of the latest is a no-op
+        arena.deallocate(first, 64)
+        third = arena.allocate(64)
+        self.assertEquals(third, second + 64)
+
+        # the latest allocation is rolled back, and re-used
+        arena.deallocate(third, 64)
+        self.assertEquals(arena.allocate(64), third)
+
+    def test_release_returns_blocks_to_pool(self):
+
+        arena = Arena()
+        first = arena.allocate(16)
+
+        def spill_blocks():
+            while arena.get_block_count() != 4:
+                arena.allocate(BufferPool.class_size(0))
+
+        spill_blocks()
+        arena.release()
+
+        # release resets to the inline block
+        self.assertEquals(arena.get_block_count(), 0)
+        self.assertEquals(arena.allocate(16), first)
+
+        # released blocks are re-drawn without calls to the heap
+        heap_count = BufferPool.heap_allocation_count()
+        spill_blocks()
+        self.assertEquals(BufferPool.heap_allocation_count(), heap_count)
+
+        # destruction also returns blocks to the pool
+        del arena
+
+        arena = Arena()
+        spill_blocks()
+        self.assertEquals(BufferPool.heap_allocation_count(), heap_count)
+
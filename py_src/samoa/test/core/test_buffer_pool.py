@@ -0,0 +1,93 @@
+
+import unittest
+
+from samoa.core.buffer_pool import BufferPool, PooledBlock
+
+class TestBufferPool(unittest.TestCase):
+
+    def test_size_classes(self):
+
+        self.assertEquals(BufferPool.size_class_of(1), 0)
+        self.assertEquals(BufferPool.size_class_of(4096), 0)
+        self.assertEquals(BufferPool.size_class_of(4097), 1)
+        self.assertEquals(BufferPool.size_class_of(1 << 20), 8)
+
+        self.assertEquals(BufferPool.size_class_of((1 << 20) + 1),
+            BufferPool.no_class)
+
+        for size_class in xrange(BufferPool.class_count):
+            self.assertEquals(BufferPool.size_class_of(
+                BufferPool.class_size(size_class)), size_class)
+
+    def test_reuse_within_each_size_class(self):
+
+        # draw a block of each class, ensuring each is cached once released
+        blocks = [PooledBlock(c, BufferPool.class_size(c))
+            for c in xrange(BufferPool.class_count)]
+
+        for block in blocks:
+            block.release()
+
+        heap_count = BufferPool.heap_allocation_count()
+        alloc_count = BufferPool.allocation_count()
+
+        # re-allocations of every class are served from released blocks
+        blocks = [PooledBlock(c, BufferPool.class_size(c))
+            for c in xrange(BufferPool.class_count)]
+
+        self.assertEquals(BufferPool.heap_allocation_count(), heap_count)
+        self.assertEquals(BufferPool.allocation_count(),
+            alloc_count + BufferPool.class_count)
+
+        # blocks of different classes are distinct
+        self.assertEquals(len(set(b.get_address() for b in blocks)),
+            BufferPool.class_count)
+
+        for block in blocks:
+            block.release()
+
+    def test_released_block_is_reused(self):
+
+        block = PooledBlock(2, 5000)
+        address = block.get_address()
+        block.release()
+
+        # thread caches are LIFO
+        block = PooledBlock(2, 5000)
+        self.assertEquals(block.get_address(), address)
+        block.release()
+
+    def test_unpooled_allocations_use_heap(self):
+
+        heap_count = BufferPool.heap_allocation_count()
+
+        for i in xrange(3):
+            block = PooledBlock(BufferPool.no_class, (1 << 20) + 1)
+            block.release()
+
+        self.assertEquals(BufferPool.heap_allocation_count(), heap_count + 3)
+
+    def test_thread_cache_spills_to_central_list(self):
+
+        # the thread cache holds two 1 MiB blocks; releasing
+        #  more spills the excess to the central reclaim list
+        size_class = BufferPool.class_count - 1
+        size = BufferPool.class_size(size_class)
+
+        blocks = [PooledBlock(size_class, size) for i in xrange(6)]
+        reclaimed = BufferPool.reclaimed_size()
+
+        for block in blocks:
+            block.release()
+
+        self.assertTrue(BufferPool.reclaimed_size() > reclaimed)
+
+        # blocks are then drawn back from the central list
+        heap_count = BufferPool.heap_allocation_count()
+        blocks = [PooledBlock(size_class, size) for i in xrange(6)]
+
+        self.assertEquals(BufferPool.heap_allocation_count(), heap_count)
+
+        for block in blocks:
+            block.release()
+
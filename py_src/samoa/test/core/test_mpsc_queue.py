@@ -0,0 +1,34 @@
+
+import unittest
+
+from samoa.core.mpsc_queue import mpsc_queue_stress
+
+class TestMpscQueue(unittest.TestCase):
+
+    def _check(self, producer_count, push_count):
+
+        popped = mpsc_queue_stress(producer_count, push_count)
+
+        # nothing is lost or duplicated
+        self.assertEquals(len(popped), producer_count * push_count)
+
+        # values of each producer are popped in the order pushed
+        next_sequence = [0] * producer_count
+
+        for producer, sequence in popped:
+            self.assertEquals(sequence, next_sequence[producer])
+            next_sequence[producer] += 1
+
+        self.assertEquals(next_sequence, [push_count] * producer_count)
+
+    def test_single_producer(self):
+        self._check(1, 100000)
+
+    def test_multiple_producers(self):
+        self._check(8, 50000)
+
+    def test_many_producers(self):
+        # more producers than cores, so pushes are preempted
+        #  between claiming & linking the queue head
+        self._check(64, 2000)
+
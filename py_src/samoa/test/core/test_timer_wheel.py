@@ -0,0 +1,131 @@
+
+import unittest
+import time
+
+from samoa.core.proactor import Proactor
+from samoa.core.timer_wheel import TimerWheel, WheelTimer
+
+# revolution of the wheel, in milliseconds (slot_count * tick_ms)
+REVOLUTION_MS = 4096
+
+class TestTimerWheel(unittest.TestCase):
+
+    def setUp(self):
+
+        self.proactor = Proactor.get_proactor()
+
+        # a wheel distinct from the proactor's, so that pending
+        #  counts don't include run_test() & sleep() timers
+        self.wheel = TimerWheel(self.proactor.serial_io_service())
+
+    def _elapsed_ms(self, start):
+        return (time.time() - start) * 1000
+
+    def test_timer_spanning_revolutions(self):
+
+        # both timers hash to the same slot; the later
+        #  must survive the earlier's expiry of that slot
+        short_timer = WheelTimer(self.wheel)
+        long_timer = WheelTimer(self.wheel)
+
+        fired = {}
+        start = time.time()
+
+        def on_fire(name):
+            fired[name] = self._elapsed_ms(start)
+
+        short_timer.schedule(lambda: on_fire('short'), 100)
+        long_timer.schedule(lambda: on_fire('long'), REVOLUTION_MS + 100)
+
+        self.assertEquals(self.wheel.get_pending_count(), 2)
+
+        def test():
+
+            while 'short' not in fired:
+                yield self.proactor.sleep(10)
+
+            self.assertTrue(fired['short'] >= 100)
+            self.assertTrue(long_timer.is_scheduled())
+            self.assertEquals(self.wheel.get_pending_count(), 1)
+
+            while 'long' not in fired:
+                yield self.proactor.sleep(100)
+
+            self.assertTrue(fired['long'] >= REVOLUTION_MS + 100)
+            self.assertFalse(long_timer.is_scheduled())
+            self.assertEquals(self.wheel.get_pending_count(), 0)
+            yield
+
+        self.proactor.run_test(test)
+
+    def test_cancel_before_fire(self):
+
+        timer = WheelTimer(self.wheel)
+        fired = []
+
+        timer.schedule(lambda: fired.append(True), 50)
+        self.assertTrue(timer.is_scheduled())
+
+        self.assertTrue(timer.cancel())
+        self.assertFalse(timer.is_scheduled())
+        self.assertEquals(self.wheel.get_pending_count(), 0)
+
+        # a second cancel finds nothing pending
+        self.assertFalse(timer.cancel())
+
+        def test():
+
+            yield self.proactor.sleep(150)
+            self.assertEquals(fired, [])
+            yield
+
+        self.proactor.run_test(test)
+
+    def test_reschedule_replaces_pending_callback(self):
+
+        timer = WheelTimer(self.wheel)
+        fired = []
+
+        timer.schedule(lambda: fired.append('first'), 20)
+        timer.schedule(lambda: fired.append('second'), 40)
+
+        self.assertEquals(self.wheel.get_pending_count(), 1)
+
+        def test():
+
+            yield self.proactor.sleep(150)
+            self.assertEquals(fired, ['second'])
+            yield
+
+        self.proactor.run_test(test)
+
+    def test_reschedule_from_callback(self):
+
+        timer = WheelTimer(self.wheel)
+        fired = []
+
+        def on_fire():
+            fired.append(timer.is_scheduled())
+
+            # the firing timer may be immediately re-used
+            if len(fired) != 5:
+                timer.schedule(on_fire, 10)
+                fired[-1] = timer.is_scheduled()
+
+        timer.schedule(on_fire, 10)
+
+        def test():
+
+            while len(fired) != 5:
+                yield self.proactor.sleep(10)
+
+            # re-scheduled each time but the last
+            self.assertEquals(fired, [True] * 4 + [False])
+
+            yield self.proactor.sleep(50)
+            self.assertEquals(len(fired), 5)
+            self.assertEquals(self.wheel.get_pending_count(), 0)
+            yield
+
+        self.proactor.run_test(test)
+
@@ -0,0 +1,124 @@
+
+import unittest
+import time
+
+from samoa.core.protobuf import PersistedRecord
+from samoa.core.proactor import Proactor
+from samoa.core.work_stealing_executor import Strand
+from samoa.persistence.persister import Persister
+from samoa.datamodel.merge_func import MergeResult
+
+class TestWorkStealingExecutor(unittest.TestCase):
+
+    def setUp(self):
+
+        # hold the proactor, which owns the executor, for the test
+        self.proactor = Proactor.get_proactor()
+        self.proactor.start_concurrent_executor(4)
+
+        self.executor = self.proactor.get_concurrent_executor()
+
+    def test_workers_started(self):
+
+        worker_count = self.executor.get_worker_count()
+
+        self.assertTrue(worker_count >= 4)
+        self.assertFalse(self.executor.running_in_this_thread())
+
+        # starting fewer workers than are running is a no-op
+        self.proactor.start_concurrent_executor(2)
+        self.assertEquals(self.executor.get_worker_count(), worker_count)
+
+    def test_executor_runs_on_workers(self):
+
+        results = []
+
+        def handler():
+            results.append(self.executor.running_in_this_thread())
+
+        for i in xrange(64):
+            self.executor.post(handler)
+
+        def test():
+            while len(results) != 64:
+                yield self.proactor.sleep(1)
+
+            self.assertTrue(all(results))
+            yield
+
+        self.proactor.run_test(test)
+
+    def test_strand_serializes_handlers(self):
+
+        strand = Strand(self.executor)
+
+        order = []
+        state = {'running': 0, 'overlapped': False, 'off_strand': False}
+
+        def handler(i):
+            state['running'] += 1
+            if state['running'] != 1:
+                state['overlapped'] = True
+
+            if not strand.running_in_this_thread() or \
+                not self.executor.running_in_this_thread():
+                state['off_strand'] = True
+
+            # releases the GIL, so that a concurrently
+            #  running handler would be observed
+            time.sleep(0.001)
+
+            order.append(i)
+            state['running'] -= 1
+
+        for i in xrange(32):
+            strand.post(lambda i = i: handler(i))
+
+        def test():
+            while len(order) != 32:
+                yield self.proactor.sleep(1)
+
+            self.assertFalse(state['overlapped'])
+            self.assertFalse(state['off_strand'])
+            self.assertEquals(order, range(32))
+            yield
+
+        self.proactor.run_test(test)
+
+    def test_persister_ops_run_on_workers(self):
+
+        persister = Persister()
+        persister.add_heap_hash(1<<14, 10)
+
+        merge_on_worker = []
+
+        def merge(local_record, remote_record):
+            # merges run within the persister's strand
+            merge_on_worker.append(self.executor.running_in_this_thread())
+
+            local_record.CopyFrom(remote_record)
+            return MergeResult(
+                local_was_updated = True,
+                remote_is_stale = False)
+
+        def test():
+
+            record = PersistedRecord()
+            record.add_blob_value('foo')
+
+            for value in ['bar', 'baz', 'bing']:
+                record.blob_value[0] = value
+                yield persister.put(merge, 'key', record)
+
+                # the completion re-enters this coroutine's io-service
+                self.assertFalse(self.executor.running_in_this_thread())
+
+            self.assertEquals('bing',
+                (yield persister.get('key')).blob_value[0])
+
+            # the first put inserted without a merge
+            self.assertEquals(merge_on_worker, [True, True])
+            yield
+
+        self.proactor.run_test(test)
+
@@ -21,8 +21,10 @@ class MuxTestHandler(CommandHandler):
 
     def handle(self, rstate):
 
-        # head is this request id, tail is previous requests to respond to
-        mux_ids = [int(i) for i in rstate.get_request_data_blocks()]
+        # head is this request id, tail is previous requests to respond
+        #  to. non-numeric blocks are padding
+        mux_ids = [int(i) for i in rstate.get_request_data_blocks()
+            if i.isdigit()]
 
         self.pending[mux_ids[0]] = rstate
 
@@ -49,12 +51,19 @@ class TestRequestMuxing(unittest.TestCase):
         self.futures = {}
         self.server = None
 
+        self.prior_max_request_bytes = Client.get_max_request_bytes()
+
+    def tearDown(self):
+
+        # restored regardless of the test's outcome
+        Client.set_max_request_bytes(self.prior_max_request_bytes)
+
     def _build_connection(self):
         self.server = yield Server.connect_to(
             self.listener.get_address(), self.listener.get_port())
         yield
 
-    def _make_request(self, mux_id, mux_ids_to_release):
+    def _make_request(self, mux_id, mux_ids_to_release, padding = 0):
 
         request = yield self.server.schedule_request()
         request.get_message().set_type(CommandType.TEST)
@@ -64,6 +73,9 @@ class TestRequestMuxing(unittest.TestCase):
             # ask server to respond to these previous requests
             request.add_data_block(str(m_id))
 
+        if padding:
+            request.add_data_block('x' * padding)
+
         self.futures[mux_id] = request.flush_request()
         yield
 
@@ -99,33 +111,30 @@ class TestRequestMuxing(unittest.TestCase):
             self.context.get_tasklet_group().cancel_group
         ])
 
-    def test_concurrency_limit(self):
+    def test_request_byte_budget(self):
 
-        # Client.max_request_concurrency requests, increasing id 
-        request_order = range(Client.max_request_concurrency)
-
-        # release in opposite order, except for 0
-        release_order = list(reversed(request_order[1:]))
+        # each padded request is charged at least 8 KiB; reads
+        #  pause once two requests are outstanding
+        padding = 8192
+        Client.set_max_request_bytes(2 * padding)
 
         def test():
 
             yield self._build_connection()
 
-            # Client.max_request_concurrency initial requests
-            for r_id in request_order:
-                yield self._make_request(r_id, [])
+            for r_id in [0, 1]:
+                yield self._make_request(r_id, [], padding)
 
-            # A request to release all previous requests, except 0
-            yield self._make_request(Client.max_request_concurrency,
-                release_order)
+            # A request to release request 1, which isn't read
+            #  until the budget admits it
+            yield self._make_request(2, [1], padding)
 
             yield
 
         def validate():
 
-            # Assert none of the requests were actually released
-            self.assertEquals(len(self.handler.pending),
-                Client.max_request_concurrency)
+            # Assert request 2 wasn't read
+            self.assertEquals(sorted(self.handler.pending.keys()), [0, 1])
 
             # manually release the first request
             self.handler.pending[0].flush_response()
@@ -134,8 +143,9 @@ class TestRequestMuxing(unittest.TestCase):
             # Assert request 0 was released
             yield self._validate_responses([0])
 
-            # Assert the remaining responses in release_order
-            yield self._validate_responses(release_order)
+            # Request 2 was then read, and released request 1
+            yield self._validate_responses([1])
+            self.assertEquals(self.handler.pending.keys(), [2])
 
             # cleanup
             self.context.get_tasklet_group().cancel_group()
@@ -143,3 +153,29 @@ class TestRequestMuxing(unittest.TestCase):
 
         Proactor.get_proactor().run_test([test, validate])
 
+    def test_small_requests_are_not_throttled(self):
+
+        # many more small requests than the previous fixed
+        #  concurrency limit (of 100) are admitted at once
+        request_order = range(250)
+        release_order = list(reversed(request_order))
+
+        def test():
+
+            yield self._build_connection()
+
+            for r_id in request_order:
+                yield self._make_request(r_id, [])
+
+            yield self._make_request(len(request_order), release_order)
+            yield
+
+        def validate():
+
+            yield self._validate_responses(release_order)
+
+            # cleanup
+            self.context.get_tasklet_group().cancel_group()
+            yield
+
+        Proactor.get_proactor().run_test([test, validate])
@@ -54,6 +54,40 @@ class TestPersister(unittest.TestCase):
 
         Proactor.get_proactor().run_test(test)
 
+    def test_large_value(self):
+
+        # values above core::streaming_copy_threshold are written
+        #  with non-temporal stores; use layers which can hold them
+        persister = Persister()
+        persister.add_heap_hash(1<<18, 10)
+        persister.add_heap_hash(1<<20, 100)
+
+        def test():
+
+            for length in (1<<14, (1<<15) + 3):
+
+                value = ''.join(chr(i % 251) for i in xrange(length))
+
+                expected = PersistedRecord()
+                expected.add_blob_value(value)
+
+                def merge(local_record, remote_record):
+                    local_record.CopyFrom(remote_record)
+
+                    return MergeResult(
+                        local_was_updated = True,
+                        remote_is_stale = False)
+
+                self.assertTrue(
+                    (yield persister.put(merge, 'foo', expected)))
+
+                self.assertEquals(value,
+                    (yield persister.get('foo')).blob_value[0])
+
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
     def test_churn(self):
 
         keys = [str(uuid.uuid4()) for i in xrange(300)]
@@ -0,0 +1,100 @@
+
+import unittest
+
+from samoa.core.protobuf import PersistedRecord
+from samoa.core.proactor import Proactor
+from samoa.persistence.persister import Persister
+from samoa.persistence.record_cache import RecordCache
+from samoa.datamodel.merge_func import MergeResult
+
+class TestRecordCache(unittest.TestCase):
+
+    def _record(self, value):
+        rec = PersistedRecord()
+        rec.add_blob_value(value)
+        return rec
+
+    def test_basic(self):
+
+        cache = RecordCache(1<<16)
+
+        self.assertEquals(cache.get('foo'), None)
+        self.assertEquals(cache.miss_count(), 1)
+
+        cache.insert('foo', self._record('bar'))
+        self.assertEquals(cache.get('foo').blob_value[0], 'bar')
+        self.assertEquals(cache.hit_count(), 1)
+        self.assertEquals(cache.entry_count(), 1)
+        self.assertTrue(cache.used_size())
+
+        # insertion replaces a previous entry
+        cache.insert('foo', self._record('baz'))
+        self.assertEquals(cache.get('foo').blob_value[0], 'baz')
+        self.assertEquals(cache.entry_count(), 1)
+
+        cache.invalidate('foo')
+        self.assertEquals(cache.get('foo'), None)
+        self.assertEquals(cache.entry_count(), 0)
+        self.assertEquals(cache.used_size(), 0)
+
+    def test_eviction(self):
+
+        cache = RecordCache(1<<16)
+
+        for i in xrange(1000):
+            cache.insert('key %d' % i, self._record('=' * 100))
+
+        # cache is bounded
+        self.assertTrue(cache.eviction_count())
+        self.assertTrue(cache.used_size() <= cache.total_size())
+        self.assertEquals(cache.entry_count() + cache.eviction_count(), 1000)
+
+        # records which are too large aren't cached
+        cache.insert('large', self._record('=' * (1<<14)))
+        self.assertEquals(cache.get('large'), None)
+
+    def test_persister_integration(self):
+
+        persister = Persister()
+        persister.add_heap_hash(1<<16, 1000)
+
+        cache = RecordCache(1<<16)
+        persister.set_record_cache(cache)
+
+        def merge(local_record, remote_record):
+            local_record.CopyFrom(remote_record)
+
+            return MergeResult(
+                local_was_updated = True,
+                remote_is_stale = False)
+
+        def test():
+
+            yield persister.put(merge, 'foo', self._record('bar'))
+
+            # first read misses, & populates the cache
+            self.assertEquals('bar',
+                (yield persister.get('foo')).blob_value[0])
+            self.assertEquals(cache.hit_count(), 0)
+
+            self.assertEquals('bar',
+                (yield persister.get('foo')).blob_value[0])
+            self.assertEquals(cache.hit_count(), 1)
+
+            # writes invalidate the cached record
+            yield persister.put(merge, 'foo', self._record('baz'))
+            self.assertEquals(cache.get('foo'), None)
+
+            self.assertEquals('baz',
+                (yield persister.get('foo')).blob_value[0])
+            self.assertEquals('baz',
+                (yield persister.get('foo')).blob_value[0])
+
+            # as do drops
+            yield persister.drop('foo')
+            self.assertEquals(cache.get('foo'), None)
+            self.assertEquals((yield persister.get('foo')), None)
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
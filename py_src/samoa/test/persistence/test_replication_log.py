@@ -0,0 +1,93 @@
+import unittest
+import uuid
+
+from samoa.core.protobuf import ClusterClock, ReplicationLogEntry
+from samoa.core.uuid import UUID
+from samoa.datamodel.clock_util import ClockUtil
+from samoa.persistence.replication_log import ReplicationLog
+
+class TestReplicationLog(unittest.TestCase):
+
+    def setUp(self):
+
+        self.clock = ClusterClock()
+        ClockUtil.tick(self.clock, UUID.from_random())
+
+    def test_basic(self):
+
+        log = ReplicationLog(1 << 16)
+        seq = log.end_sequence()
+
+        for key in ('foo', 'bar', 'baz'):
+            log.append(key, self.clock)
+
+        available, entries, next_seq = log.read(seq, 100)
+
+        self.assertTrue(available)
+        self.assertEquals(next_seq, seq + 3)
+        self.assertEquals(['foo', 'bar', 'baz'],
+            [self._parse(e).key for e in entries])
+
+        # bounded by max_entries
+        available, entries, next_seq = log.read(seq + 1, 1)
+
+        self.assertTrue(available)
+        self.assertEquals(next_seq, seq + 2)
+        self.assertEquals(['bar'], [self._parse(e).key for e in entries])
+
+        # caught up
+        self.assertEquals((True, [], seq + 3), log.read(seq + 3, 100))
+
+    def test_truncation(self):
+
+        log = ReplicationLog(1 << 12)
+        seq = log.end_sequence()
+
+        for i in xrange(1000):
+            log.append('key-%d' % i, self.clock)
+            self.assertTrue(log.used_region_size() <= (1 << 12))
+
+        # oldest entries were discarded to make room
+        self.assertTrue(log.begin_sequence() > seq)
+        self.assertEquals(log.end_sequence(), seq + 1000)
+
+        available, entries, next_seq = log.read(seq, 100)
+
+        self.assertFalse(available)
+        self.assertEquals(entries, [])
+        self.assertEquals(next_seq, log.end_sequence())
+
+        # retained entries remain readable
+        available, entries, next_seq = log.read(log.begin_sequence(), 10000)
+
+        self.assertTrue(available)
+        self.assertEquals(next_seq, log.end_sequence())
+        self.assertEquals(self._parse(entries[-1]).key, 'key-999')
+
+    def test_mapped(self):
+
+        path = '/tmp/%s' % uuid.uuid4()
+
+        log = ReplicationLog(path, 1 << 16)
+        seq = log.end_sequence()
+
+        log.append('foo', self.clock)
+        log.append('bar', self.clock)
+
+        del log
+
+        log = ReplicationLog(path, 1 << 16)
+
+        available, entries, next_seq = log.read(seq, 100)
+
+        self.assertTrue(available)
+        self.assertEquals(next_seq, seq + 2)
+        self.assertEquals(['foo', 'bar'],
+            [self._parse(e).key for e in entries])
+
+    def _parse(self, raw_entry):
+
+        entry = ReplicationLogEntry()
+        entry.ParseFromBytes(raw_entry)
+        return entry
+
@@ -144,6 +144,69 @@ class TestRollingHash(unittest.TestCase):
 
         self.assertEquals(keys, set())
 
+    def test_spill_head(self):
+        # Checks that runs of live head records are bulk-moved
+        #   into a second hash, stopping at dead records
+
+        src = HeapRollingHash(1 << 13, 100)
+        trg = HeapRollingHash(1 << 13, 100)
+
+        # 56 byte records (36 byte key, 10 byte value, 9 overhead, 1 padding)
+        keys = [str(uuid.uuid4()) for i in xrange(10)]
+        for key in keys:
+            self._set(src, key, key[:10])
+
+        # a pre-existing target record is superseded by the spill
+        self._set(trg, keys[0], 'stale')
+
+        # drop a record, breaking the run after 4 records
+        src.mark_for_deletion(keys[4])
+
+        # max_length bounds the run to 2 records
+        self.assertEquals(src.spill_head(trg, 112), 112)
+        self.assertEquals(src.spill_head(trg, 1 << 13), 112)
+
+        self.assertTrue(src.head().is_dead())
+        src.reclaim_head()
+
+        self.assertEquals(src.spill_head(trg, 1 << 13), 5 * 56)
+        self.assertEquals(src.head(), None)
+        self.assertEquals(src.live_record_count(), 0)
+        self.assertEquals(src.used_region_size(), 436)
+
+        self.assertEquals(trg.live_record_count(), 9)
+        self.assertEquals(trg.total_record_count(), 10)
+
+        for key in keys:
+            self.assertEquals(src.get(key), None)
+
+            if key != keys[4]:
+                self.assertEquals(trg.get(key).value, key[:10])
+
+    def test_spill_head_without_room(self):
+        # Checks that a spill into a target without room for the
+        #   head record makes no changes, even to an empty target
+
+        src = HeapRollingHash(1 << 13, 100)
+        trg = HeapRollingHash(1 << 10, 10)
+
+        self._set(src, 'large-key', '=' * 2000)
+
+        # empty the target, leaving its ring offset from the region start
+        self._set(trg, 'small-key', 'value')
+        trg.mark_for_deletion('small-key')
+        trg.reclaim_head()
+
+        trg_begin, trg_end = trg._dbg_begin(), trg._dbg_end()
+        self.assertEquals(trg_begin, trg_end)
+
+        self.assertEquals(src.spill_head(trg, 1 << 13), 0)
+
+        # neither ring was modified
+        self.assertEquals(trg._dbg_begin(), trg_begin)
+        self.assertEquals(trg._dbg_end(), trg_end)
+        self.assertEquals(src.get('large-key').value, '=' * 2000)
+
     def test_churn(self):
         # Synthesizes "normal" usage, with keys being both added & dropped
 
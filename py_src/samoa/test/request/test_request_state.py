@@ -60,3 +60,23 @@ class TestRequestState(unittest.TestCase):
         with self.assertRaisesRegexp(StateException, 'cluster-clock'):
             self.rstate.parse_samoa_request()
 
+    def test_acquired_states_are_recycled(self):
+
+        rstate = RequestState.acquire()
+        rstate.get_samoa_request().set_key('a-key')
+        rstate.get_samoa_request().set_requested_quorum(2)
+        rstate.parse_samoa_request()
+
+        pooled_count = RequestState.get_pooled_count()
+
+        # releasing the last reference resets & pools the state
+        del rstate
+        self.assertEquals(RequestState.get_pooled_count(), pooled_count + 1)
+
+        rstate = RequestState.acquire()
+        self.assertEquals(RequestState.get_pooled_count(), pooled_count)
+
+        self.assertFalse(rstate.get_samoa_request().has_key())
+        self.assertEquals(rstate.get_key(), '')
+        self.assertEquals(rstate.get_quorum_count(), 0)
+
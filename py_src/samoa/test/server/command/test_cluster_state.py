@@ -76,6 +76,16 @@ class TestClusterState(unittest.TestCase):
             self.assertEquals(result_table.uuid, test_table)
             self.assertEquals(len(result_table.partition), 2)
 
+            # the discovered peer carries our statistics of it
+            self.assertEquals(len(response_state.peer), 1)
+            self.assertTrue(response_state.peer[0].has_connected())
+            self.assertTrue(response_state.peer[0].has_queue_size())
+
+            # our own client measured the latency of its requests
+            self.assertTrue(server.get_latency_ewma() is not None)
+            self.assertTrue(server.get_latency_quantile(0.95) is not None)
+            self.assertEquals(server.get_queue_size(), 0)
+
             # cleanup
             context.get_tasklet_group().cancel_group()
             yield
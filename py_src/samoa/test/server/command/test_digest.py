@@ -0,0 +1,120 @@
+import unittest
+
+from samoa.core.protobuf import CommandType
+from samoa.core.uuid import UUID
+from samoa.core.proactor import Proactor
+from samoa.datamodel.data_type import DataType
+
+from samoa.test.peered_cluster import PeeredCluster
+from samoa.test.cluster_state_fixture import ClusterStateFixture
+
+
+class TestDigest(unittest.TestCase):
+
+    # mirrors server::digest::range_count
+    range_count = 1 << 14
+
+    def setUp(self):
+
+        common_fixture = ClusterStateFixture()
+        self.table_uuid = UUID(
+            common_fixture.add_table(
+                data_type = DataType.BLOB_TYPE).uuid)
+
+        self.cluster = PeeredCluster(common_fixture,
+            server_names = ['main', 'forwarder'])
+
+        self.partition_uuid = UUID(self.cluster.fixtures[
+            'main'].add_local_partition(self.table_uuid).uuid)
+
+        self.cluster.start_server_contexts()
+
+        self.keys = [common_fixture.generate_bytes() for i in xrange(3)]
+
+    def _digest(self, server_name, range_begin, range_count, digest):
+
+        request = yield self.cluster.schedule_request(server_name)
+
+        samoa_request = request.get_message()
+        samoa_request.set_type(CommandType.DIGEST)
+        samoa_request.set_table_uuid(self.table_uuid.to_bytes())
+        samoa_request.set_partition_uuid(self.partition_uuid.to_bytes())
+        samoa_request.mutable_digest().set_range_begin(range_begin)
+        samoa_request.mutable_digest().set_range_count(range_count)
+        samoa_request.mutable_digest().set_digest(digest)
+
+        response = yield request.flush_request()
+        yield response
+
+    def test_digest(self):
+
+        def test():
+
+            # write keys
+            for key in self.keys:
+
+                request = yield self.cluster.schedule_request('main')
+
+                samoa_request = request.get_message()
+                samoa_request.set_type(CommandType.SET_BLOB)
+                samoa_request.set_table_uuid(self.table_uuid.to_bytes())
+                samoa_request.set_key(key)
+                request.add_data_block('a-value')
+
+                response = yield request.flush_request()
+                self.assertFalse(response.get_error_code())
+                response.finish_response()
+
+            # a mismatched digest returns digests of each range
+            response = yield self._digest('main', 0, self.range_count, 0)
+            self.assertFalse(response.get_error_code())
+
+            samoa_response = response.get_message()
+            self.assertFalse(samoa_response.success)
+            self.assertEquals(len(samoa_response.range_digest),
+                self.range_count)
+
+            # written keys fall into between one and three ranges
+            nonzero = [d for d in samoa_response.range_digest if d]
+            self.assertTrue(1 <= len(nonzero) <= len(self.keys))
+
+            combined = reduce(lambda l, r: l ^ r, nonzero, 0)
+            self.assertNotEquals(combined, 0)
+            response.finish_response()
+
+            # a matched digest returns only success
+            response = yield self._digest('main',
+                0, self.range_count, combined)
+            self.assertFalse(response.get_error_code())
+
+            samoa_response = response.get_message()
+            self.assertTrue(samoa_response.success)
+            self.assertEquals(len(samoa_response.range_digest), 0)
+            response.finish_response()
+
+            # cleanup
+            self.cluster.stop_server_contexts()
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
+    def test_error_cases(self):
+
+        def test():
+
+            # partition isn't local
+            response = yield self._digest('forwarder', 0, 1, 0)
+            self.assertEquals(response.get_error_code(), 404)
+            response.finish_response()
+
+            # range out of bounds
+            response = yield self._digest('main', self.range_count, 1, 0)
+            self.assertEquals(response.get_error_code(), 400)
+            response.finish_response()
+
+            # cleanup
+            self.cluster.stop_server_contexts()
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
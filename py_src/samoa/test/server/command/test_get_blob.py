@@ -6,6 +6,8 @@ from samoa.core.protobuf import CommandType, PersistedRecord, ClusterClock
 from samoa.core.uuid import UUID
 from samoa.core.proactor import Proactor
 from samoa.server.listener import Listener
+from samoa.server.command_handler import CommandHandler
+from samoa.server.replication import Replication
 from samoa.client.server import Server
 from samoa.datamodel.data_type import DataType
 from samoa.datamodel.clock_util import ClockUtil, ClockAncestry
@@ -16,8 +18,51 @@ from samoa.test.peered_cluster import PeeredCluster
 from samoa.test.cluster_state_fixture import ClusterStateFixture
 
 
+class HoldReplicateHandler(CommandHandler):
+
+    def __init__(self):
+        self.pending = []
+        CommandHandler.__init__(self)
+
+    def handle(self, rstate):
+        self.pending.append(rstate)
+        yield
+
+class FailFirstReplicateHandler(CommandHandler):
+    """
+    Fails the first REPLICATE request received by any sharing
+    handler, and holds subsequent requests until released
+    """
+
+    def __init__(self, failed):
+        self.failed = failed
+        self.pending = []
+        CommandHandler.__init__(self)
+
+    def handle(self, rstate):
+        if not self.failed:
+            self.failed.append(rstate)
+            rstate.send_error(500, 'failed for test')
+        else:
+            self.pending.append(rstate)
+        yield
+
 class TestGetBlob(unittest.TestCase):
 
+    def setUp(self):
+        self.hedge_settings = (Replication.get_hedged_reads(),
+            Replication.get_hedge_quantile(),
+            Replication.get_max_hedge_delay_ms())
+
+    def tearDown(self):
+
+        # restored regardless of the test's outcome
+        hedged_reads, quantile, max_delay_ms = self.hedge_settings
+
+        Replication.set_hedged_reads(hedged_reads)
+        Replication.set_hedge_quantile(quantile)
+        Replication.set_max_hedge_delay_ms(max_delay_ms)
+
     def _build_fixture(self):
         """
         Builds a test-table with replication-factor 4, and five peers:
@@ -133,6 +178,196 @@ class TestGetBlob(unittest.TestCase):
     def test_quorum_read_forwarder(self):
         self._quorum_read_test('forwarder')
 
+    def test_hedged_quorum_read(self):
+        """
+        A quorum-read of two is sent first to one peer only, and hedged
+        to the other peer once the first hasn't responded within its
+        sampled latency. The hedged peer's response completes the read
+        """
+        common_fixture = ClusterStateFixture()
+        table_uuid = UUID(common_fixture.add_table(
+            data_type = DataType.BLOB_TYPE,
+            replication_factor = 3).uuid)
+
+        peer_names = ['peer_1', 'peer_2']
+
+        cluster = PeeredCluster(common_fixture,
+            server_names = ['main'] + peer_names)
+
+        for srv_name in ['main'] + peer_names:
+            cluster.fixtures[srv_name].add_local_partition(table_uuid)
+
+        cluster.start_server_contexts()
+
+        # peers hold REPLICATE requests until released
+        handlers = {}
+        for srv_name in peer_names:
+            handlers[srv_name] = HoldReplicateHandler()
+            cluster.listeners[srv_name].get_protocol().set_command_handler(
+                CommandType.REPLICATE, handlers[srv_name])
+
+        def held_count():
+            return sum(len(h.pending) for h in handlers.values())
+
+        def release_all():
+            for handler in handlers.values():
+                while handler.pending:
+                    handler.pending.pop(0).flush_response()
+
+        # hedge after the slowest sampled peer latency
+        Replication.set_hedge_quantile(1.0)
+        Replication.set_max_hedge_delay_ms(1000)
+
+        proactor = Proactor.get_proactor()
+
+        def begin_read(request, quorum):
+
+            samoa_request = request.get_message()
+            samoa_request.set_type(CommandType.GET_BLOB)
+            samoa_request.set_table_uuid(table_uuid.to_bytes())
+            samoa_request.set_key('a-key')
+            samoa_request.set_requested_quorum(quorum)
+
+            # returns a future of the response
+            return request.flush_request()
+
+        def test():
+
+            self.assertTrue(Replication.get_hedged_reads())
+
+            # a quorum of three reads from both peers; held responses
+            #  give main latency samples of at least 100ms
+            read = begin_read((yield cluster.schedule_request('main')), 3)
+
+            while held_count() != 2:
+                yield proactor.sleep(1)
+
+            yield proactor.sleep(100)
+            release_all()
+
+            response = yield read
+            self.assertFalse(response.get_error_code())
+            self.assertEquals(response.get_message().replication_success, 3)
+            response.finish_response()
+
+            hedge_count = Replication.get_hedge_count()
+
+            # a quorum of two is first sent to only one peer
+            read = begin_read((yield cluster.schedule_request('main')), 2)
+
+            while held_count() != 1:
+                yield proactor.sleep(1)
+
+            yield proactor.sleep(20)
+            self.assertEquals(held_count(), 1)
+            self.assertEquals(Replication.get_hedge_count(), hedge_count)
+
+            first_peer = [name for name in peer_names
+                if handlers[name].pending][0]
+
+            # the hedge is sent to the other peer
+            while held_count() != 2:
+                yield proactor.sleep(1)
+
+            self.assertEquals(Replication.get_hedge_count(), hedge_count + 1)
+
+            # the hedged peer's response completes the read
+            for name in peer_names:
+                if name != first_peer:
+                    handlers[name].pending.pop(0).flush_response()
+
+            response = yield read
+            self.assertFalse(response.get_error_code())
+            self.assertEquals(response.get_message().replication_success, 2)
+            response.finish_response()
+
+            # cleanup
+            release_all()
+            cluster.stop_server_contexts()
+            yield
+
+        proactor.run_test(test)
+
+    def test_failure_hedge_exhausts_peers(self):
+        """
+        A quorum-read of two is sent first to one peer, which fails.
+        The read is hedged to the remaining peer, exhausting the peers,
+        and the delay hedge is cancelled rather than firing
+        """
+        common_fixture = ClusterStateFixture()
+        table_uuid = UUID(common_fixture.add_table(
+            data_type = DataType.BLOB_TYPE,
+            replication_factor = 3).uuid)
+
+        peer_names = ['peer_1', 'peer_2']
+
+        cluster = PeeredCluster(common_fixture,
+            server_names = ['main'] + peer_names)
+
+        for srv_name in ['main'] + peer_names:
+            cluster.fixtures[srv_name].add_local_partition(table_uuid)
+
+        cluster.start_server_contexts()
+
+        # whichever peer is read first fails; the other holds
+        failed = []
+        handlers = {}
+        for srv_name in peer_names:
+            handlers[srv_name] = FailFirstReplicateHandler(failed)
+            cluster.listeners[srv_name].get_protocol().set_command_handler(
+                CommandType.REPLICATE, handlers[srv_name])
+
+        def held_count():
+            return sum(len(h.pending) for h in handlers.values())
+
+        # without latency samples, the delay hedge is at 20ms
+        Replication.set_max_hedge_delay_ms(20)
+
+        proactor = Proactor.get_proactor()
+
+        def test():
+
+            hedge_count = Replication.get_hedge_count()
+
+            request = yield cluster.schedule_request('main')
+
+            samoa_request = request.get_message()
+            samoa_request.set_type(CommandType.GET_BLOB)
+            samoa_request.set_table_uuid(table_uuid.to_bytes())
+            samoa_request.set_key('a-key')
+            samoa_request.set_requested_quorum(2)
+
+            read = request.flush_request()
+
+            # the failure is hedged to the last peer
+            while held_count() != 1:
+                yield proactor.sleep(1)
+
+            self.assertEquals(len(failed), 1)
+            self.assertEquals(Replication.get_hedge_count(), hedge_count + 1)
+
+            # the delay hedge has nothing further to send to
+            yield proactor.sleep(60)
+
+            self.assertEquals(held_count(), 1)
+            self.assertEquals(Replication.get_hedge_count(), hedge_count + 1)
+
+            for handler in handlers.values():
+                while handler.pending:
+                    handler.pending.pop(0).flush_response()
+
+            response = yield read
+            self.assertFalse(response.get_error_code())
+            self.assertEquals(response.get_message().replication_success, 2)
+            self.assertEquals(response.get_message().replication_failure, 1)
+            response.finish_response()
+
+            # cleanup
+            cluster.stop_server_contexts()
+            yield
+
+        proactor.run_test(test)
+
     def test_simple_read_A(self):
 
         self._build_fixture()
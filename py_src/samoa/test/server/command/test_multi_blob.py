@@ -0,0 +1,210 @@
+
+import unittest
+
+from samoa.core.protobuf import CommandType, PersistedRecord
+from samoa.core.uuid import UUID
+from samoa.core.proactor import Proactor
+from samoa.datamodel.data_type import DataType
+
+from samoa.test.peered_cluster import PeeredCluster
+from samoa.test.cluster_state_fixture import ClusterStateFixture
+
+
+class TestMultiBlob(unittest.TestCase):
+
+    def setUp(self):
+        """
+        Builds a test-table with replication-factor 2 and a
+        single partition, and two peers:
+
+        main: has a partition
+        forwarder: has no partition
+        """
+
+        common_fixture = ClusterStateFixture()
+        self.table_uuid = UUID(
+            common_fixture.add_table(
+                data_type = DataType.BLOB_TYPE,
+                replication_factor = 2).uuid)
+
+        self.cluster = PeeredCluster(common_fixture,
+            server_names = ['main', 'forwarder'])
+
+        self.partition_uuid = UUID(self.cluster.fixtures[
+            'main'].add_local_partition(self.table_uuid).uuid)
+
+        self.cluster.start_server_contexts()
+
+        self.main_hash = self.cluster.contexts['main'].get_cluster_state(
+            ).get_table_set(
+            ).get_table(self.table_uuid
+            ).get_partition(self.partition_uuid
+            ).get_persister(
+            ).get_layer(0)
+
+        self.keys = [common_fixture.generate_bytes() for i in range(3)]
+        self.values = [common_fixture.generate_bytes() for i in range(3)]
+        self.missing_key = common_fixture.generate_bytes()
+
+    def _make_set_request(self, server_name):
+
+        request = yield self.cluster.schedule_request(server_name)
+
+        samoa_request = request.get_message()
+        samoa_request.set_type(CommandType.MULTI_SET)
+        samoa_request.set_table_uuid(self.table_uuid.to_bytes())
+
+        for key, value in zip(self.keys, self.values):
+            samoa_request.add_multi_key(key)
+            request.add_data_block(value)
+
+        response = yield request.flush_request()
+        yield response
+
+    def _make_get_request(self, server_name):
+
+        request = yield self.cluster.schedule_request(server_name)
+
+        samoa_request = request.get_message()
+        samoa_request.set_type(CommandType.MULTI_GET)
+        samoa_request.set_table_uuid(self.table_uuid.to_bytes())
+
+        for key in [self.keys[0], self.missing_key] + self.keys[1:]:
+            samoa_request.add_multi_key(key)
+
+        response = yield request.flush_request()
+        yield response
+
+    def _set_then_get(self, set_server, get_server):
+
+        def test():
+
+            response = yield self._make_set_request(set_server)
+            samoa_response = response.get_message()
+            self.assertFalse(response.get_error_code())
+
+            self.assertEquals(len(samoa_response.key_result), 3)
+            for key_result in samoa_response.key_result:
+                self.assertTrue(key_result.success)
+                self.assertEquals(key_result.value_count, 0)
+
+            response.finish_response()
+
+            # values were written to main's partition
+            for key, value in zip(self.keys, self.values):
+                record = PersistedRecord()
+                record.ParseFromBytes(self.main_hash.get(key).value)
+                self.assertEquals(list(record.blob_value), [value])
+
+            response = yield self._make_get_request(get_server)
+            samoa_response = response.get_message()
+            self.assertFalse(response.get_error_code())
+
+            # results & values are returned in request key order
+            self.assertEquals([r.value_count for r in \
+                samoa_response.key_result], [1, 0, 1, 1])
+
+            self.assertEquals(response.get_response_data_blocks(),
+                self.values)
+
+            response.finish_response()
+
+            # cleanup
+            self.cluster.stop_server_contexts()
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
+    def test_direct_set_direct_get(self):
+        self._set_then_get('main', 'main')
+
+    def test_forwarded_set_direct_get(self):
+        self._set_then_get('forwarder', 'main')
+
+    def test_direct_set_forwarded_get(self):
+        self._set_then_get('main', 'forwarder')
+
+    def test_error_cases(self):
+
+        def test():
+
+            # missing keys
+            request = yield self.cluster.schedule_request('main')
+
+            samoa_request = request.get_message()
+            samoa_request.set_type(CommandType.MULTI_GET)
+            samoa_request.set_table_uuid(self.table_uuid.to_bytes())
+
+            response = yield request.flush_request()
+            self.assertEquals(response.get_error_code(), 400)
+            response.finish_response()
+
+            # MULTI_SET doesn't replicate synchronously, so can't
+            #  acknowledge a quorum larger than 1
+            request = yield self.cluster.schedule_request('main')
+
+            samoa_request = request.get_message()
+            samoa_request.set_type(CommandType.MULTI_SET)
+            samoa_request.set_table_uuid(self.table_uuid.to_bytes())
+            samoa_request.set_requested_quorum(2)
+            samoa_request.add_multi_key(self.keys[0])
+
+            request.add_data_block(self.values[0])
+
+            response = yield request.flush_request()
+            self.assertEquals(response.get_error_code(), 400)
+            response.finish_response()
+
+            # nor a quorum of 0, which is of all replicas
+            request = yield self.cluster.schedule_request('main')
+
+            samoa_request = request.get_message()
+            samoa_request.set_type(CommandType.MULTI_SET)
+            samoa_request.set_table_uuid(self.table_uuid.to_bytes())
+            samoa_request.set_requested_quorum(0)
+            samoa_request.add_multi_key(self.keys[0])
+
+            request.add_data_block(self.values[0])
+
+            response = yield request.flush_request()
+            self.assertEquals(response.get_error_code(), 400)
+            response.finish_response()
+
+            # nothing was written
+            self.assertFalse(self.main_hash.get(self.keys[0]))
+
+            # MULTI_GET reads only the primary partition
+            for quorum in [0, 2]:
+                request = yield self.cluster.schedule_request('main')
+
+                samoa_request = request.get_message()
+                samoa_request.set_type(CommandType.MULTI_GET)
+                samoa_request.set_table_uuid(self.table_uuid.to_bytes())
+                samoa_request.set_requested_quorum(quorum)
+                samoa_request.add_multi_key(self.keys[0])
+
+                response = yield request.flush_request()
+                self.assertEquals(response.get_error_code(), 400)
+                response.finish_response()
+
+            # fewer data blocks than keys
+            request = yield self.cluster.schedule_request('main')
+
+            samoa_request = request.get_message()
+            samoa_request.set_type(CommandType.MULTI_SET)
+            samoa_request.set_table_uuid(self.table_uuid.to_bytes())
+            samoa_request.add_multi_key(self.keys[0])
+            samoa_request.add_multi_key(self.keys[1])
+
+            request.add_data_block(self.values[0])
+
+            response = yield request.flush_request()
+            self.assertEquals(response.get_error_code(), 400)
+            response.finish_response()
+
+            # cleanup
+            self.cluster.stop_server_contexts()
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
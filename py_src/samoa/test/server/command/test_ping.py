@@ -1,8 +1,11 @@
 
+import errno
 import getty
+import socket
+import struct
 import unittest
 
-from samoa.core.protobuf import CommandType
+from samoa.core.protobuf import CommandType, SamoaRequest, SamoaResponse
 from samoa.core.proactor import Proactor
 from samoa.server.listener import Listener
 from samoa.client.server import Server
@@ -41,3 +44,106 @@ class TestPing(unittest.TestCase):
 
         Proactor.get_proactor().run_test(test)
 
+    def test_ping_extended_frame(self):
+
+        listener = self.injector.get_instance(Listener)
+        context = listener.get_context()
+
+        def test():
+
+            server = yield Server.connect_to(
+                listener.get_address(), listener.get_port())
+
+            self.assertEquals(server.get_peer_protocol_version(), 1)
+
+            # an initial request & response exchange protocol versions
+            request = yield server.schedule_request()
+            request.get_message().set_type(CommandType.PING)
+
+            response = yield request.flush_request()
+            self.assertFalse(response.get_error_code())
+            response.finish_response()
+
+            self.assertEquals(server.get_peer_protocol_version(), 2)
+
+            # request larger than a 16-bit length preamble permits
+            request = yield server.schedule_request()
+            request.get_message().set_type(CommandType.PING)
+            request.get_message().set_key('k' * (1 << 17))
+
+            response = yield request.flush_request()
+            self.assertFalse(response.get_error_code())
+            response.finish_response()
+
+            context.get_tasklet_group().cancel_group()
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
+    def test_ping_frame_of_marker_length(self):
+        """
+        A version 1 client may write a frame of exactly 0xffff bytes, which
+        is read as such rather than as the marker of an extended frame
+        """
+        listener = self.injector.get_instance(Listener)
+        context = listener.get_context()
+
+        # a request without protocol_version, as a version 1 client writes
+        request = SamoaRequest()
+        request.set_request_id(1)
+        request.set_type(CommandType.PING)
+
+        key_length = 0
+        while request.ByteSize() != 0xffff:
+            key_length += 0xffff - request.ByteSize()
+            request.set_key('k' * key_length)
+
+        proactor = Proactor.get_proactor()
+
+        def test():
+
+            sock = socket.create_connection(
+                (listener.get_address(), listener.get_port()))
+            sock.setblocking(False)
+
+            # write & read without blocking the proactor
+            out = struct.pack('!H', 0xffff) + request.SerializeToBytes()
+
+            while out:
+                try:
+                    out = out[sock.send(out):]
+                except socket.error, e:
+                    if e.errno != errno.EAGAIN:
+                        raise
+                    yield proactor.sleep(1)
+
+            def read(length):
+                buf = ''
+                while len(buf) != length:
+                    try:
+                        chunk = sock.recv(length - len(buf))
+                        self.assertTrue(chunk)
+                        buf += chunk
+                    except socket.error, e:
+                        if e.errno != errno.EAGAIN:
+                            raise
+                        yield proactor.sleep(1)
+                yield buf
+
+            length, = struct.unpack('!H', (yield read(2)))
+            self.assertTrue(length < 0xffff)
+
+            response = SamoaResponse()
+            self.assertTrue(response.ParseFromBytes((yield read(length))))
+
+            self.assertEquals(response.request_id, 1)
+            self.assertEquals(response.type, CommandType.PING)
+            self.assertFalse(response.has_error())
+            self.assertEquals(response.protocol_version, 2)
+
+            sock.close()
+            context.get_tasklet_group().cancel_group()
+            yield
+
+        proactor.run_test(test)
+
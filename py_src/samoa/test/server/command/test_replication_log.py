@@ -0,0 +1,114 @@
+import unittest
+
+from samoa.core.protobuf import CommandType, ReplicationLogEntry
+from samoa.core.uuid import UUID
+from samoa.core.proactor import Proactor
+from samoa.datamodel.data_type import DataType
+
+from samoa.test.peered_cluster import PeeredCluster
+from samoa.test.cluster_state_fixture import ClusterStateFixture
+
+
+class TestReplicationLog(unittest.TestCase):
+
+    def setUp(self):
+
+        common_fixture = ClusterStateFixture()
+        self.table_uuid = UUID(
+            common_fixture.add_table(
+                data_type = DataType.BLOB_TYPE).uuid)
+
+        self.cluster = PeeredCluster(common_fixture,
+            server_names = ['main', 'forwarder'])
+
+        self.partition_uuid = UUID(self.cluster.fixtures[
+            'main'].add_local_partition(self.table_uuid).uuid)
+
+        self.cluster.start_server_contexts()
+
+        self.keys = [common_fixture.generate_bytes() for i in xrange(3)]
+
+    def _read_log(self, server_name, partition_uuid, log_sequence):
+
+        request = yield self.cluster.schedule_request(server_name)
+
+        samoa_request = request.get_message()
+        samoa_request.set_type(CommandType.REPLICATION_LOG)
+        samoa_request.set_table_uuid(self.table_uuid.to_bytes())
+        samoa_request.set_partition_uuid(partition_uuid.to_bytes())
+        samoa_request.set_log_sequence(log_sequence)
+
+        response = yield request.flush_request()
+        yield response
+
+    def test_catch_up(self):
+
+        def test():
+
+            # an unknown sequence is reported as truncated,
+            #  with the current position of the log
+            response = yield self._read_log('main', self.partition_uuid, 0)
+            self.assertFalse(response.get_error_code())
+
+            samoa_response = response.get_message()
+            self.assertTrue(samoa_response.log_truncated)
+            self.assertEquals(len(samoa_response.data_block_length), 0)
+
+            log_sequence = samoa_response.log_sequence
+            response.finish_response()
+
+            # write keys
+            for key in self.keys:
+
+                request = yield self.cluster.schedule_request('main')
+
+                samoa_request = request.get_message()
+                samoa_request.set_type(CommandType.SET_BLOB)
+                samoa_request.set_table_uuid(self.table_uuid.to_bytes())
+                samoa_request.set_key(key)
+                request.add_data_block('a-value')
+
+                response = yield request.flush_request()
+                self.assertFalse(response.get_error_code())
+                response.finish_response()
+
+            # writes since log_sequence are returned, in order
+            response = yield self._read_log('main',
+                self.partition_uuid, log_sequence)
+            self.assertFalse(response.get_error_code())
+
+            samoa_response = response.get_message()
+            self.assertFalse(samoa_response.log_truncated)
+            self.assertEquals(samoa_response.log_sequence, log_sequence + 3)
+
+            keys = []
+            for raw_entry in response.get_response_data_blocks():
+                entry = ReplicationLogEntry()
+                entry.ParseFromBytes(raw_entry)
+                keys.append(entry.key)
+
+            self.assertEquals(keys, self.keys)
+            response.finish_response()
+
+            # cleanup
+            self.cluster.stop_server_contexts()
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
+    def test_error_cases(self):
+
+        def test():
+
+            # partition isn't local
+            response = yield self._read_log('forwarder',
+                self.partition_uuid, 0)
+            self.assertEquals(response.get_error_code(), 404)
+            response.finish_response()
+
+            # cleanup
+            self.cluster.stop_server_contexts()
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
@@ -147,6 +147,19 @@ class TestSetBlob(unittest.TestCase):
         ClockUtil.tick(clock, self.partition_uuid)
         self._simple_write_passes('forwarder', clock)
 
+    def test_direct_write_streamed_value(self):
+        self._build_simple_fixture()
+
+        # large enough to be streamed into the record as it's read
+        self.value = self.value * (1 + (1 << 18) // len(self.value))
+        self._simple_write_passes('main', None)
+
+    def test_forwarded_write_streamed_value(self):
+        self._build_simple_fixture()
+
+        self.value = self.value * (1 + (1 << 18) // len(self.value))
+        self._simple_write_passes('forwarder', None)
+
     def test_direct_write_empty_clock(self):
         self._build_simple_fixture()
 
@@ -1,14 +1,19 @@
 
 import unittest
+import uuid
 
 from samoa.core import protobuf as pb
 from samoa.core.uuid import UUID
+from samoa.core.proactor import Proactor
 from samoa.server.local_partition import LocalPartition
 from samoa.test.cluster_state_fixture import ClusterStateFixture
 
 
 class TestLocalPartition(unittest.TestCase):
 
+    # mirrors server::digest::range_count
+    range_count = 1 << 14
+
     def setUp(self):
 
         self.gen = ClusterStateFixture()
@@ -35,3 +40,54 @@ class TestLocalPartition(unittest.TestCase):
             part.merge_partition(tst_state,
                 pb.ClusterState_Table_Partition(self.state))
 
+    def test_digest_of_reopened_mapped_partition(self):
+
+        # as self.state, but with a mapped ring-layer
+        mapped_state = pb.ClusterState_Table_Partition(self.state)
+        mapped_state.clear_ring_layer()
+
+        ring_layer = mapped_state.add_ring_layer()
+        ring_layer.set_storage_size(self.state.ring_layer[0].storage_size)
+        ring_layer.set_index_size(self.state.ring_layer[0].index_size)
+        ring_layer.set_file_path('/tmp/%s' % uuid.uuid4())
+
+        records = []
+        for i in xrange(10):
+            record = pb.PersistedRecord()
+            record.add_blob_value(self.gen.generate_bytes())
+            records.append((self.gen.generate_bytes(), record))
+
+        def merge(local_record, remote_record):
+            # keys are distinct; should not be called
+            self.assertFalse(True)
+
+        def write(part):
+            for key, record in records:
+                yield part.get_persister().put(merge, key, record)
+
+        def digests(part):
+            return part.get_digest().get_range_digests(0, self.range_count)
+
+        def test():
+
+            # write records to the mapped partition
+            part = LocalPartition(mapped_state, 0, 0, None)
+            yield write(part)
+
+            expected = digests(part)
+            self.assertTrue(any(expected))
+            del part
+
+            # a fresh replica of the same records has the same digest
+            replica = LocalPartition(self.state, 0, 0, None)
+            yield write(replica)
+            self.assertEquals(digests(replica), expected)
+
+            # as does the reopened mapped partition, whose
+            #  records were persisted prior to its construction
+            reopened = LocalPartition(mapped_state, 0, 0, None)
+            self.assertEquals(digests(reopened), expected)
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
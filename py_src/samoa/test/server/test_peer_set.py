@@ -11,10 +11,23 @@ from samoa.server.table_set import TableSet
 from samoa.server.listener import Listener
 from samoa.server.command_handler import CommandHandler
 
+from samoa.datamodel.data_type import DataType
+
 from samoa.test.module import TestModule
+from samoa.test.peered_cluster import PeeredCluster
 from samoa.test.cluster_state_fixture import ClusterStateFixture
 
 
+class HoldHandler(CommandHandler):
+
+    def __init__(self):
+        self.pending = []
+        CommandHandler.__init__(self)
+
+    def handle(self, rstate):
+        self.pending.append(rstate)
+        yield
+
 class TestPeerSet(unittest.TestCase):
 
     def test_ctor_edge_cases(self):
@@ -212,3 +225,130 @@ class TestPeerSet(unittest.TestCase):
         self.assertEquals(out.SerializeToText(),
             out2.SerializeToText())
 
+    def test_forward_prefers_less_loaded_peer(self):
+
+        common_fixture = ClusterStateFixture()
+        table_uuid = UUID(common_fixture.add_table(
+            data_type = DataType.BLOB_TYPE,
+            replication_factor = 2).uuid)
+
+        cluster = PeeredCluster(common_fixture,
+            server_names = ['main', 'fast', 'slow'])
+
+        main_fixture = cluster.fixtures['main']
+        peer_uuids = {}
+
+        # main has no partition, and forwards to either of fast or slow
+        for name in ['fast', 'slow']:
+            peer_fixture = cluster.fixtures[name]
+            peer_uuids[name] = peer_fixture.server_uuid
+
+            part = peer_fixture.add_local_partition(table_uuid)
+
+            main_fixture.add_peer(uuid = peer_fixture.server_uuid,
+                port = peer_fixture.server_port)
+            main_fixture.add_remote_partition(table_uuid,
+                uuid = part.uuid, ring_position = part.ring_position,
+                server_uuid = peer_fixture.server_uuid)
+
+        # a peer which is never connected, referenced by another table
+        unconnected_uuid = UUID(main_fixture.add_peer().uuid)
+        main_fixture.add_remote_partition(
+            main_fixture.add_table(replication_factor = 1).uuid,
+            server_uuid = unconnected_uuid)
+
+        cluster.start_server_contexts()
+
+        handlers = {}
+        for name in ['fast', 'slow']:
+            handlers[name] = HoldHandler()
+            cluster.listeners[name].get_protocol().set_command_handler(
+                CommandType.GET_BLOB, handlers[name])
+
+        def peer_set():
+            # re-fetched, as discovery may rebuild main's peer_set
+            return cluster.contexts['main'].get_cluster_state(
+                ).get_peer_set()
+
+        proactor = Proactor.get_proactor()
+
+        def test():
+
+            # connect to, and sample latency of, each peer
+            for name in ['fast', 'slow']:
+                for i in xrange(8):
+                    request = yield peer_set().schedule_request(
+                        peer_uuids[name])
+                    request.get_message().set_type(CommandType.PING)
+
+                    response = yield request.flush_request()
+                    self.assertFalse(response.get_error_code())
+                    response.finish_response()
+
+            # deepen the queue of slow with held requests
+            held = []
+            for i in xrange(16):
+                request = yield peer_set().schedule_request(
+                    peer_uuids['slow'])
+                request.get_message().set_type(CommandType.GET_BLOB)
+                held.append(request.flush_request())
+
+            while len(handlers['slow'].pending) != 16:
+                yield proactor.sleep(1)
+
+            for name, queue_size in [('slow', 16), ('fast', 0)]:
+                self.assertEquals(peer_set().get_server_stats(
+                    peer_uuids[name]).queue_size, queue_size)
+
+            self.assertTrue(peer_set().get_server_load(peer_uuids['fast']) <
+                peer_set().get_server_load(peer_uuids['slow']))
+
+            # the less-loaded peer is selected from either order
+            for i in xrange(10):
+                self.assertEquals(peer_set().select_server(
+                    [peer_uuids['slow'], peer_uuids['fast']]),
+                    peer_uuids['fast'])
+
+            # an unconnected peer is never selected over a connected one
+            self.assertFalse(peer_set().get_server_stats(
+                unconnected_uuid).connected)
+
+            for i in xrange(10):
+                self.assertEquals(peer_set().select_server(
+                    [unconnected_uuid, peer_uuids['slow']]),
+                    peer_uuids['slow'])
+
+            # reads issued to main are forwarded to fast
+            for i in xrange(3):
+                request = yield cluster.schedule_request('main')
+
+                samoa_request = request.get_message()
+                samoa_request.set_type(CommandType.GET_BLOB)
+                samoa_request.set_table_uuid(table_uuid.to_bytes())
+                samoa_request.set_key('key-%d' % i)
+
+                read = request.flush_request()
+
+                while not handlers['fast'].pending:
+                    yield proactor.sleep(1)
+
+                handlers['fast'].pending.pop().flush_response()
+
+                response = yield read
+                self.assertFalse(response.get_error_code())
+                response.finish_response()
+
+            self.assertEquals(len(handlers['slow'].pending), 16)
+
+            # cleanup
+            while handlers['slow'].pending:
+                handlers['slow'].pending.pop().flush_response()
+
+            for future in held:
+                response = yield future
+                response.finish_response()
+
+            cluster.stop_server_contexts()
+            yield
+
+        proactor.run_test(test)
@@ -0,0 +1,306 @@
+
+import getty
+import unittest
+
+from samoa.core.protobuf import CommandType, SamoaRequest
+from samoa.core.uuid import UUID
+from samoa.core.proactor import Proactor
+from samoa.server.listener import Listener
+from samoa.server.command_handler import CommandHandler
+from samoa.server.request_scheduler import RequestScheduler, PriorityClass
+from samoa.client.server import Server
+from samoa.datamodel.data_type import DataType
+from samoa.request.request_state import RequestState
+
+from samoa.test.module import TestModule
+from samoa.test.peered_cluster import PeeredCluster
+from samoa.test.cluster_state_fixture import ClusterStateFixture
+
+
+class HoldHandler(CommandHandler):
+
+    def __init__(self):
+        self.pending = {}
+        CommandHandler.__init__(self)
+
+    def handle(self, rstate):
+        self.pending[int(rstate.get_request_data_blocks()[0])] = rstate
+        yield
+
+class TestRequestScheduler(unittest.TestCase):
+
+    def setUp(self):
+
+        self.injector = TestModule().configure(getty.Injector())
+
+        self.handler = HoldHandler()
+
+        self.listener = self.injector.get_instance(Listener)
+        self.listener.get_protocol().set_command_handler(
+            CommandType.GET_BLOB, self.handler)
+
+        self.scheduler = self.listener.get_protocol().get_request_scheduler()
+        self.context = self.listener.get_context()
+
+    def test_classify(self):
+
+        for cmd_type, cls in [
+                (CommandType.GET_BLOB, PriorityClass.CLIENT_READ),
+                (CommandType.MULTI_SET, PriorityClass.CLIENT_WRITE),
+                (CommandType.REPLICATE, PriorityClass.REPLICATION),
+                (CommandType.DIGEST, PriorityClass.BACKGROUND),
+                (CommandType.PING, PriorityClass.UNSCHEDULED)]:
+
+            self.assertEquals(RequestScheduler.classify(cmd_type), cls)
+
+        # forwarded client requests are classed separately
+        request = SamoaRequest()
+        request.set_type(CommandType.SET_BLOB)
+        self.assertEquals(RequestScheduler.classify_request(request),
+            PriorityClass.CLIENT_WRITE)
+
+        request.set_forwarded(True)
+        self.assertEquals(RequestScheduler.classify_request(request),
+            PriorityClass.FORWARDED)
+
+        request.set_type(CommandType.REPLICATE)
+        self.assertEquals(RequestScheduler.classify_request(request),
+            PriorityClass.REPLICATION)
+
+    def _make_request(self, server, r_id, futures, timeout_ms = None):
+
+        request = yield server.schedule_request()
+        request.get_message().set_type(CommandType.GET_BLOB)
+
+        if timeout_ms is not None:
+            request.get_message().set_timeout_ms(timeout_ms)
+
+        request.add_data_block(str(r_id))
+        futures.append(request.flush_request())
+        yield
+
+    def test_queue_and_shed(self):
+
+        # admit one client request at a time, and queue one more
+        self.scheduler.set_max_concurrency(2)
+        self.scheduler.set_reserved_concurrency(1)
+        self.scheduler.set_max_queue_depth(PriorityClass.CLIENT_READ, 1)
+
+        futures = []
+
+        def test():
+
+            server = yield Server.connect_to(
+                self.listener.get_address(), self.listener.get_port())
+
+            for r_id in range(3):
+                yield self._make_request(server, r_id, futures)
+
+            # the third request is shed
+            response = yield futures[2]
+            self.assertEquals(response.get_error_code(), 503)
+            response.finish_response()
+
+            self.assertEquals(
+                self.scheduler.get_shed_count(PriorityClass.CLIENT_READ), 1)
+            self.assertEquals(
+                self.scheduler.get_queued_count(PriorityClass.CLIENT_READ), 1)
+            self.assertEquals(self.handler.pending.keys(), [0])
+
+            # completing the first request admits the second
+            self.handler.pending.pop(0).flush_response()
+
+            response = yield futures[0]
+            self.assertFalse(response.get_error_code())
+            response.finish_response()
+
+            # ping is never queued
+            request = yield server.schedule_request()
+            request.get_message().set_type(CommandType.PING)
+            response = yield request.flush_request()
+            self.assertFalse(response.get_error_code())
+            response.finish_response()
+
+            self.assertEquals(self.handler.pending.keys(), [1])
+            self.handler.pending.pop(1).flush_response()
+
+            response = yield futures[1]
+            self.assertFalse(response.get_error_code())
+            response.finish_response()
+
+            # cleanup
+            self.context.get_tasklet_group().cancel_group()
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
+    def test_raised_limit_admits_queued(self):
+
+        # admit one client request at a time
+        self.scheduler.set_max_concurrency(2)
+        self.scheduler.set_reserved_concurrency(1)
+
+        futures = []
+
+        def test():
+
+            server = yield Server.connect_to(
+                self.listener.get_address(), self.listener.get_port())
+
+            for r_id in range(3):
+                yield self._make_request(server, r_id, futures)
+
+            while self.scheduler.get_queued_count(
+                    PriorityClass.CLIENT_READ) != 2:
+                yield Proactor.get_proactor().sleep(1)
+
+            self.assertEquals(self.handler.pending.keys(), [0])
+
+            # raising the limit admits a queued request,
+            #  without awaiting a completion
+            self.scheduler.set_max_concurrency(3)
+
+            while 1 not in self.handler.pending:
+                yield Proactor.get_proactor().sleep(1)
+
+            self.assertEquals(
+                self.scheduler.get_queued_count(PriorityClass.CLIENT_READ), 1)
+
+            # as does lowering the reservation
+            self.scheduler.set_reserved_concurrency(0)
+
+            while 2 not in self.handler.pending:
+                yield Proactor.get_proactor().sleep(1)
+
+            self.assertEquals(
+                self.scheduler.get_queued_count(PriorityClass.CLIENT_READ), 0)
+            self.assertEquals(self.scheduler.get_running_count(), 3)
+
+            for r_id in range(3):
+                self.handler.pending.pop(r_id).flush_response()
+
+                response = yield futures[r_id]
+                self.assertFalse(response.get_error_code())
+                response.finish_response()
+
+            # cleanup
+            self.context.get_tasklet_group().cancel_group()
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
+    def test_expired_while_queued(self):
+
+        # admit one client request at a time
+        self.scheduler.set_max_concurrency(2)
+        self.scheduler.set_reserved_concurrency(1)
+
+        futures = []
+
+        def test():
+
+            server = yield Server.connect_to(
+                self.listener.get_address(), self.listener.get_port())
+
+            expired_count = RequestState.get_expired_count()
+
+            yield self._make_request(server, 0, futures, timeout_ms = 10000)
+            yield self._make_request(server, 1, futures, timeout_ms = 5)
+
+            # the second request's deadline passes while it's queued
+            yield Proactor.get_proactor().sleep(20)
+            self.assertEquals(self.handler.pending.keys(), [0])
+
+            self.assertTrue(self.handler.pending[0].has_deadline())
+            self.assertFalse(self.handler.pending[0].is_expired())
+            self.handler.pending.pop(0).flush_response()
+
+            response = yield futures[0]
+            self.assertFalse(response.get_error_code())
+            response.finish_response()
+
+            # it's dropped upon admission, rather than handled
+            response = yield futures[1]
+            self.assertEquals(response.get_error_code(), 504)
+            response.finish_response()
+
+            self.assertFalse(self.handler.pending)
+            self.assertEquals(
+                RequestState.get_expired_count(), expired_count + 1)
+
+            # cleanup
+            self.context.get_tasklet_group().cancel_group()
+            yield
+
+        Proactor.get_proactor().run_test(test)
+
+    def test_forwarded_admitted_while_clients_saturated(self):
+
+        common_fixture = ClusterStateFixture()
+        table_uuid = UUID(common_fixture.add_table(
+            data_type = DataType.BLOB_TYPE).uuid)
+
+        cluster = PeeredCluster(common_fixture,
+            server_names = ['main', 'forwarder'])
+
+        cluster.fixtures['main'].add_local_partition(table_uuid)
+        cluster.start_server_contexts()
+
+        # main holds SET_BLOB requests, and admits two client requests
+        main_protocol = cluster.listeners['main'].get_protocol()
+        main_protocol.set_command_handler(CommandType.SET_BLOB, self.handler)
+
+        main_scheduler = main_protocol.get_request_scheduler()
+        main_scheduler.set_max_concurrency(4)
+        main_scheduler.set_reserved_concurrency(2)
+
+        futures = []
+
+        def test():
+
+            # saturate main's client slots
+            server = yield cluster.get_connection('main')
+
+            for r_id in range(3):
+                request = yield server.schedule_request()
+                request.get_message().set_type(CommandType.SET_BLOB)
+                request.add_data_block(str(r_id))
+                futures.append(request.flush_request())
+
+            # issue a read to forwarder, which forwards to main
+            request = yield cluster.schedule_request('forwarder')
+
+            samoa_request = request.get_message()
+            samoa_request.set_type(CommandType.GET_BLOB)
+            samoa_request.set_table_uuid(table_uuid.to_bytes())
+            samoa_request.set_key('a-key')
+
+            # the forwarded read is admitted while clients are queued
+            response = yield request.flush_request()
+            self.assertFalse(response.get_error_code())
+            response.finish_response()
+
+            self.assertEquals(sorted(self.handler.pending.keys()), [0, 1])
+            self.assertEquals(main_scheduler.get_queued_count(
+                PriorityClass.CLIENT_WRITE), 1)
+
+            # release held client requests
+            for r_id in range(3):
+
+                # wait for the queued request to be admitted
+                while r_id not in self.handler.pending:
+                    yield Proactor.get_proactor().sleep(1)
+
+                self.handler.pending.pop(r_id).flush_response()
+
+                response = yield futures[r_id]
+                self.assertFalse(response.get_error_code())
+                response.finish_response()
+
+            # cleanup
+            self.context.get_tasklet_group().cancel_group()
+            cluster.stop_server_contexts()
+            yield
+
+        Proactor.get_proactor().run_test(test)
+